@@ -36,6 +36,7 @@
 #include <stdlib.h>
 
 #include "oalsound.h"
+#include "softsound.h"
 
 #include "i_module.h"
 #include "cmdlib.h"
@@ -46,6 +47,7 @@
 #include "v_text.h"
 #include "c_cvars.h"
 #include "stats.h"
+#include "m_fixed.h"
 #include <zmusic.h>
 
 
@@ -268,6 +270,10 @@ void I_InitSound ()
 	{
 		GSnd = new NullSoundRenderer;
 	}
+	else if (stricmp(snd_backend, "software") == 0)
+	{
+		GSnd = new SoftSoundRenderer;
+	}
 	else
 	{
 		#ifndef NO_OPENAL
@@ -494,3 +500,86 @@ SoundHandle SoundRenderer::LoadSoundVoc(uint8_t *sfxdata, int length)
 	return retval;
 }
 
+//==========================================================================
+//
+// SoundRenderer :: LoadDecodedSound
+//
+//==========================================================================
+
+SoundHandle SoundRenderer::LoadDecodedSound(FDecodedSound &decoded)
+{
+	return LoadSoundRaw(decoded.Data.Data(), decoded.Data.Size(), decoded.SampleRate, decoded.Channels, decoded.Bits, decoded.LoopStart, decoded.LoopEnd);
+}
+
+//==========================================================================
+//
+// SoundRenderer :: DecodeSound
+//
+// This may run on a worker thread, so any messages must go through Printf,
+// which the caller can redirect with DeferredPrints.
+//
+//==========================================================================
+
+bool SoundRenderer::DecodeSound(const uint8_t *sfxdata, int length, FDecodedSound &decoded)
+{
+	ChannelConfig chans;
+	SampleType type;
+	int srate;
+	uint32_t loop_start = 0, loop_end = ~0u;
+	zmusic_bool startass = false, endass = false;
+
+	FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
+	auto decoder = CreateDecoder(sfxdata, length, true);
+	if (!decoder)
+		return false;
+
+	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
+	int channels = chans == ChannelConfig_Mono ? 1 : chans == ChannelConfig_Stereo ? 2 : 0;
+	int bits = type == SampleType_UInt8 ? 8 : type == SampleType_Int16 ? 16 : 0;
+
+	if (channels == 0 || bits == 0)
+	{
+		SoundDecoder_Close(decoder);
+		Printf("Unsupported audio format: %s, %s\n", GetChannelConfigName(chans),
+			GetSampleTypeName(type));
+		return false;
+	}
+
+	auto &data = decoded.Data;
+	unsigned total = 0;
+	unsigned got;
+
+	data.Resize(total + 32768);
+	while ((got = (unsigned)SoundDecoder_Read(decoder, (char*)&data[total], data.Size() - total)) > 0)
+	{
+		total += got;
+		data.Resize(total * 2);
+	}
+	data.Resize(total);
+	SoundDecoder_Close(decoder);
+	if (total == 0)
+	{
+		return false;
+	}
+
+	if (!startass) loop_start = Scale(loop_start, srate, 1000);
+	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
+	const uint32_t samples = total / (channels * bits / 8);
+	if (loop_start > samples) loop_start = 0;
+	if (loop_end > samples) loop_end = samples;
+
+	decoded.SampleRate = srate;
+	decoded.Channels = channels;
+	decoded.Bits = bits;
+	// A loop over the entire sound is the default and does not need any loop points.
+	if ((loop_start > 0 || loop_end < samples) && loop_end > loop_start)
+	{
+		decoded.LoopStart = loop_start;
+		decoded.LoopEnd = loop_end;
+	}
+	else
+	{
+		decoded.LoopStart = decoded.LoopEnd = -1;
+	}
+	return true;
+}
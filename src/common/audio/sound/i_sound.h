@@ -88,6 +88,17 @@ typedef bool (*SoundStreamCallback)(SoundStream *stream, void *buff, int len, vo
 struct SoundDecoder;
 class MIDIDevice;
 
+// A sound decoded to raw PCM data, ready to be passed to LoadDecodedSound.
+struct FDecodedSound
+{
+	TArray<uint8_t> Data;
+	int SampleRate = 0;
+	int Channels = 0;
+	int Bits = 0;
+	int LoopStart = -1;
+	int LoopEnd = -1;
+};
+
 class SoundRenderer
 {
 public:
@@ -100,6 +111,10 @@ public:
 	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length) = 0;
 	SoundHandle LoadSoundVoc(uint8_t *sfxdata, int length);
 	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1) = 0;
+	// Decodes a compressed sound without touching the sound device, so that this can be done on a worker thread.
+	virtual bool DecodeSound(const uint8_t *sfxdata, int length, FDecodedSound &decoded);
+	// Uploads the result of DecodeSound. Unlike LoadSoundRaw this quietly drops loop points the device cannot handle, as LoadSound always did.
+	virtual SoundHandle LoadDecodedSound(FDecodedSound &decoded);
 	virtual void UnloadSound (SoundHandle sfx) = 0;	// unloads a sound from memory
 	virtual unsigned int GetMSLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
 	virtual unsigned int GetSampleLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
@@ -983,6 +983,17 @@ float OpenALSoundRenderer::GetOutputRate()
 
 
 SoundHandle OpenALSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend)
+{
+	return CreateBuffer(sfxdata, length, frequency, channels, bits, loopstart, loopend, true);
+}
+
+SoundHandle OpenALSoundRenderer::LoadDecodedSound(FDecodedSound &decoded)
+{
+	// Decoded sounds carry the loop tags of the file. Not being able to use them is no reason to complain.
+	return CreateBuffer(decoded.Data.Data(), decoded.Data.Size(), decoded.SampleRate, decoded.Channels, decoded.Bits, decoded.LoopStart, decoded.LoopEnd, false);
+}
+
+SoundHandle OpenALSoundRenderer::CreateBuffer(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend, bool warnloops)
 {
 	SoundHandle retval = { NULL };
 
@@ -1039,7 +1050,7 @@ SoundHandle OpenALSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int
 		alBufferiv(buffer, AL_LOOP_POINTS_SOFT, loops);
 		getALError();
 	}
-	else if(loopstart > 0 || loopend > 0)
+	else if(warnloops && (loopstart > 0 || loopend > 0))
 	{
 		static bool warned = false;
 		if(!warned)
@@ -1053,85 +1064,13 @@ SoundHandle OpenALSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int
 
 SoundHandle OpenALSoundRenderer::LoadSound(uint8_t *sfxdata, int length)
 {
-	SoundHandle retval = { NULL };
-	ALenum format = AL_NONE;
-	ChannelConfig chans;
-	SampleType type;
-	int srate;
-	uint32_t loop_start = 0, loop_end = ~0u;
-	zmusic_bool startass = false, endass = false;
-
-	FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
-	auto decoder = CreateDecoder(sfxdata, length, true);
-	if (!decoder)
-		return retval;
-
-	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
-	int samplesize = 1;
-	if (chans == ChannelConfig_Mono)
-	{
-		if (type == SampleType_UInt8) format = AL_FORMAT_MONO8, samplesize = 1;
-		if (type == SampleType_Int16) format = AL_FORMAT_MONO16, samplesize = 2;
-	}
-	else if (chans == ChannelConfig_Stereo)
-	{
-		if (type == SampleType_UInt8) format = AL_FORMAT_STEREO8, samplesize = 2;
-		if (type == SampleType_Int16) format = AL_FORMAT_STEREO16, samplesize = 4;
-	}
-
-	if (format == AL_NONE)
-	{
-		SoundDecoder_Close(decoder);
-		Printf("Unsupported audio format: %s, %s\n", GetChannelConfigName(chans),
-			GetSampleTypeName(type));
-		return retval;
-	}
-
-	std::vector<uint8_t> data;
-	unsigned total = 0;
-	unsigned got;
-
-	data.resize(total + 32768);
-	while ((got = (unsigned)SoundDecoder_Read(decoder, (char*)&data[total], data.size() - total)) > 0)
-	{
-		total += got;
-		data.resize(total * 2);
-	}
-	data.resize(total);
-	if (total == 0)
+	FDecodedSound decoded;
+	if (!DecodeSound(sfxdata, length, decoded))
 	{
+		SoundHandle retval = { NULL };
 		return retval;
 	}
-	SoundDecoder_Close(decoder);
-
-	ALenum err;
-	ALuint buffer = 0;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, format, &data[0], (ALsizei)data.size(), srate);
-	if((err=getALError()) != AL_NO_ERROR)
-	{
-		Printf("Failed to buffer data: %s\n", alGetString(err));
-		alDeleteBuffers(1, &buffer);
-		getALError();
-		return retval;
-	}
-
-	if (!startass) loop_start = Scale(loop_start, srate, 1000);
-	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
-	const uint32_t samples = (uint32_t)data.size() / samplesize;
-	if (loop_start > samples) loop_start = 0;
-	if (loop_end > samples) loop_end = samples;
-
-	if ((loop_start > 0 || loop_end > 0) && loop_end > loop_start && AL.SOFT_loop_points)
-	{
-		ALint loops[2] = { static_cast<ALint>(loop_start), static_cast<ALint>(loop_end) };
-		DPrintf(DMSG_NOTIFY, "Setting loop points %d -> %d\n", loops[0], loops[1]);
-		alBufferiv(buffer, AL_LOOP_POINTS_SOFT, loops);
-		// no console messages here, please!
-	}
-
-	retval.data = MAKE_PTRID(buffer);
-	return retval;
+	return LoadDecodedSound(decoded);
 }
 
 void OpenALSoundRenderer::UnloadSound(SoundHandle sfx)
@@ -129,6 +129,7 @@ public:
 	virtual void SetMusicVolume(float volume);
 	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length);
 	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1);
+	virtual SoundHandle LoadDecodedSound(FDecodedSound &decoded);
 	virtual void UnloadSound(SoundHandle sfx);
 	virtual unsigned int GetMSLength(SoundHandle sfx);
 	virtual unsigned int GetSampleLength(SoundHandle sfx);
@@ -178,6 +179,8 @@ public:
 	virtual FString GatherStats();
 
 private:
+	SoundHandle CreateBuffer(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend, bool warnloops);
+
     struct {
         bool EXT_EFX;
         bool EXT_disconnect;
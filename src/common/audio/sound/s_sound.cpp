@@ -35,6 +35,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <atomic>
+#include <future>
 
 #include "templates.h"
 #include "s_soundinternal.h"
@@ -43,6 +45,8 @@
 #include "s_music.h"
 #include "m_random.h"
 #include "printf.h"
+#include "c_cvars.h"
+#include "workerpool.h"
 
 
 enum
@@ -52,6 +56,8 @@ enum
 static FRandom pr_soundpitch ("SoundPitch");
 SoundEngine* soundEngine;
 
+CVAR(Bool, snd_asyncload, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
 //==========================================================================
 //
 // S_Init
@@ -94,6 +100,7 @@ void SoundEngine::Shutdown ()
 	FSoundChan *chan, *next;
 
 	StopAllChannels();
+	DropAllSoundLoads();
 
 	for (chan = FreeChannels; chan != NULL; chan = next)
 	{
@@ -168,7 +175,8 @@ void SoundEngine::CacheSound (sfxinfo_t *sfx)
 		}
 		else
 		{
-			LoadSound(sfx);
+			if (snd_asyncload) QueueSoundLoad(sfx);
+			else LoadSound(sfx);
 			sfx->bUsed = true;
 		}
 	}
@@ -182,6 +190,7 @@ void SoundEngine::CacheSound (sfxinfo_t *sfx)
 
 void SoundEngine::UnloadSound (sfxinfo_t *sfx)
 {
+	DropSoundLoad(sfx);
 	if (sfx->data.isValid())
 	{
 		GSnd->UnloadSound(sfx->data);
@@ -480,13 +489,18 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 		return NULL;
 	}
 
-	// Make sure the sound is loaded.
-	sfx = LoadSound(sfx);
-
-	// The empty sound never plays.
-	if (sfx->lumpnum == sfx_empty)
+	// Make sure the sound is loaded. If it is still being decoded in the
+	// background, pretend to play it so that it can start once it is ready.
+	bool loading = IsSoundLoading(sfx);
+	if (!loading)
 	{
-		return NULL;
+		sfx = LoadSound(sfx);
+
+		// The empty sound never plays.
+		if (sfx->lumpnum == sfx_empty)
+		{
+			return NULL;
+		}
 	}
 
 	// Select priority.
@@ -543,7 +557,7 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 		pitch = DEFAULT_PITCH;
 	}
 
-	if (chanflags & CHANF_EVICTED)
+	if ((chanflags & CHANF_EVICTED) || loading)
 	{
 		chan = NULL;
 	}
@@ -569,7 +583,7 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 			chan = (FSoundChan*)GSnd->StartSound (sfx->data, float(volume), pitch, startflags, NULL, startTime);
 		}
 	}
-	if (chan == NULL && (chanflags & CHANF_LOOP))
+	if (chan == NULL && ((chanflags & CHANF_LOOP) || (loading && !(chanflags & CHANF_EVICTED))))
 	{
 		chan = (FSoundChan*)GetChannel(NULL);
 		GSnd->MarkStartTime(chan);
@@ -712,6 +726,9 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 {
 	if (GSnd->IsNull()) return sfx;
 
+	// Pick up the result of a pending background load.
+	FinishSoundLoad(sfx, true);
+
 	while (!sfx->data.isValid())
 	{
 		unsigned int i;
@@ -740,34 +757,7 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 		DPrintf(DMSG_NOTIFY, "Loading sound \"%s\" (%td)\n", sfx->name.GetChars(), sfx - &S_sfx[0]);
 
 		auto sfxdata = ReadSound(sfx->lumpnum);
-		int size = sfxdata.Size();
-		if (size > 8)
-		{
-			int32_t dmxlen = LittleLong(((int32_t *)sfxdata.Data())[1]);
-
-			// If the sound is voc, use the custom loader.
-			if (strncmp ((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
-			{
-				sfx->data = GSnd->LoadSoundVoc(sfxdata.Data(), size);
-			}
-			// If the sound is raw, just load it as such.
-			else if (sfx->bLoadRAW)
-			{
-				sfx->data = GSnd->LoadSoundRaw(sfxdata.Data(), size, sfx->RawRate, 1, 8, sfx->LoopStart);
-			}
-			// Otherwise, try the sound as DMX format.
-			else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
-			{
-				int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
-				if (frequency == 0) frequency = 11025;
-				sfx->data = GSnd->LoadSoundRaw(sfxdata.Data()+8, dmxlen, frequency, 1, 8, sfx->LoopStart);
-			}
-			// If that fails, let the sound system try and figure it out.
-			else
-			{
-				sfx->data = GSnd->LoadSound(sfxdata.Data(), size);
-			}
-		}
+		LoadSoundData(sfx, sfxdata);
 
 		if (!sfx->data.isValid())
 		{
@@ -782,6 +772,251 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 	return sfx;
 }
 
+//==========================================================================
+//
+// S_LoadSoundData
+//
+// Creates the sound's buffer from the lump's contents.
+//
+//==========================================================================
+
+// Voc, raw and DMX sounds only need their header parsed, everything else
+// has to go through the sound system's decoder.
+static bool NeedsDecoder(sfxinfo_t *sfx, const TArray<uint8_t> &sfxdata)
+{
+	int size = sfxdata.Size();
+	if (size <= 8 || sfx->bLoadRAW) return false;
+	if (strncmp((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0) return false;
+	int32_t dmxlen = LittleLong(((int32_t *)sfxdata.Data())[1]);
+	return !(sfxdata[0] == 3 && sfxdata[1] == 0 && dmxlen <= size - 8);
+}
+
+void SoundEngine::LoadSoundData(sfxinfo_t *sfx, TArray<uint8_t> &sfxdata)
+{
+	int size = sfxdata.Size();
+	if (size > 8)
+	{
+		int32_t dmxlen = LittleLong(((int32_t *)sfxdata.Data())[1]);
+
+		// If the sound is voc, use the custom loader.
+		if (strncmp ((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
+		{
+			sfx->data = GSnd->LoadSoundVoc(sfxdata.Data(), size);
+		}
+		// If the sound is raw, just load it as such.
+		else if (sfx->bLoadRAW)
+		{
+			sfx->data = GSnd->LoadSoundRaw(sfxdata.Data(), size, sfx->RawRate, 1, 8, sfx->LoopStart);
+		}
+		// Otherwise, try the sound as DMX format.
+		else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
+		{
+			int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
+			if (frequency == 0) frequency = 11025;
+			sfx->data = GSnd->LoadSoundRaw(sfxdata.Data()+8, dmxlen, frequency, 1, 8, sfx->LoopStart);
+		}
+		// If that fails, let the sound system try and figure it out.
+		else
+		{
+			sfx->data = GSnd->LoadSound(sfxdata.Data(), size);
+		}
+	}
+}
+
+//==========================================================================
+//
+// Background sound loading
+//
+// Precaching only reads the lumps on the main thread, because the file
+// system is not thread safe, and leaves the expensive decoding of
+// compressed sounds to a worker. A sound that gets started before its
+// decoder finished is played as an evicted channel and gets restarted
+// as soon as its data is ready.
+//
+//==========================================================================
+
+extern thread_local TArray<std::pair<int, FString>> *DeferredPrints;
+
+struct FSoundLoadJob
+{
+	enum
+	{
+		Queued,
+		Running,
+		Done
+	};
+
+	SoundRenderer *Renderer;
+	TArray<uint8_t> LumpData;
+	FDecodedSound Decoded;
+	TArray<std::pair<int, FString>> Messages;	// printed by the main thread when the sound gets uploaded
+	bool Success = false;
+	std::atomic<int> State{ Queued };
+	std::promise<void> Finished;	// only set when a worker ran the job
+	std::future<void> FinishedFuture = Finished.get_future();
+
+	// Whoever gets to switch the state to Running does the work.
+	bool Claim()
+	{
+		int expected = Queued;
+		return State.compare_exchange_strong(expected, Running);
+	}
+
+	void Decode()
+	{
+		DeferredPrints = &Messages;
+		Success = Renderer->DecodeSound(LumpData.Data(), LumpData.Size(), Decoded);
+		DeferredPrints = nullptr;
+		LumpData.Reset();
+		State = Done;
+	}
+};
+
+void SoundEngine::QueueSoundLoad(sfxinfo_t *sfx)
+{
+	if (GSnd->IsNull() || sfx->data.isValid() || sfx->lumpnum == sfx_empty || LoadJobs.CheckKey(int(sfx - &S_sfx[0])))
+	{
+		return;
+	}
+
+	// Sounds that share their lump with a loaded one only need to be linked.
+	for (auto &other : S_sfx)
+	{
+		if (other.data.isValid() && other.link == sfxinfo_t::NO_LINK && other.lumpnum == sfx->lumpnum)
+		{
+			LoadSound(sfx);
+			return;
+		}
+	}
+
+	DPrintf(DMSG_NOTIFY, "Loading sound \"%s\" (%td) in the background\n", sfx->name.GetChars(), sfx - &S_sfx[0]);
+
+	auto sfxdata = ReadSound(sfx->lumpnum);
+	if (!NeedsDecoder(sfx, sfxdata))
+	{
+		LoadSoundData(sfx, sfxdata);
+		if (!sfx->data.isValid()) LoadSound(sfx);
+		return;
+	}
+
+	auto job = std::make_shared<FSoundLoadJob>();
+	job->Renderer = GSnd;
+	job->LumpData = std::move(sfxdata);
+	LoadJobs.Insert(int(sfx - &S_sfx[0]), job);
+	FWorkerPool::Push([job]()
+	{
+		if (job->Claim())
+		{
+			job->Decode();
+			job->Finished.set_value();
+		}
+	});
+}
+
+//==========================================================================
+//
+// Returns true if the sound is currently being decoded by a worker.
+//
+//==========================================================================
+
+bool SoundEngine::IsSoundLoading(sfxinfo_t *sfx)
+{
+	auto job = LoadJobs.CheckKey(int(sfx - &S_sfx[0]));
+	return job != nullptr && (*job)->State == FSoundLoadJob::Running;
+}
+
+//==========================================================================
+//
+// Uploads a finished background load to the sound system. If the job has
+// not been started yet it is done right here, if a worker is still busy
+// with it, it is only waited for if 'wait' is set.
+//
+// Returns false if the job is still pending.
+//
+//==========================================================================
+
+bool SoundEngine::FinishSoundLoad(sfxinfo_t *sfx, bool wait)
+{
+	int index = int(sfx - &S_sfx[0]);
+	auto pjob = LoadJobs.CheckKey(index);
+	if (pjob == nullptr) return true;
+
+	auto job = *pjob;
+	if (job->State != FSoundLoadJob::Done)
+	{
+		if (!wait) return false;
+		if (job->Claim()) job->Decode();
+		else job->FinishedFuture.wait();
+	}
+	LoadJobs.Remove(index);
+
+	if (job->Success && !sfx->data.isValid())
+	{
+		for (auto &msg : job->Messages)
+		{
+			PrintString(msg.first, msg.second.GetChars());
+		}
+		sfx->data = GSnd->LoadDecodedSound(job->Decoded);
+	}
+	// If decoding failed, LoadSound retries synchronously and prints the errors itself.
+	return true;
+}
+
+void SoundEngine::FinishLoadedSounds()
+{
+	if (LoadJobs.CountUsed() == 0) return;
+
+	TArray<int> done;
+	decltype(LoadJobs)::Iterator it(LoadJobs);
+	decltype(LoadJobs)::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		if (pair->Value->State == FSoundLoadJob::Done) done.Push(pair->Key);
+	}
+	for (auto index : done)
+	{
+		LoadSound(&S_sfx[index]);
+	}
+}
+
+//==========================================================================
+//
+// Discards background loads without uploading their results.
+//
+//==========================================================================
+
+void SoundEngine::DropSoundLoad(sfxinfo_t *sfx)
+{
+	int index = int(sfx - &S_sfx[0]);
+	auto pjob = LoadJobs.CheckKey(index);
+	if (pjob == nullptr) return;
+
+	// Jobs that haven't been started yet are cancelled by claiming them.
+	auto job = *pjob;
+	if (!job->Claim() && job->State != FSoundLoadJob::Done)
+	{
+		job->FinishedFuture.wait();
+	}
+	LoadJobs.Remove(index);
+}
+
+void SoundEngine::DropAllSoundLoads()
+{
+	if (LoadJobs.CountUsed() == 0) return;
+
+	decltype(LoadJobs)::Iterator it(LoadJobs);
+	decltype(LoadJobs)::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		auto &job = pair->Value;
+		if (!job->Claim() && job->State != FSoundLoadJob::Done)
+		{
+			job->FinishedFuture.wait();
+		}
+	}
+	LoadJobs.Clear();
+}
+
 //==========================================================================
 //
 // S_CheckSingular
@@ -1208,6 +1443,11 @@ void SoundEngine::RestoreEvictedChannel(FSoundChan *chan)
 	RestoreEvictedChannel(chan->NextChan);
 	if (chan->ChanFlags & CHANF_EVICTED)
 	{
+		// Don't give up on sounds that are still being decoded.
+		if (IsSoundLoading(&S_sfx[chan->SoundID]))
+		{
+			return;
+		}
 		RestartChannel(chan);
 		if (!(chan->ChanFlags & CHANF_LOOP))
 		{
@@ -1269,6 +1509,7 @@ void SoundEngine::UpdateSounds(int time)
 
 	GSnd->UpdateListener(&listener);
 	GSnd->UpdateSounds();
+	FinishLoadedSounds();
 
 	if (time >= RestartEvictionsAt)
 	{
@@ -1430,6 +1671,7 @@ void SoundEngine::StopChannel(FSoundChan *chan)
 
 void SoundEngine::UnloadAllSounds()
 {
+	DropAllSoundLoads();
 	for (unsigned i = 0; i < S_sfx.Size(); i++)
 	{
 		UnloadSound(&S_sfx[i]);
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <memory>
 #include "i_sound.h"
 
+struct FSoundLoadJob;
+
 struct FRandomSoundList
 {
 	TArray<uint32_t> Choices;
@@ -214,6 +217,7 @@ protected:
 	TMap<int, int> ResIdMap;
 	TArray<FRandomSoundList> S_rnd;
 	bool blockNewSounds = false;
+	TMap<int, std::shared_ptr<FSoundLoadJob>> LoadJobs;	// sounds being decoded in the background
 
 private:
 	void LinkChannel(FSoundChan* chan, FSoundChan** head);
@@ -233,6 +237,15 @@ private:
 	// Checks if a copy of this sound is already playing.
 	bool CheckSingular(int sound_id);
 	virtual TArray<uint8_t> ReadSound(int lumpnum) = 0;
+
+	// Asynchronous loading.
+	void LoadSoundData(sfxinfo_t* sfx, TArray<uint8_t>& sfxdata);
+	void QueueSoundLoad(sfxinfo_t* sfx);
+	bool FinishSoundLoad(sfxinfo_t* sfx, bool wait);
+	bool IsSoundLoading(sfxinfo_t* sfx);
+	void DropSoundLoad(sfxinfo_t* sfx);
+	void FinishLoadedSounds();
+	void DropAllSoundLoads();
 protected:
 	virtual bool CheckSoundLimit(sfxinfo_t* sfx, const FVector3& pos, int near_limit, float limit_range, int sourcetype, const void* actor, int channel, float attenuation);
 	virtual FSoundID ResolveSound(const void *ent, int srctype, FSoundID soundid, float &attenuation);
@@ -0,0 +1,1073 @@
+/*
+** softsound.cpp
+** System interface for sound; mixes on the CPU and writes to a WAV file
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The "software" sound backend does all mixing itself: distance
+** attenuation, equal power panning and linear interpolation resampling.
+** It has no channel limit, voices too quiet to be heard only advance
+** their position. Since there is no portable audio device layer besides
+** OpenAL, the result is written to the WAV file given by snd_wavfile, or
+** discarded if there is none, which allows running and benchmarking the
+** sound code on machines without a sound device.
+**
+*/
+
+#include <math.h>
+#include <chrono>
+
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "templates.h"
+#include "softsound.h"
+#include "v_text.h"
+#include "files.h"
+#include "m_swap.h"
+#include "m_random.h"
+#include "printf.h"
+
+#ifndef NO_SSE
+#include <emmintrin.h>
+#endif
+
+EXTERN_CVAR(Bool, snd_pitched)
+EXTERN_CVAR(Int, snd_samplerate)
+CVAR(String, snd_wavfile, "", CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+#define AREA_SOUND_RADIUS  (32.f)
+
+#define PITCH_MULT (0.7937005f) /* Approx. 4 semitones lower; what Nash suggested */
+
+#define PITCH(pitch) (snd_pitched ? (pitch)/128.f : 1.f)
+
+enum
+{
+	MIX_BLOCK = 1024,		// frames mixed at once
+	MIX_FRACBITS = 32,
+};
+
+static const float FracToFloat = 1.f / 4294967296.f;
+
+//==========================================================================
+//
+// Mixing kernels
+//
+// These add 'frames' frames of the source, starting at 'pos' and
+// advancing by 'step', to an interleaved stereo buffer, ramping the gains
+// linearly by dgl/dgr per frame. They return the new source position.
+// The caller makes sure that no frame past the sample's padding is read.
+//
+//==========================================================================
+
+static uint64_t MixMono(float *out, int frames, const float *src, uint64_t pos, uint64_t step, float gl, float gr, float dgl, float dgr)
+{
+	int i = 0;
+#ifndef NO_SSE
+	__m128 vgl = _mm_setr_ps(gl, gl + dgl, gl + 2 * dgl, gl + 3 * dgl);
+	__m128 vgr = _mm_setr_ps(gr, gr + dgr, gr + 2 * dgr, gr + 3 * dgr);
+	__m128 vdgl = _mm_set1_ps(dgl * 4);
+	__m128 vdgr = _mm_set1_ps(dgr * 4);
+	if (step == (uint64_t(1) << MIX_FRACBITS) && (pos & 0xffffffff) == 0)
+	{
+		// Playing at the output rate: no interpolation needed.
+		const float *s = src + (pos >> MIX_FRACBITS);
+		for (; i + 4 <= frames; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(s + i);
+			__m128 l = _mm_mul_ps(v, vgl);
+			__m128 r = _mm_mul_ps(v, vgr);
+			_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_unpacklo_ps(l, r)));
+			_mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(out + i * 2 + 4), _mm_unpackhi_ps(l, r)));
+			vgl = _mm_add_ps(vgl, vdgl);
+			vgr = _mm_add_ps(vgr, vdgr);
+		}
+		pos += uint64_t(i) << MIX_FRACBITS;
+	}
+	else
+	{
+		for (; i + 4 <= frames; i += 4)
+		{
+			alignas(16) float s0[4], s1[4], f[4];
+			for (int j = 0; j < 4; j++)
+			{
+				const float *s = src + (pos >> MIX_FRACBITS);
+				s0[j] = s[0];
+				s1[j] = s[1];
+				f[j] = (pos & 0xffffffff) * FracToFloat;
+				pos += step;
+			}
+			__m128 a = _mm_load_ps(s0);
+			__m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(s1), a), _mm_load_ps(f)));
+			__m128 l = _mm_mul_ps(v, vgl);
+			__m128 r = _mm_mul_ps(v, vgr);
+			_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_unpacklo_ps(l, r)));
+			_mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(out + i * 2 + 4), _mm_unpackhi_ps(l, r)));
+			vgl = _mm_add_ps(vgl, vdgl);
+			vgr = _mm_add_ps(vgr, vdgr);
+		}
+	}
+	gl += dgl * i;
+	gr += dgr * i;
+#endif
+	for (; i < frames; i++)
+	{
+		const float *s = src + (pos >> MIX_FRACBITS);
+		float v = s[0] + (s[1] - s[0]) * ((pos & 0xffffffff) * FracToFloat);
+		out[i * 2] += v * gl;
+		out[i * 2 + 1] += v * gr;
+		gl += dgl;
+		gr += dgr;
+		pos += step;
+	}
+	return pos;
+}
+
+static uint64_t MixStereo(float *out, int frames, const float *src, uint64_t pos, uint64_t step, float gl, float gr, float dgl, float dgr)
+{
+	int i = 0;
+#ifndef NO_SSE
+	// Two frames per vector.
+	__m128 vg = _mm_setr_ps(gl, gr, gl + dgl, gr + dgr);
+	__m128 vdg = _mm_setr_ps(dgl * 2, dgr * 2, dgl * 2, dgr * 2);
+	for (; i + 2 <= frames; i += 2)
+	{
+		const float *s = src + (pos >> MIX_FRACBITS) * 2;
+		float f0 = (pos & 0xffffffff) * FracToFloat;
+		pos += step;
+		const float *t = src + (pos >> MIX_FRACBITS) * 2;
+		float f1 = (pos & 0xffffffff) * FracToFloat;
+		pos += step;
+
+		__m128 a = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)s), (const __m64 *)t);
+		__m128 b = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(s + 2)), (const __m64 *)(t + 2));
+		__m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_setr_ps(f0, f0, f1, f1)));
+		_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_mul_ps(v, vg)));
+		vg = _mm_add_ps(vg, vdg);
+	}
+	gl += dgl * i;
+	gr += dgr * i;
+#endif
+	for (; i < frames; i++)
+	{
+		const float *s = src + (pos >> MIX_FRACBITS) * 2;
+		float f = (pos & 0xffffffff) * FracToFloat;
+		out[i * 2] += (s[0] + (s[2] - s[0]) * f) * gl;
+		out[i * 2 + 1] += (s[1] + (s[3] - s[1]) * f) * gr;
+		gl += dgl;
+		gr += dgr;
+		pos += step;
+	}
+	return pos;
+}
+
+static void ConvertToS16(int16_t *out, const float *in, int count)
+{
+	int i = 0;
+#ifndef NO_SSE
+	const __m128 scale = _mm_set1_ps(32767.f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+		__m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(a, b));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = (int16_t)lrintf(clamp(in[i] * 32767.f, -32768.f, 32767.f));
+	}
+}
+
+//==========================================================================
+//
+// SoftMixer
+//
+//==========================================================================
+
+SoftMixer::~SoftMixer()
+{
+	for (auto voice : Voices) delete voice;
+	for (auto voice : FreeVoices) delete voice;
+}
+
+SoftVoice *SoftMixer::AddVoice(SoftSample *sample)
+{
+	SoftVoice *voice;
+	if (FreeVoices.Pop(voice)) *voice = {};
+	else voice = new SoftVoice{};
+
+	voice->Sample = sample;
+	voice->Index = Voices.Push(voice);
+	voice->Volume = 1.f;
+	voice->Pitch = 1.f;
+	voice->JustStarted = true;
+	SetPitch(voice, 1.f);
+	return voice;
+}
+
+void SoftMixer::RemoveVoice(SoftVoice *voice)
+{
+	// Swap with the last voice so that removal is O(1).
+	SoftVoice *last = Voices.Last();
+	Voices[voice->Index] = last;
+	last->Index = voice->Index;
+	Voices.Pop();
+	FreeVoices.Push(voice);
+}
+
+void SoftMixer::SetPitch(SoftVoice *voice, float pitch)
+{
+	voice->Pitch = std::max(pitch, 0.0001f);
+	double step = voice->Pitch * double(voice->Sample->SampleRate) / SampleRate;
+	if (!voice->NoReverb) step *= PitchMultiplier;
+	voice->Step = std::max<uint64_t>(1, uint64_t(step * 4294967296.));
+}
+
+//==========================================================================
+//
+// Calculates the gains the voice should have at the end of the next block.
+//
+//==========================================================================
+
+void SoftMixer::UpdateGains(SoftVoice *voice, float volume)
+{
+	float gain = volume * voice->Volume;
+	float pan = 0;
+
+	if (voice->Is3D)
+	{
+		FVector3 dir = voice->Pos - ListenerPos;
+		float dist = dir.Length();
+		gain *= soundEngine->GetRolloff(&voice->Rolloff, dist * voice->DistanceScale);
+
+		if (dist > 0.0004f)
+		{
+			// The listener's right is +Z rotated by the angle, see OpenAL's orientation in oalsound.cpp.
+			pan = (dir.X * sinf(ListenerAngle) - dir.Z * cosf(ListenerAngle)) / dist;
+			// Area sounds come from everywhere when the listener is close to them.
+			if (voice->Area && dist < AREA_SOUND_RADIUS) pan *= dist / AREA_SOUND_RADIUS;
+		}
+	}
+
+	if (voice->Sample->Channels == 2)
+	{
+		// Stereo sounds are not spatialized.
+		voice->TargetL = voice->TargetR = gain;
+	}
+	else
+	{
+		float angle = (clamp(pan, -1.f, 1.f) + 1.f) * float(M_PI / 4);
+		voice->TargetL = gain * cosf(angle);
+		voice->TargetR = gain * sinf(angle);
+	}
+	if (voice->JustStarted)
+	{
+		// Don't fade in new sounds, that would soften their attack.
+		voice->GainL = voice->TargetL;
+		voice->GainR = voice->TargetR;
+		voice->JustStarted = false;
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void SoftMixer::MixVoice(SoftVoice *voice, float *out, int frames)
+{
+	SoftSample *sample = voice->Sample;
+	uint64_t end = uint64_t(voice->Looping ? sample->LoopEnd : sample->Frames) << MIX_FRACBITS;
+	uint64_t loopstart = uint64_t(sample->LoopStart) << MIX_FRACBITS;
+	float gl = voice->GainL, gr = voice->GainR;
+	float dgl = (voice->TargetL - gl) / frames;
+	float dgr = (voice->TargetR - gr) / frames;
+	auto kernel = sample->Channels == 2 ? MixStereo : MixMono;
+
+	// Voices that can't be heard only need their position advanced.
+	const float threshold = 1.f / 65536;
+	bool silent = std::max(std::max(gl, gr), std::max(voice->TargetL, voice->TargetR)) < threshold;
+	if (!silent) Audible++;
+
+	// In a loop the last frame has to be interpolated towards the loop start, not
+	// towards whatever follows it in the sample, so that frame is mixed from a copy.
+	bool wrap = voice->Looping && end > loopstart;
+	uint64_t lastframe = wrap ? end - (uint64_t(1) << MIX_FRACBITS) : end;
+	float edge[4];
+	if (wrap)
+	{
+		const float *src = sample->Data.Data();
+		for (int c = 0; c < sample->Channels; c++)
+		{
+			edge[c] = src[(sample->LoopEnd - 1) * sample->Channels + c];
+			edge[sample->Channels + c] = src[sample->LoopStart * sample->Channels + c];
+		}
+	}
+
+	int done = 0;
+	while (done < frames)
+	{
+		if (voice->Position >= end)
+		{
+			if (!wrap)
+			{
+				voice->Finished = true;
+				break;
+			}
+			voice->Position = loopstart + (voice->Position - end) % (end - loopstart);
+		}
+		const float *src = sample->Data.Data();
+		uint64_t limit = lastframe, base = 0;
+		if (voice->Position >= lastframe)
+		{
+			src = edge;
+			limit = end;
+			base = lastframe;
+		}
+		int count = (int)std::min<uint64_t>(frames - done, (limit - voice->Position + voice->Step - 1) / voice->Step);
+		if (silent) voice->Position += voice->Step * count;
+		else voice->Position = base + kernel(out + done * 2, count, src, voice->Position - base, voice->Step, gl, gr, dgl, dgr);
+		gl += dgl * count;
+		gr += dgr * count;
+		done += count;
+	}
+	voice->GainL = voice->TargetL;
+	voice->GainR = voice->TargetR;
+}
+
+void SoftMixer::Mix(float *out, int frames, float volume)
+{
+	Audible = 0;
+	for (auto voice : Voices)
+	{
+		if (voice->Paused || voice->Finished) continue;
+		UpdateGains(voice, volume);
+		MixVoice(voice, out, frames);
+	}
+}
+
+//==========================================================================
+//
+// SoftSoundStream
+//
+// Pulls the data from the callback when mixing and resamples it to the
+// output rate.
+//
+//==========================================================================
+
+class SoftSoundStream : public SoundStream
+{
+	SoftSoundRenderer *Renderer;
+	SoundStreamCallback Callback;
+	void *UserData;
+	int Flags;
+	int FrameSize;
+	TArray<uint8_t> Data;
+	TArray<float> Buffer;		// stereo frames at the stream's rate
+	uint64_t Position = 0;
+	uint64_t Step;
+	float Volume = 1.f;
+	bool Playing = false;
+	bool Paused = false;
+	bool Ended = false;
+
+public:
+	SoftSoundStream(SoftSoundRenderer *renderer) : Renderer(renderer)
+	{
+		Renderer->Streams.Push(this);
+	}
+
+	~SoftSoundStream()
+	{
+		unsigned idx = Renderer->Streams.Find(this);
+		if (idx < Renderer->Streams.Size()) Renderer->Streams.Delete(idx);
+	}
+
+	bool Init(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
+	{
+		if (samplerate <= 0) return false;
+
+		Callback = callback;
+		UserData = userdata;
+		Flags = flags;
+		Step = uint64_t(double(samplerate) / Renderer->Mixer.SampleRate * 4294967296.);
+
+		FrameSize = (flags & Bits8) ? 1 : (flags & (Bits32 | Float)) ? 4 : 2;
+		if (!(flags & Mono)) FrameSize *= 2;
+
+		buffbytes += FrameSize - 1;
+		buffbytes -= buffbytes % FrameSize;
+		Data.Resize(buffbytes);
+		return true;
+	}
+
+	bool Play(bool looping, float volume) override
+	{
+		Volume = volume;
+		Playing = true;
+		Ended = false;
+		return true;
+	}
+
+	void Stop() override
+	{
+		Playing = false;
+		Buffer.Clear();
+		Position = 0;
+	}
+
+	void SetVolume(float volume) override
+	{
+		Volume = volume;
+	}
+
+	bool SetPaused(bool paused) override
+	{
+		Paused = paused;
+		return true;
+	}
+
+	bool IsEnded() override
+	{
+		return !Playing || Ended;
+	}
+
+	FString GetStats() override
+	{
+		FString stats;
+		stats.Format("%s, %u frames buffered", Ended ? "ended" : Paused ? "paused" : Playing ? "playing" : "stopped", Buffer.Size() / 2);
+		return stats;
+	}
+
+	// Converts one buffer from the callback to float stereo.
+	bool Fill()
+	{
+		if (Ended || !Callback(this, Data.Data(), Data.Size(), UserData))
+		{
+			Ended = true;
+			return false;
+		}
+		int frames = Data.Size() / FrameSize;
+		int channels = (Flags & Mono) ? 1 : 2;
+		unsigned first = Buffer.Reserve(frames * 2);
+		float *dest = &Buffer[first];
+		for (int i = 0; i < frames * channels; i++)
+		{
+			float v;
+			if (Flags & Bits8) v = (Data[i] - 128) / 128.f;
+			else if (Flags & Float) v = ((float *)Data.Data())[i];
+			else if (Flags & Bits32) v = ((int32_t *)Data.Data())[i] / 2147483648.f;
+			else v = ((int16_t *)Data.Data())[i] / 32768.f;
+
+			if (channels == 2) dest[i] = v;
+			else dest[i * 2] = dest[i * 2 + 1] = v;
+		}
+		return true;
+	}
+
+	void Mix(float *out, int frames, float volume)
+	{
+		if (!Playing || Paused || Ended) return;
+
+		// One frame more than the last position is needed for the interpolation.
+		unsigned needed = unsigned(((Position + Step * frames) >> MIX_FRACBITS) + 2);
+		while (Buffer.Size() / 2 < needed)
+		{
+			if (!Fill()) break;
+		}
+		if (Buffer.Size() / 2 < needed)
+		{
+			// Let the remaining data play out.
+			unsigned old = Buffer.Size();
+			Buffer.Resize(needed * 2);
+			memset(&Buffer[old], 0, (needed * 2 - old) * sizeof(float));
+		}
+		float gain = volume * Volume;
+		Position = MixStereo(out, frames, Buffer.Data(), Position, Step, gain, gain, 0, 0);
+
+		// Drop everything that has been consumed.
+		unsigned consumed = unsigned(Position >> MIX_FRACBITS);
+		Buffer.Delete(0, consumed * 2);
+		Position -= uint64_t(consumed) << MIX_FRACBITS;
+	}
+};
+
+//==========================================================================
+//
+// SoftSoundRenderer
+//
+//==========================================================================
+
+SoftSoundRenderer::SoftSoundRenderer()
+	: Mixer(snd_samplerate != 0 ? *snd_samplerate : 44100)
+{
+	Printf("I_InitSound: Initializing software mixer\n");
+	MixBuffer.Resize(MIX_BLOCK * 2);
+	OutBuffer.Resize(MIX_BLOCK * 2);
+	LastMix = std::chrono::steady_clock::now();
+	OpenWavFile();
+}
+
+SoftSoundRenderer::~SoftSoundRenderer()
+{
+	while (Streams.Size() > 0) delete Streams.Last();
+	CloseWavFile();
+}
+
+//==========================================================================
+//
+// WAV output
+//
+//==========================================================================
+
+static void WriteWavHeader(FileWriter *file, int samplerate, uint32_t datasize)
+{
+	uint8_t header[44];
+	memcpy(header, "RIFF", 4);
+	*(uint32_t *)(header + 4) = LittleLong(36 + datasize);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	*(uint32_t *)(header + 16) = LittleLong(16);
+	*(uint16_t *)(header + 20) = LittleShort(uint16_t(1));			// PCM
+	*(uint16_t *)(header + 22) = LittleShort(uint16_t(2));			// channels
+	*(uint32_t *)(header + 24) = LittleLong(samplerate);
+	*(uint32_t *)(header + 28) = LittleLong(samplerate * 4);	// bytes per second
+	*(uint16_t *)(header + 32) = LittleShort(uint16_t(4));			// block align
+	*(uint16_t *)(header + 34) = LittleShort(uint16_t(16));			// bits per sample
+	memcpy(header + 36, "data", 4);
+	*(uint32_t *)(header + 40) = LittleLong(datasize);
+	file->Write(header, sizeof(header));
+}
+
+void SoftSoundRenderer::OpenWavFile()
+{
+	if (**snd_wavfile == 0) return;
+
+	WavFile = FileWriter::Open(snd_wavfile);
+	if (WavFile == nullptr)
+	{
+		Printf(TEXTCOLOR_RED "Could not open %s for writing\n", *snd_wavfile);
+		return;
+	}
+	WavBytes = 0;
+	WriteWavHeader(WavFile, Mixer.SampleRate, 0);
+}
+
+void SoftSoundRenderer::CloseWavFile()
+{
+	if (WavFile == nullptr) return;
+
+	// Now that the size is known the header can be completed.
+	WavFile->Seek(0, SEEK_SET);
+	WriteWavHeader(WavFile, Mixer.SampleRate, WavBytes);
+	delete WavFile;
+	WavFile = nullptr;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void SoftSoundRenderer::SetSfxVolume(float volume)
+{
+	SfxVolume = volume;
+}
+
+void SoftSoundRenderer::SetMusicVolume(float volume)
+{
+	MusicVolume = volume;
+}
+
+unsigned int SoftSoundRenderer::GetMSLength(SoundHandle sfx)
+{
+	auto sample = (SoftSample *)sfx.data;
+	if (sample == nullptr) return 0;
+	return (unsigned int)(sample->Frames * 1000. / sample->SampleRate);
+}
+
+unsigned int SoftSoundRenderer::GetSampleLength(SoundHandle sfx)
+{
+	auto sample = (SoftSample *)sfx.data;
+	return sample ? sample->Frames : 0;
+}
+
+float SoftSoundRenderer::GetOutputRate()
+{
+	return (float)Mixer.SampleRate;
+}
+
+SoundHandle SoftSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend)
+{
+	SoundHandle retval = { NULL };
+
+	if (length == 0) return retval;
+
+	if ((bits != 8 && bits != -8 && bits != 16) || (channels != 1 && channels != 2) || frequency <= 0)
+	{
+		Printf("Unhandled format: %d bit, %d channel, %d hz\n", bits, channels, frequency);
+		return retval;
+	}
+
+	auto sample = new SoftSample;
+	unsigned frames = length / (channels * abs(bits) / 8);
+	unsigned count = frames * channels;
+	sample->Channels = channels;
+	sample->SampleRate = frequency;
+	sample->Frames = frames;
+	sample->Data.Resize(count + channels);
+	float *dest = sample->Data.Data();
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (bits == 16) dest[i] = int16_t(sfxdata[i * 2] | (sfxdata[i * 2 + 1] << 8)) / 32768.f;
+		else if (bits == 8) dest[i] = (sfxdata[i] - 128) / 128.f;
+		else dest[i] = int8_t(sfxdata[i]) / 128.f;
+	}
+	for (int i = 0; i < channels; i++) dest[count + i] = 0;
+
+	// Without loop points the entire sound loops.
+	sample->LoopStart = 0;
+	sample->LoopEnd = frames;
+	if (loopstart > 0 || loopend > 0)
+	{
+		sample->LoopStart = std::min<unsigned>(std::max(loopstart, 0), frames);
+		if (loopend > loopstart) sample->LoopEnd = std::min<unsigned>(loopend, frames);
+		DPrintf(DMSG_NOTIFY, "Setting loop points %d -> %d\n", sample->LoopStart, sample->LoopEnd);
+	}
+
+	retval.data = sample;
+	return retval;
+}
+
+SoundHandle SoftSoundRenderer::LoadSound(uint8_t *sfxdata, int length)
+{
+	FDecodedSound decoded;
+	if (!DecodeSound(sfxdata, length, decoded))
+	{
+		SoundHandle retval = { NULL };
+		return retval;
+	}
+	return LoadDecodedSound(decoded);
+}
+
+void SoftSoundRenderer::UnloadSound(SoundHandle sfx)
+{
+	auto sample = (SoftSample *)sfx.data;
+	if (sample == nullptr) return;
+
+	FSoundChan *schan = soundEngine->GetChannels();
+	while (schan)
+	{
+		FSoundChan *next = schan->NextChan;
+		if (schan->SysChannel != nullptr && ((SoftVoice *)schan->SysChannel)->Sample == sample)
+		{
+			StopChannel(schan);
+		}
+		schan = next;
+	}
+	delete sample;
+}
+
+SoundStream *SoftSoundRenderer::CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
+{
+	SoftSoundStream *stream = new SoftSoundStream(this);
+	if (!stream->Init(callback, buffbytes, flags, samplerate, userdata))
+	{
+		delete stream;
+		return NULL;
+	}
+	return stream;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FISoundChannel *SoftSoundRenderer::StartVoice(SoftSample *sample, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan, float startTime)
+{
+	SoftVoice *voice = Mixer.AddVoice(sample);
+	voice->Looping = !!(chanflags & SNDF_LOOP);
+	voice->Pausable = !(chanflags & SNDF_NOPAUSE);
+	voice->NoReverb = !!(chanflags & SNDF_NOREVERB);
+	voice->Area = !!(chanflags & SNDF_AREA);
+	voice->Volume = vol;
+	voice->Paused = Synced || (voice->Pausable && SFXPaused);
+	Mixer.SetPitch(voice, PITCH(pitch));
+
+	double offset;
+	if (!reuse_chan || reuse_chan->StartTime == 0)
+	{
+		offset = startTime * double(sample->SampleRate);
+	}
+	else if (chanflags & SNDF_ABSTIME)
+	{
+		offset = double(reuse_chan->StartTime);
+	}
+	else
+	{
+		offset = std::chrono::duration_cast<std::chrono::duration<double>>(
+			std::chrono::steady_clock::now().time_since_epoch() -
+			std::chrono::steady_clock::time_point::duration(reuse_chan->StartTime)
+		).count() * sample->SampleRate;
+	}
+	if (offset > 0)
+	{
+		if (voice->Looping && sample->LoopEnd > sample->LoopStart && offset >= sample->LoopEnd)
+		{
+			offset = sample->LoopStart + fmod(offset - sample->LoopEnd, double(sample->LoopEnd - sample->LoopStart));
+		}
+		voice->Position = uint64_t(std::min<double>(offset, sample->Frames) * 4294967296.);
+	}
+
+	FISoundChannel *chan = reuse_chan;
+	if (!chan) chan = soundEngine->GetChannel(voice);
+	else chan->SysChannel = voice;
+	voice->Chan = chan;
+	return chan;
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound(SoundHandle sfx, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan, float startTime)
+{
+	auto sample = (SoftSample *)sfx.data;
+	if (sample == nullptr) return NULL;
+
+	FISoundChannel *chan = StartVoice(sample, vol, pitch, chanflags, reuse_chan, startTime);
+	auto voice = (SoftVoice *)chan->SysChannel;
+	voice->Is3D = false;
+
+	chan->Rolloff.RolloffType = ROLLOFF_Log;
+	chan->Rolloff.RolloffFactor = 0.f;
+	chan->Rolloff.MinDistance = 1.f;
+	chan->DistanceSqr = 0.f;
+	chan->ManualRolloff = false;
+	return chan;
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener *listener, float vol,
+	FRolloffInfo *rolloff, float distscale, int pitch, int priority, const FVector3 &pos, const FVector3 &vel,
+	int channum, int chanflags, FISoundChannel *reuse_chan, float startTime)
+{
+	auto sample = (SoftSample *)sfx.data;
+	if (sample == nullptr) return NULL;
+
+	FISoundChannel *chan = StartVoice(sample, vol, pitch, chanflags, reuse_chan, startTime);
+	auto voice = (SoftVoice *)chan->SysChannel;
+	voice->Is3D = true;
+	voice->Pos = pos;
+	voice->Rolloff = *rolloff;
+	voice->DistanceScale = distscale;
+
+	chan->Rolloff = *rolloff;
+	chan->DistanceSqr = (float)(pos - listener->position).LengthSquared();
+	chan->ManualRolloff = true;
+	return chan;
+}
+
+void SoftSoundRenderer::ChannelVolume(FISoundChannel *chan, float volume)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	((SoftVoice *)chan->SysChannel)->Volume = volume;
+}
+
+void SoftSoundRenderer::ChannelPitch(FISoundChannel *chan, float pitch)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	Mixer.SetPitch((SoftVoice *)chan->SysChannel, pitch);
+}
+
+void SoftSoundRenderer::StopChannel(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	SoftVoice *voice = (SoftVoice *)chan->SysChannel;
+	// Release first, so it can be properly marked as evicted if it's being killed
+	soundEngine->ChannelEnded(chan);
+
+	Mixer.RemoveVoice(voice);
+
+	if (!(chan->ChanFlags & CHANF_EVICTED))
+		soundEngine->SoundDone(chan);
+}
+
+unsigned int SoftSoundRenderer::GetPosition(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return 0;
+
+	return unsigned(((SoftVoice *)chan->SysChannel)->Position >> MIX_FRACBITS);
+}
+
+void SoftSoundRenderer::UpdatePaused()
+{
+	for (auto voice : Mixer.Voices)
+	{
+		voice->Paused = Synced || (voice->Pausable && SFXPaused);
+	}
+}
+
+void SoftSoundRenderer::SetSfxPaused(bool paused, int slot)
+{
+	if (paused) SFXPaused |= 1 << slot;
+	else SFXPaused &= ~(1 << slot);
+	UpdatePaused();
+}
+
+void SoftSoundRenderer::Sync(bool sync)
+{
+	Synced = sync;
+	UpdatePaused();
+}
+
+void SoftSoundRenderer::SetInactive(SoundRenderer::EInactiveState state)
+{
+	Inactive = state;
+}
+
+void SoftSoundRenderer::UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	SoftVoice *voice = (SoftVoice *)chan->SysChannel;
+	voice->Pos = pos;
+	voice->Area = areasound;
+	chan->DistanceSqr = (float)(pos - listener->position).LengthSquared();
+}
+
+void SoftSoundRenderer::UpdateListener(SoundListener *listener)
+{
+	if (!listener->valid)
+		return;
+
+	Mixer.ListenerPos = listener->position;
+	Mixer.ListenerAngle = listener->angle;
+
+	// There is no reverb, but the pitch shift for being underwater can be done.
+	const ReverbContainer *env = listener->Environment ? listener->Environment : DefaultEnvironments[0];
+	bool inwater = listener->underwater || (env && env->SoftwareWater);
+	if (inwater != WasInWater)
+	{
+		WasInWater = inwater;
+		Mixer.PitchMultiplier = inwater ? PITCH_MULT : 1.f;
+		for (auto voice : Mixer.Voices)
+		{
+			Mixer.SetPitch(voice, voice->Pitch);
+		}
+	}
+}
+
+//==========================================================================
+//
+// Mixes the time that has passed since the last update.
+//
+//==========================================================================
+
+void SoftSoundRenderer::MixFrames(int frames)
+{
+	float *mix = MixBuffer.Data();
+	float sfxvolume = Inactive == INACTIVE_Active ? SfxVolume : 0.f;
+	float musicvolume = Inactive == INACTIVE_Active ? MusicVolume : 0.f;
+
+	MixCycles.Clock();
+	while (frames > 0)
+	{
+		int count = std::min<int>(frames, MIX_BLOCK);
+		memset(mix, 0, count * 2 * sizeof(float));
+
+		Mixer.Mix(mix, count, sfxvolume);
+		for (auto stream : Streams)
+		{
+			stream->Mix(mix, count, musicvolume);
+		}
+
+		if (WavFile != nullptr)
+		{
+			ConvertToS16(OutBuffer.Data(), mix, count * 2);
+#ifdef __BIG_ENDIAN__
+			for (int i = 0; i < count * 2; i++) OutBuffer[i] = LittleShort(OutBuffer[i]);
+#endif
+			WavBytes += (uint32_t)WavFile->Write(OutBuffer.Data(), count * 2 * sizeof(int16_t));
+		}
+		frames -= count;
+		StatFrames += count;
+	}
+	MixCycles.Unclock();
+
+	// Mixing time relative to the length of the mixed audio, averaged over a second.
+	if (StatFrames >= Mixer.SampleRate)
+	{
+		MixLoad = MixCycles.TimeMS() / (StatFrames * 1000. / Mixer.SampleRate);
+		MixCycles.Reset();
+		StatFrames = 0;
+	}
+}
+
+void SoftSoundRenderer::UpdateSounds()
+{
+	auto now = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - LastMix).count();
+	LastMix = now;
+
+	// A completely inactive device doesn't produce anything.
+	if (Inactive == INACTIVE_Complete) return;
+
+	// Don't try to catch up on long stalls like loading a level.
+	PendingFrames += std::min(elapsed, 0.25) * Mixer.SampleRate;
+	int frames = int(PendingFrames);
+	PendingFrames -= frames;
+	if (frames > 0) MixFrames(frames);
+
+	// Release channels that are done.
+	for (unsigned i = Mixer.Voices.Size(); i-- > 0; )
+	{
+		if (i < Mixer.Voices.Size() && Mixer.Voices[i]->Finished)
+		{
+			StopChannel(Mixer.Voices[i]->Chan);
+		}
+	}
+}
+
+bool SoftSoundRenderer::IsValid()
+{
+	return true;
+}
+
+void SoftSoundRenderer::MarkStartTime(FISoundChannel *chan, float startTime)
+{
+	using namespace std::chrono;
+	auto startTimeDuration = duration<double>(startTime);
+	auto diff = steady_clock::now().time_since_epoch() - startTimeDuration;
+	chan->StartTime = static_cast<uint64_t>(duration_cast<nanoseconds>(diff).count());
+}
+
+float SoftSoundRenderer::GetAudibility(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return 0.f;
+
+	float volume = SfxVolume * ((SoftVoice *)chan->SysChannel)->Volume;
+	return volume * soundEngine->GetRolloff(&chan->Rolloff, sqrtf(chan->DistanceSqr) * chan->DistanceScale);
+}
+
+void SoftSoundRenderer::PrintStatus()
+{
+	Printf("Software mixer: " TEXTCOLOR_BLUE "%d" TEXTCOLOR_NORMAL " Hz stereo\n", Mixer.SampleRate);
+#ifndef NO_SSE
+	Printf("Mixing kernels: " TEXTCOLOR_BLUE "SSE2\n");
+#else
+	Printf("Mixing kernels: " TEXTCOLOR_BLUE "C\n");
+#endif
+	if (WavFile) Printf("Writing to " TEXTCOLOR_BLUE "%s\n", *snd_wavfile);
+	else Printf("Output is discarded, set snd_wavfile to record it.\n");
+}
+
+void SoftSoundRenderer::PrintDriversList()
+{
+	Printf("Software mixer uses no drivers.\n");
+}
+
+FString SoftSoundRenderer::GatherStats()
+{
+	FString out;
+	out.Format("%u voices (" TEXTCOLOR_YELLOW "%u" TEXTCOLOR_NORMAL " audible), %u streams, Mixing: " TEXTCOLOR_YELLOW "%.2f" TEXTCOLOR_NORMAL "%% of realtime",
+		Mixer.Voices.Size(), Mixer.Audible, Streams.Size(), MixLoad * 100);
+	return out;
+}
+
+//==========================================================================
+//
+// CCMD snd_mixbench
+//
+// Mixes the given number of looping 3D voices at random positions and
+// pitches for a number of seconds of audio, without any output, and
+// reports how long that took.
+//
+//==========================================================================
+
+CCMD(snd_mixbench)
+{
+	if (soundEngine == nullptr) return;
+
+	int numvoices = argv.argc() > 1 ? clamp(atoi(argv[1]), 1, 100000) : 1000;
+	int seconds = argv.argc() > 2 ? clamp(atoi(argv[2]), 1, 600) : 10;
+
+	SoftMixer mixer(48000);
+	FRandom rng;	// unnamed, so that it stays out of the savegames
+
+	// One second of a 440 Hz tone at the typical 11025 Hz of the original sounds.
+	SoftSample tone;
+	tone.Channels = 1;
+	tone.SampleRate = 11025;
+	tone.Frames = 11025;
+	tone.LoopStart = 0;
+	tone.LoopEnd = tone.Frames;
+	tone.Data.Resize(tone.Frames + 1);
+	for (unsigned i = 0; i < tone.Frames; i++) tone.Data[i] = sinf(i * 440.f * float(2 * M_PI) / tone.SampleRate) * 0.5f;
+	tone.Data[tone.Frames] = 0;
+
+	for (int i = 0; i < numvoices; i++)
+	{
+		SoftVoice *voice = mixer.AddVoice(&tone);
+		voice->Looping = true;
+		voice->Is3D = true;
+		voice->Pos = FVector3(float(rng.Random2() * 8), float(rng.Random2()), float(rng.Random2() * 8));
+		voice->Rolloff.RolloffType = ROLLOFF_Doom;
+		voice->Rolloff.MinDistance = 200;
+		voice->Rolloff.MaxDistance = 1200;
+		voice->DistanceScale = 1;
+		voice->Volume = 1.f / numvoices;
+		mixer.SetPitch(voice, 0.75f + rng() / 512.f);
+	}
+
+	TArray<float> buffer(MIX_BLOCK * 2, true);
+	int frames = seconds * mixer.SampleRate;
+	unsigned audible = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int done = 0; done < frames; done += MIX_BLOCK)
+	{
+		int count = std::min<int>(MIX_BLOCK, frames - done);
+		memset(buffer.Data(), 0, count * 2 * sizeof(float));
+		mixer.ListenerAngle = done * float(2 * M_PI) / mixer.SampleRate;	// keep the panning moving
+		mixer.Mix(buffer.Data(), count, 1.f);
+		audible = std::max(audible, mixer.Audible);
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	Printf("Mixed %d voices (%u audible) for %d s in %.1f ms: %.1fx realtime\n", numvoices, audible, seconds, ms, seconds * 1000. / ms);
+}
@@ -0,0 +1,148 @@
+#ifndef SOFTSOUND_H
+#define SOFTSOUND_H
+
+#include <chrono>
+
+#include "i_sound.h"
+#include "s_soundinternal.h"
+#include "stats.h"
+
+class FileWriter;
+class SoftSoundStream;
+
+// A sound converted to float samples. There is one extra frame of silence
+// after the end so that the interpolation never needs to check bounds.
+struct SoftSample
+{
+	TArray<float> Data;
+	int Channels;
+	int SampleRate;
+	unsigned Frames;
+	unsigned LoopStart;
+	unsigned LoopEnd;
+};
+
+struct SoftVoice
+{
+	FISoundChannel *Chan;
+	SoftSample *Sample;
+	unsigned Index;				// in SoftMixer::Voices
+	uint64_t Position;			// 32.32 fixed point frame position
+	uint64_t Step;
+	float Volume;
+	float Pitch;
+	float GainL, GainR;			// gains at the end of the last mixed block
+	float TargetL, TargetR;
+	FRolloffInfo Rolloff;
+	float DistanceScale;
+	FVector3 Pos;
+	bool Looping;
+	bool Pausable;
+	bool NoReverb;
+	bool Is3D;
+	bool Area;
+	bool Paused;
+	bool Finished;
+	bool JustStarted;
+};
+
+// The mixing core, independent of the sound engine's channel bookkeeping
+// so that it can be benchmarked on its own.
+class SoftMixer
+{
+public:
+	SoftMixer(int samplerate) : SampleRate(samplerate) {}
+	~SoftMixer();
+
+	SoftVoice *AddVoice(SoftSample *sample);
+	void RemoveVoice(SoftVoice *voice);
+	void SetPitch(SoftVoice *voice, float pitch);
+	void UpdateGains(SoftVoice *voice, float volume);
+
+	// Adds all voices to the interleaved stereo buffer.
+	void Mix(float *out, int frames, float volume);
+
+	int SampleRate;
+	float PitchMultiplier = 1.f;
+	FVector3 ListenerPos = { 0, 0, 0 };
+	float ListenerAngle = 0;
+	TArray<SoftVoice *> Voices;
+	unsigned Audible = 0;
+
+private:
+	void MixVoice(SoftVoice *voice, float *out, int frames);
+
+	TArray<SoftVoice *> FreeVoices;
+};
+
+class SoftSoundRenderer : public SoundRenderer
+{
+public:
+	SoftSoundRenderer();
+	virtual ~SoftSoundRenderer();
+
+	virtual void SetSfxVolume(float volume);
+	virtual void SetMusicVolume(float volume);
+	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length);
+	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1);
+	virtual void UnloadSound(SoundHandle sfx);
+	virtual unsigned int GetMSLength(SoundHandle sfx);
+	virtual unsigned int GetSampleLength(SoundHandle sfx);
+	virtual float GetOutputRate();
+
+	virtual SoundStream *CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata);
+
+	virtual FISoundChannel *StartSound(SoundHandle sfx, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan, float startTime);
+	virtual FISoundChannel *StartSound3D(SoundHandle sfx, SoundListener *listener, float vol, FRolloffInfo *rolloff, float distscale, int pitch, int priority, const FVector3 &pos, const FVector3 &vel, int channum, int chanflags, FISoundChannel *reuse_chan, float startTime);
+
+	virtual void ChannelVolume(FISoundChannel *chan, float volume);
+	virtual void ChannelPitch(FISoundChannel *chan, float pitch);
+	virtual void StopChannel(FISoundChannel *chan);
+	virtual unsigned int GetPosition(FISoundChannel *chan);
+	virtual void Sync(bool sync);
+	virtual void SetSfxPaused(bool paused, int slot);
+	virtual void SetInactive(SoundRenderer::EInactiveState inactive);
+	virtual void UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel);
+	virtual void UpdateListener(SoundListener *);
+	virtual void UpdateSounds();
+	virtual void MarkStartTime(FISoundChannel*, float startTime);
+	virtual float GetAudibility(FISoundChannel*);
+
+	virtual bool IsValid();
+	virtual void PrintStatus();
+	virtual void PrintDriversList();
+	virtual FString GatherStats();
+
+private:
+	friend class SoftSoundStream;
+
+	FISoundChannel *StartVoice(SoftSample *sample, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan, float startTime);
+	void UpdatePaused();
+	void MixFrames(int frames);
+	void OpenWavFile();
+	void CloseWavFile();
+
+	SoftMixer Mixer;
+	TArray<SoftSoundStream *> Streams;
+	TArray<float> MixBuffer;
+	TArray<int16_t> OutBuffer;
+
+	float SfxVolume = 1.f;
+	float MusicVolume = 1.f;
+	int SFXPaused = 0;
+	bool Synced = false;
+	bool WasInWater = false;
+	EInactiveState Inactive = INACTIVE_Active;
+
+	std::chrono::steady_clock::time_point LastMix;
+	double PendingFrames = 0;
+
+	FileWriter *WavFile = nullptr;
+	uint32_t WavBytes = 0;
+
+	cycle_t MixCycles;
+	int StatFrames = 0;
+	double MixLoad = 0;
+};
+
+#endif
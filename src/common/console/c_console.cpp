@@ -426,11 +426,21 @@ void WriteLineToLog(FILE *LogFile, const char *outline)
 
 extern bool gameisdead;
 
+// Worker threads may not touch the console. If this is set, PrintString
+// collects the output so that the main thread can print it later.
+thread_local TArray<std::pair<int, FString>> *DeferredPrints;
+
 int PrintString (int iprintlevel, const char *outline)
 {
 	if (gameisdead)
 		return 0;
 
+	if (DeferredPrints != nullptr)
+	{
+		DeferredPrints->Push(std::make_pair(iprintlevel, FString(outline)));
+		return (int)strlen(outline);
+	}
+
 	if (!conbuffer) return 0;	// when called too early
 	int printlevel = iprintlevel & PRINT_TYPES;
 	if (printlevel < msglevel || *outline == '\0')
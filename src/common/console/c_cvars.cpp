@@ -65,6 +65,22 @@ int cvar_defflags;
 
 static ConsoleCallbacks* callbacks;
 
+//==========================================================================
+//
+// Case insensitive index over the CVars list, so that looking up a cvar
+// doesn't have to compare the name against every registered variable.
+// A name always maps to the cvar a walk over the list would find first.
+// This is a function static so that it gets constructed before the first
+// cvar registers itself and destroyed after the last one is gone.
+//
+//==========================================================================
+
+static TMap<FName, FBaseCVar *> &CVarIndex()
+{
+	static TMap<FName, FBaseCVar *> index;
+	return index;
+}
+
 // Install game-specific handlers, mainly to deal with serverinfo and userinfo CVARs.
 // This is to keep the console independent of game implementation details for easier reusability.
 void C_InstallHandlers(ConsoleCallbacks* cb)
@@ -102,6 +118,8 @@ FBaseCVar::FBaseCVar (const char *var_name, uint32_t flags, void (*callback)(FBa
 		VarName = var_name;
 		m_Next = CVars;
 		CVars = this;
+		m_IndexName = FName(var_name);
+		CVarIndex()[m_IndexName] = this;
 	}
 
 	if (var)
@@ -140,7 +158,22 @@ FBaseCVar::~FBaseCVar ()
 			else
 				CVars = m_Next;
 		}
-		if (var->Flags & CVAR_AUTO)
+
+		auto &index = CVarIndex();
+		auto indexed = index.CheckKey(m_IndexName);
+		if (indexed != nullptr && *indexed == this)
+		{
+			index.Remove(m_IndexName);
+			for (auto other = CVars; other != nullptr; other = other->m_Next)
+			{
+				if (other != this && other->m_IndexName == m_IndexName)
+				{
+					index[m_IndexName] = other;
+					break;
+				}
+			}
+		}
+		if (Flags & CVAR_AUTO)
 			C_RemoveTabCommand(VarName);
 	}
 }
@@ -1264,16 +1297,28 @@ void C_ForgetCVars (void)
 	CVarBackups.Clear();
 }
 
+FBaseCVar *FindCVar (FName name)
+{
+	auto var = CVarIndex().CheckKey(name);
+	return var != nullptr ? *var : nullptr;
+}
+
 FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev)
 {
 	FBaseCVar *var;
-	FBaseCVar *dummy;
 
 	if (var_name == NULL)
 		return NULL;
 
 	if (prev == NULL)
-		prev = &dummy;
+	{
+		// Only the unlinking code needs the predecessor, everything else can use the index.
+		// Every cvar's name is in the name table, so a name that isn't can be rejected right away.
+		FName name(var_name, true);
+		if (name == NAME_None && stricmp(var_name, "None") != 0)
+			return NULL;
+		return FindCVar(name);
+	}
 
 	var = CVars;
 	*prev = NULL;
@@ -1289,29 +1334,26 @@ FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev)
 
 FBaseCVar *FindCVarSub (const char *var_name, int namelen)
 {
-	FBaseCVar *var;
-
 	if (var_name == NULL)
 		return NULL;
 
-	var = CVars;
-	while (var)
-	{
-		const char *probename = var->GetName ();
-
-		if (strnicmp (probename, var_name, namelen) == 0 &&
-			probename[namelen] == 0)
-		{
-			break;
-		}
-		var = var->m_Next;
-	}
-	return var;
+	FName name(var_name, namelen, true);
+	if (name == NAME_None && (namelen != 4 || strnicmp(var_name, "None", 4) != 0))
+		return NULL;
+	return FindCVar(name);
 }
 
 FBaseCVar *GetCVar(int playernum, const char *cvarname)
 {
-	FBaseCVar *cvar = FindCVar(cvarname, nullptr);
+	FName name(cvarname, true);
+	if (name == NAME_None && stricmp(cvarname, "None") != 0)
+		return nullptr;
+	return GetCVar(playernum, name);
+}
+
+FBaseCVar *GetCVar(int playernum, FName cvarname)
+{
+	FBaseCVar *cvar = FindCVar(cvarname);
 	// Either the cvar doesn't exist, or it's for a mod that isn't loaded, so return nullptr.
 	if (cvar == nullptr || (cvar->GetFlags() & CVAR_IGNORE))
 	{
@@ -1322,7 +1364,7 @@ FBaseCVar *GetCVar(int playernum, const char *cvarname)
 		// For userinfo cvars, redirect to GetUserCVar
 		if ((cvar->GetFlags() & CVAR_USERINFO) && callbacks && callbacks->GetUserCVar)
 		{
-			return callbacks->GetUserCVar(playernum, cvarname);
+			return callbacks->GetUserCVar(playernum, cvarname.GetChars());
 		}
 		return cvar;
 	}
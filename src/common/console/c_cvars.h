@@ -35,6 +35,7 @@
 #define __C_CVARS_H__
 #include "zstring.h"
 #include "tarray.h"
+#include "name.h"
 
 class FSerializer; // this needs to go away.
 /*
@@ -209,6 +210,7 @@ private:
 	FBaseCVar (const char *name, uint32_t flags);
 	void (*m_Callback)(FBaseCVar &);
 	FBaseCVar *m_Next;
+	FName m_IndexName = NAME_None;	// key in the name index, see FindCVar
 
 	static bool m_UseCallback;
 	static bool m_DoNoSet;
@@ -220,6 +222,7 @@ private:
 	friend void C_BackupCVars (void);
 	friend FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev);
 	friend FBaseCVar *FindCVarSub (const char *var_name, int namelen);
+	friend FBaseCVar *FindCVar (FName name);
 	friend void UnlatchCVars (void);
 	friend void DestroyCVarsFlagged (uint32_t flags);
 	friend void C_ArchiveCVars (FConfigFile *f, uint32_t filter);
@@ -249,9 +252,12 @@ void C_BackupCVars (void);
 // Finds a named cvar
 FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev);
 FBaseCVar *FindCVarSub (const char *var_name, int namelen);
+FBaseCVar *FindCVar (FName name);
 
 // Used for ACS and DECORATE.
 FBaseCVar *GetCVar(int playernum, const char *cvarname);
+FBaseCVar *GetCVar(int playernum, FName cvarname);
+inline FBaseCVar *GetCVar(int playernum, const FString &cvarname) { return GetCVar(playernum, cvarname.GetChars()); }
 
 // Create a new cvar with the specified name and type
 FBaseCVar *C_CreateCVar(const char *var_name, ECVarType var_type, uint32_t flags);
@@ -856,9 +856,17 @@ xx(BuiltinHandleRuntimeState)
 xx(BuiltinGetDefault)
 xx(BuiltinClassCast)
 xx(BuiltinFormat)
+xx(BuiltinSightDataChanged)
 xx(Damage)
 xx(Noattack)
 
+// Map data fields that sight checks depend on
+xx(Line)
+xx(SectorPortal)
+xx(Flags)
+xx(Activation)
+xx(Portals)
+
 // basic type names
 xx(Default)
 xx(sByte)
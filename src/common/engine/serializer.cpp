@@ -116,16 +116,341 @@ const char *UnicodeToString(const char *cc)
 
 //==========================================================================
 //
+// Binary format
 //
+//==========================================================================
+
+static const char BinaryMagic[4] = { 'G', 'Z', 'S', 'B' };
+static const uint8_t BinaryVersion = 1;
+
+FBinaryWriter::FBinaryWriter()
+{
+	Bytes(BinaryMagic, 4);
+	Byte(BinaryVersion);
+}
+
+//==========================================================================
+//
+// Object keys are interned, so each one is written out only once.
 //
 //==========================================================================
 
-bool FSerializer::OpenWriter(bool pretty)
+void FBinaryWriter::Key(const char *k)
+{
+	unsigned *keyindex = mKeyMap.CheckKey(k);
+	if (keyindex != nullptr)
+	{
+		Varint(*keyindex + 2);
+	}
+	else
+	{
+		unsigned index = mKeys.Push(k);
+		mKeyMap.Insert(mKeys[index].GetChars(), index);
+		size_t len = strlen(k);
+		Varint(1);
+		Varint(len);
+		Bytes(k, len + 1);
+	}
+}
+
+void FBinaryWriter::Double(double k)
+{
+	float f = (float)k;
+	if (f == k)
+	{
+		uint32_t bits;
+		memcpy(&bits, &f, 4);
+		BeginValue(BT_Float);
+		Byte(BT_Float);
+		for (int i = 0; i < 32; i += 8) Byte(uint8_t(bits >> i));
+	}
+	else
+	{
+		uint64_t bits;
+		memcpy(&bits, &k, 8);
+		BeginValue(BT_Double);
+		Byte(BT_Double);
+		for (int i = 0; i < 64; i += 8) Byte(uint8_t(bits >> i));
+	}
+}
+
+//==========================================================================
+//
+// Arrays of numbers get rewritten without the type tags once it is known
+// what they contain. A mix of floats and doubles is stored as doubles
+// if that does not make it larger.
+//
+//==========================================================================
+
+void FBinaryWriter::EndArray()
+{
+	Container c;
+	mContainers.Pop(c);
+
+	if (c.Kind == BT_Double && c.Floats > 0)
+	{
+		unsigned tagged = 2 + 5 * c.Floats + 9 * (c.Count - c.Floats);
+		unsigned packed = 2 + 8 * c.Count;
+		if (packed > tagged) c.Kind = BT_End;
+	}
+	if (c.Count == 0 || c.Kind == BT_End)
+	{
+		Byte(BT_End);
+		return;
+	}
+
+	mPacked.Clear();
+	const uint8_t *p = &mOutput[c.Start + 1];
+	for (unsigned i = 0; i < c.Count; i++)
+	{
+		uint8_t tag = *p++;
+		if (tag == BT_Int)
+		{
+			do mPacked.Push(*p); while (*p++ & 0x80);
+		}
+		else if (tag == c.Kind)
+		{
+			int size = tag == BT_Float ? 4 : 8;
+			for (int j = 0; j < size; j++) mPacked.Push(*p++);
+		}
+		else
+		{
+			// a float in an array of doubles.
+			uint32_t bits = p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+			float f;
+			double d;
+			memcpy(&f, &bits, 4);
+			d = f;
+			uint64_t dbits;
+			memcpy(&dbits, &d, 8);
+			for (int j = 0; j < 64; j += 8) mPacked.Push(uint8_t(dbits >> j));
+			p += 4;
+		}
+	}
+
+	mOutput.Resize(c.Start);
+	Byte(c.Kind == BT_Int ? BT_IntArray : c.Kind == BT_Float ? BT_FloatArray : BT_DoubleArray);
+	Varint(c.Count);
+	Bytes(mPacked.Data(), mPacked.Size());
+}
+
+//==========================================================================
+//
+// Turns the binary data into the events the document is built from.
+// All strings point into the buffer, which has to outlive the document.
+//
+//==========================================================================
+
+class FBinaryReader
+{
+	const uint8_t *mData;
+	const uint8_t *mEnd;
+	TArray<const char *> mKeys;
+	TArray<unsigned> mKeyLengths;
+
+	bool ReadVarint(uint64_t &v)
+	{
+		v = 0;
+		for (int shift = 0; shift < 64 && mData < mEnd; shift += 7)
+		{
+			uint8_t b = *mData++;
+			v |= uint64_t(b & 0x7f) << shift;
+			if (!(b & 0x80)) return true;
+		}
+		return false;
+	}
+
+	bool ReadInt(int64_t &v)
+	{
+		uint64_t u;
+		if (!ReadVarint(u)) return false;
+		v = int64_t(u >> 1) ^ -int64_t(u & 1);
+		return true;
+	}
+
+	bool ReadBits(uint64_t &v, int size)
+	{
+		if (mEnd - mData < size) return false;
+		v = 0;
+		for (int i = 0; i < size; i++) v |= uint64_t(*mData++) << (i * 8);
+		return true;
+	}
+
+	bool ReadFloat(double &d)
+	{
+		uint64_t bits;
+		if (!ReadBits(bits, 4)) return false;
+		uint32_t bits32 = (uint32_t)bits;
+		float f;
+		memcpy(&f, &bits32, 4);
+		d = f;
+		return true;
+	}
+
+	bool ReadDouble(double &d)
+	{
+		uint64_t bits;
+		if (!ReadBits(bits, 8)) return false;
+		memcpy(&d, &bits, 8);
+		return true;
+	}
+
+	bool ReadString(const char *&str, unsigned &len)
+	{
+		uint64_t v;
+		if (!ReadVarint(v) || v >= uint64_t(mEnd - mData) || mData[v] != 0) return false;
+		str = (const char *)mData;
+		len = (unsigned)v;
+		mData += v + 1;
+		return true;
+	}
+
+	bool ReadCount(uint64_t &count, int minsize)
+	{
+		return ReadVarint(count) && count <= uint64_t(mEnd - mData) / minsize;
+	}
+
+	bool ReadValue(rapidjson::Document &doc)
+	{
+		if (mData >= mEnd) return false;
+		uint8_t tag = *mData++;
+		uint64_t u, count;
+		int64_t i;
+		double d;
+		const char *str;
+		unsigned len;
+
+		switch (tag)
+		{
+		case BT_Null:
+			return doc.Null();
+
+		case BT_False:
+		case BT_True:
+			return doc.Bool(tag == BT_True);
+
+		case BT_Int:
+			return ReadInt(i) && doc.Int64(i);
+
+		case BT_Uint64:
+			return ReadVarint(u) && doc.Uint64(u);
+
+		case BT_Float:
+			return ReadFloat(d) && doc.Double(d);
+
+		case BT_Double:
+			return ReadDouble(d) && doc.Double(d);
+
+		case BT_String:
+			return ReadString(str, len) && doc.String(str, len, false);
+
+		case BT_Object:
+			doc.StartObject();
+			for (count = 0; ; count++)
+			{
+				if (!ReadVarint(u)) return false;
+				if (u == 0) break;
+				if (u == 1)
+				{
+					if (!ReadString(str, len)) return false;
+					mKeys.Push(str);
+					mKeyLengths.Push(len);
+				}
+				else if (u - 2 < mKeys.Size())
+				{
+					str = mKeys[unsigned(u - 2)];
+					len = mKeyLengths[unsigned(u - 2)];
+				}
+				else return false;
+				if (!doc.Key(str, len, false) || !ReadValue(doc)) return false;
+			}
+			return doc.EndObject((rapidjson::SizeType)count);
+
+		case BT_Array:
+			doc.StartArray();
+			for (count = 0; mData < mEnd && *mData != BT_End; count++)
+			{
+				if (!ReadValue(doc)) return false;
+			}
+			if (mData++ >= mEnd) return false;
+			return doc.EndArray((rapidjson::SizeType)count);
+
+		case BT_IntArray:
+			if (!ReadCount(count, 1)) return false;
+			doc.StartArray();
+			for (u = 0; u < count; u++)
+			{
+				if (!ReadInt(i)) return false;
+				doc.Int64(i);
+			}
+			return doc.EndArray((rapidjson::SizeType)count);
+
+		case BT_FloatArray:
+		case BT_DoubleArray:
+			if (!ReadCount(count, tag == BT_FloatArray ? 4 : 8)) return false;
+			doc.StartArray();
+			for (u = 0; u < count; u++)
+			{
+				if (tag == BT_FloatArray) ReadFloat(d);
+				else ReadDouble(d);
+				doc.Double(d);
+			}
+			return doc.EndArray((rapidjson::SizeType)count);
+
+		default:
+			return false;
+		}
+	}
+
+public:
+	FBinaryReader(const char *buffer, size_t length)
+	{
+		mData = (const uint8_t *)buffer;
+		mEnd = mData + length;
+	}
+
+	bool operator()(rapidjson::Document &doc)
+	{
+		if (mEnd - mData < 5 || memcmp(mData, BinaryMagic, 4) || mData[4] != BinaryVersion) return false;
+		mData += 5;
+		return ReadValue(doc);
+	}
+};
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FReader::FReader(const char *buffer, size_t length)
+{
+	if (length >= 4 && !memcmp(buffer, BinaryMagic, 4))
+	{
+		mBinary.Resize((unsigned)length);
+		memcpy(mBinary.Data(), buffer, length);
+		FBinaryReader reader(mBinary.Data(), length);
+		mDoc.Populate(reader);
+	}
+	else
+	{
+		mDoc.Parse(buffer, length);
+	}
+	mObjects.Push(FJSONObject(&mDoc));
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+bool FSerializer::OpenWriter(bool pretty, bool binary)
 {
 	if (w != nullptr || r != nullptr) return false;
 
 	mErrors = 0;
-	w = new FWriter(pretty);
+	w = new FWriter(pretty, binary);
 	BeginObject(nullptr);
 	return true;
 }
@@ -705,11 +1030,13 @@ const char *FSerializer::GetOutput(unsigned *len)
 	if (isReading()) return nullptr;
 	WriteObjects();
 	EndObject();
+	size_t size;
+	const char *output = w->GetOutput(&size);
 	if (len != nullptr)
 	{
-		*len = (unsigned)w->mOutString.GetSize();
+		*len = (unsigned)size;
 	}
-	return w->mOutString.GetString();
+	return output;
 }
 
 //==========================================================================
@@ -719,21 +1046,55 @@ const char *FSerializer::GetOutput(unsigned *len)
 //==========================================================================
 
 FCompressedBuffer FSerializer::GetCompressedOutput()
+{
+	FCompressedBuffer buff = GetStoredOutput();
+	CompressBuffer(buff);
+	return buff;
+}
+
+//==========================================================================
+//
+// Returns a copy of the output without compressing it, so that the
+// compression can be left to CompressBuffer on another thread.
+//
+//==========================================================================
+
+FCompressedBuffer FSerializer::GetStoredOutput()
 {
 	if (isReading()) return{ 0,0,0,0,0,nullptr };
 	FCompressedBuffer buff;
 	WriteObjects();
 	EndObject();
-	buff.mSize = (unsigned)w->mOutString.GetSize();
+	size_t size;
+	const char *output = w->GetOutput(&size);
+	buff.mSize = (unsigned)size;
+	buff.mCompressedSize = buff.mSize;
+	buff.mMethod = METHOD_STORED;
 	buff.mZipFlags = 0;
-	buff.mCRC32 = crc32(0, (const Bytef*)w->mOutString.GetString(), buff.mSize);
+	buff.mCRC32 = crc32(0, (const Bytef*)output, buff.mSize);
+	buff.mBuffer = new char[buff.mSize + 1];
+	memcpy(buff.mBuffer, output, buff.mSize);
+	buff.mBuffer[buff.mSize] = 0;
+	return buff;
+}
+
+//==========================================================================
+//
+// Deflates a stored buffer in place. If that fails it remains stored.
+// This does not depend on any global state and may run on any thread.
+//
+//==========================================================================
+
+void CompressBuffer(FCompressedBuffer &buff)
+{
+	if (buff.mMethod != METHOD_STORED || buff.mBuffer == nullptr) return;
 
 	uint8_t *compressbuf = new uint8_t[buff.mSize+1];
 
 	z_stream stream;
 	int err;
 
-	stream.next_in = (Bytef *)w->mOutString.GetString();
+	stream.next_in = (Bytef *)buff.mBuffer;
 	stream.avail_in = buff.mSize;
 	stream.next_out = (Bytef*)compressbuf;
 	stream.avail_out = buff.mSize;
@@ -745,32 +1106,28 @@ FCompressedBuffer FSerializer::GetCompressedOutput()
 	err = deflateInit2(&stream, 8, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
 	if (err != Z_OK)
 	{
-		goto error;
+		delete[] compressbuf;
+		return;
 	}
 
 	err = deflate(&stream, Z_FINISH);
 	if (err != Z_STREAM_END) 
 	{
 		deflateEnd(&stream);
-		goto error;
+		delete[] compressbuf;
+		return;
 	}
-	buff.mCompressedSize = stream.total_out;
 
 	err = deflateEnd(&stream);
 	if (err == Z_OK)
 	{
+		delete[] buff.mBuffer;
+		buff.mCompressedSize = stream.total_out;
 		buff.mBuffer = new char[buff.mCompressedSize];
 		buff.mMethod = METHOD_DEFLATE;
 		memcpy(buff.mBuffer, compressbuf, buff.mCompressedSize);
-		delete[] compressbuf;
-		return buff;
 	}
-
-error:
-	memcpy(compressbuf, w->mOutString.GetString(), buff.mSize + 1);
-	buff.mCompressedSize = buff.mSize;
-	buff.mMethod = METHOD_STORED;
-	return buff;
+	delete[] compressbuf;
 }
 
 //==========================================================================
@@ -78,7 +78,7 @@ public:
 		Close();
 	}
 	void SetUniqueSoundNames() { soundNamesAreUnique = true; }
-	bool OpenWriter(bool pretty = true);
+	bool OpenWriter(bool pretty = true, bool binary = false);
 	bool OpenReader(const char *buffer, size_t length);
 	bool OpenReader(FCompressedBuffer *input);
 	void Close();
@@ -91,6 +91,7 @@ public:
 	const char *GetKey();
 	const char *GetOutput(unsigned *len = nullptr);
 	FCompressedBuffer GetCompressedOutput();
+	FCompressedBuffer GetStoredOutput();
 	// The sprite serializer is a special case because it is needed by the VM to handle its 'spriteid' type.
 	virtual FSerializer &Sprite(const char *key, int32_t &spritenum, int32_t *def);
 	// This is only needed by the type system.
@@ -214,6 +215,8 @@ public:
 	int mObjectErrors = 0;
 };
 
+void CompressBuffer(FCompressedBuffer &buff);
+
 FSerializer& Serialize(FSerializer& arc, const char* key, char& value, char* defval);
 
 FSerializer &Serialize(FSerializer &arc, const char *key, bool &value, bool *defval);
@@ -24,6 +24,161 @@ struct FJSONObject
 	}
 };
 
+//==========================================================================
+//
+// Binary encoding of the same data as the JSON output. It gets read back
+// into the same document so that none of the readers need to care, but
+// neither numbers nor strings need to be formatted and parsed.
+//
+// Object members start with a varint: 0 ends the object, 1 is followed by
+// a new key which gets the next index, everything else refers to key
+// index n-2. Arrays that only contain numbers of one type are stored
+// without the per-element type tags.
+//
+//==========================================================================
+
+enum EBinaryTag : uint8_t
+{
+	BT_End,			// ends an array
+	BT_Null,
+	BT_False,
+	BT_True,
+	BT_Int,			// zigzag varint
+	BT_Uint64,		// varint, only for values that do not fit into an int64
+	BT_Float,		// a double that is exactly representable as a float
+	BT_Double,
+	BT_String,		// varint length, characters, terminating 0
+	BT_Object,
+	BT_Array,
+	BT_IntArray,	// varint count, followed by the values without tags
+	BT_FloatArray,
+	BT_DoubleArray,
+};
+
+// Keys are matched by their exact spelling. The map points into mKeys, whose
+// string data stays put when the array grows.
+struct FBinaryKeyHashTraits
+{
+	hash_t Hash(const char *key) { return (hash_t)SuperFastHash(key, strlen(key)); }
+	int Compare(const char *left, const char *right) { return strcmp(left, right); }
+};
+
+struct FBinaryWriter
+{
+	struct Container
+	{
+		unsigned Start;		// position of the BT_Array tag
+		unsigned Count;
+		unsigned Floats;
+		uint8_t Kind;		// type of all elements, BT_End if they are mixed.
+	};
+
+	TArray<uint8_t> mOutput;
+	TArray<uint8_t> mPacked;
+	TArray<Container> mContainers;
+	TArray<FString> mKeys;
+	TMap<const char *, unsigned, FBinaryKeyHashTraits> mKeyMap;
+
+	FBinaryWriter();
+
+	void Byte(uint8_t b)
+	{
+		mOutput.Push(b);
+	}
+
+	void Varint(uint64_t v)
+	{
+		while (v >= 0x80)
+		{
+			mOutput.Push(uint8_t(v | 0x80));
+			v >>= 7;
+		}
+		mOutput.Push(uint8_t(v));
+	}
+
+	void Bytes(const void *data, size_t length)
+	{
+		if (length == 0) return;
+		auto pos = mOutput.Reserve(length);
+		memcpy(&mOutput[pos], data, length);
+	}
+
+	void BeginValue(uint8_t kind)
+	{
+		if (mContainers.Size() == 0) return;
+		auto &c = mContainers.Last();
+		if (c.Count++ == 0) c.Kind = kind;
+		else if ((c.Kind == BT_Float && kind == BT_Double) || (c.Kind == BT_Double && kind == BT_Float)) c.Kind = BT_Double;
+		else if (c.Kind != kind) c.Kind = BT_End;
+		if (kind == BT_Float) c.Floats++;
+	}
+
+	void StartObject()
+	{
+		BeginValue(BT_End);
+		Byte(BT_Object);
+		mContainers.Push({ mOutput.Size() - 1, 0, 0, BT_End });
+	}
+
+	void EndObject()
+	{
+		mContainers.Pop();
+		Varint(0);
+	}
+
+	void StartArray()
+	{
+		BeginValue(BT_End);
+		Byte(BT_Array);
+		mContainers.Push({ mOutput.Size() - 1, 0, 0, BT_End });
+	}
+
+	void EndArray();
+	void Key(const char *k);
+
+	void Null()
+	{
+		BeginValue(BT_End);
+		Byte(BT_Null);
+	}
+
+	void String(const char *k)
+	{
+		BeginValue(BT_End);
+		Byte(BT_String);
+		size_t len = strlen(k);
+		Varint(len);
+		Bytes(k, len + 1);
+	}
+
+	void Bool(bool k)
+	{
+		BeginValue(BT_End);
+		Byte(k ? BT_True : BT_False);
+	}
+
+	void Int64(int64_t k)
+	{
+		BeginValue(BT_Int);
+		Byte(BT_Int);
+		Varint((uint64_t(k) << 1) ^ uint64_t(k >> 63));
+	}
+
+	void Uint64(uint64_t k)
+	{
+		if (k <= (uint64_t)INT64_MAX)
+		{
+			Int64((int64_t)k);
+			return;
+		}
+		BeginValue(BT_End);
+		Byte(BT_Uint64);
+		Varint(k);
+	}
+
+	void Double(double k);
+};
+
 //==========================================================================
 //
 // some wrapper stuff to keep the RapidJSON dependencies out of the global headers.
@@ -38,21 +193,27 @@ struct FWriter
 
 	Writer *mWriter1;
 	PrettyWriter *mWriter2;
+	FBinaryWriter *mWriter3;
 	TArray<bool> mInObject;
 	rapidjson::StringBuffer mOutString;
 	TArray<DObject *> mDObjects;
 	TMap<DObject *, int> mObjectMap;
 	
-	FWriter(bool pretty)
+	FWriter(bool pretty, bool binary)
 	{
-		if (!pretty)
+		mWriter1 = nullptr;
+		mWriter2 = nullptr;
+		mWriter3 = nullptr;
+		if (binary)
+		{
+			mWriter3 = new FBinaryWriter;
+		}
+		else if (!pretty)
 		{
 			mWriter1 = new Writer(mOutString);
-			mWriter2 = nullptr;
 		}
 		else
 		{
-			mWriter1 = nullptr;
 			mWriter2 = new PrettyWriter(mOutString);
 		}
 	}
@@ -61,6 +222,18 @@ struct FWriter
 	{
 		if (mWriter1) delete mWriter1;
 		if (mWriter2) delete mWriter2;
+		if (mWriter3) delete mWriter3;
+	}
+
+	const char *GetOutput(size_t *size)
+	{
+		if (mWriter3)
+		{
+			*size = mWriter3->mOutput.Size();
+			return (const char *)mWriter3->mOutput.Data();
+		}
+		*size = mOutString.GetSize();
+		return mOutString.GetString();
 	}
 
 
@@ -73,36 +246,42 @@ struct FWriter
 	{
 		if (mWriter1) mWriter1->StartObject();
 		else if (mWriter2) mWriter2->StartObject();
+		else if (mWriter3) mWriter3->StartObject();
 	}
 
 	void EndObject()
 	{
 		if (mWriter1) mWriter1->EndObject();
 		else if (mWriter2) mWriter2->EndObject();
+		else if (mWriter3) mWriter3->EndObject();
 	}
 
 	void StartArray()
 	{
 		if (mWriter1) mWriter1->StartArray();
 		else if (mWriter2) mWriter2->StartArray();
+		else if (mWriter3) mWriter3->StartArray();
 	}
 
 	void EndArray()
 	{
 		if (mWriter1) mWriter1->EndArray();
 		else if (mWriter2) mWriter2->EndArray();
+		else if (mWriter3) mWriter3->EndArray();
 	}
 
 	void Key(const char *k)
 	{
 		if (mWriter1) mWriter1->Key(k);
 		else if (mWriter2) mWriter2->Key(k);
+		else if (mWriter3) mWriter3->Key(k);
 	}
 
 	void Null()
 	{
 		if (mWriter1) mWriter1->Null();
 		else if (mWriter2) mWriter2->Null();
+		else if (mWriter3) mWriter3->Null();
 	}
 
 	void StringU(const char *k, bool encode)
@@ -110,6 +289,7 @@ struct FWriter
 		if (encode) k = StringToUnicode(k);
 		if (mWriter1) mWriter1->String(k);
 		else if (mWriter2) mWriter2->String(k);
+		else if (mWriter3) mWriter3->String(k);
 	}
 
 	void String(const char *k)
@@ -117,6 +297,7 @@ struct FWriter
 		k = StringToUnicode(k);
 		if (mWriter1) mWriter1->String(k);
 		else if (mWriter2) mWriter2->String(k);
+		else if (mWriter3) mWriter3->String(k);
 	}
 
 	void String(const char *k, int size)
@@ -124,36 +305,42 @@ struct FWriter
 		k = StringToUnicode(k, size);
 		if (mWriter1) mWriter1->String(k);
 		else if (mWriter2) mWriter2->String(k);
+		else if (mWriter3) mWriter3->String(k);
 	}
 
 	void Bool(bool k)
 	{
 		if (mWriter1) mWriter1->Bool(k);
 		else if (mWriter2) mWriter2->Bool(k);
+		else if (mWriter3) mWriter3->Bool(k);
 	}
 
 	void Int(int32_t k)
 	{
 		if (mWriter1) mWriter1->Int(k);
 		else if (mWriter2) mWriter2->Int(k);
+		else if (mWriter3) mWriter3->Int64(k);
 	}
 
 	void Int64(int64_t k)
 	{
 		if (mWriter1) mWriter1->Int64(k);
 		else if (mWriter2) mWriter2->Int64(k);
+		else if (mWriter3) mWriter3->Int64(k);
 	}
 
 	void Uint(uint32_t k)
 	{
 		if (mWriter1) mWriter1->Uint(k);
 		else if (mWriter2) mWriter2->Uint(k);
+		else if (mWriter3) mWriter3->Uint64(k);
 	}
 
 	void Uint64(int64_t k)
 	{
 		if (mWriter1) mWriter1->Uint64(k);
 		else if (mWriter2) mWriter2->Uint64(k);
+		else if (mWriter3) mWriter3->Uint64(k);
 	}
 
 	void Double(double k)
@@ -166,6 +353,10 @@ struct FWriter
 		{
 			mWriter2->Double(k);
 		}
+		else if (mWriter3)
+		{
+			mWriter3->Double(k);
+		}
 	}
 
 };
@@ -179,16 +370,13 @@ struct FWriter
 struct FReader
 {
 	TArray<FJSONObject> mObjects;
+	TArray<char> mBinary;	// the document references the strings in here.
 	rapidjson::Document mDoc;
 	TArray<DObject *> mDObjects;
 	rapidjson::Value *mKeyValue = nullptr;
 	bool mObjectsRead = false;
 
-	FReader(const char *buffer, size_t length)
-	{
-		mDoc.Parse(buffer, length);
-		mObjects.Push(FJSONObject(&mDoc));
-	}
+	FReader(const char *buffer, size_t length);
 
 	rapidjson::Value *FindKey(const char *key)
 	{
@@ -55,6 +55,7 @@ struct FDirectoryLump : public FResourceLump
 	int FillCache() override;
 
 	FString mFullPath;
+	FileReader mMapped;	// keeps large files' mappings alive while the cache points into them
 };
 
 
@@ -249,6 +250,14 @@ FileReader FDirectoryLump::NewReader()
 
 int FDirectoryLump::FillCache()
 {
+	// Large files are mapped and used in place. Small ones aren't worth a mapping of their own.
+	if (LumpSize >= 65536 && (mMapped.isOpen() || mMapped.OpenMapped(mFullPath)) && mMapped.GetLength() == LumpSize)
+	{
+		Cache = const_cast<char*>(mMapped.GetBuffer());
+		RefCount = -1;
+		return -1;
+	}
+
 	FileReader fr;
 	Cache = new char[LumpSize];
 	if (!fr.OpenFile(mFullPath))
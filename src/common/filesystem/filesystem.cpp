@@ -147,6 +147,11 @@ static void PrintLastError ();
 
 FileSystem fileSystem;
 
+// PRIVATE DATA DEFINITIONS ------------------------------------------------
+
+static thread_local int ThreadLump = -1;
+static thread_local const TArray<uint8_t> *ThreadLumpData;
+
 // CODE --------------------------------------------------------------------
 
 FileSystem::FileSystem()
@@ -303,7 +308,8 @@ void FileSystem::AddFile (const char *filename, FileReader *filer, bool quiet, L
 
 		if (!isdir)
 		{
-			if (!filereader.OpenFile(filename))
+			// Prefer a memory mapping so that uncompressed lumps can be used in place.
+			if (!filereader.OpenMapped(filename) && !filereader.OpenFile(filename))
 			{ // Didn't find file
 				if (!quiet)
 				{
@@ -1350,9 +1356,30 @@ void FileSystem::ReadFile (int lump, void *dest)
 
 FileData FileSystem::ReadFile (int lump)
 {
+	if (lump == ThreadLump)
+	{
+		return FileData(FString((const char*)ThreadLumpData->Data(), ThreadLumpData->Size()));
+	}
+	assert(ThreadLumpData == nullptr);
 	return FileData(FString(ELumpNum(lump)));
 }
 
+//==========================================================================
+//
+// SetThreadLump
+//
+// The file readers are shared and not thread safe. Code that runs on a
+// worker thread must have its lump read on the main thread and can then
+// access it through the regular interface.
+//
+//==========================================================================
+
+void FileSystem::SetThreadLump(int lump, const TArray<uint8_t> *data)
+{
+	ThreadLump = data != nullptr ? lump : -1;
+	ThreadLumpData = data;
+}
+
 //==========================================================================
 //
 // OpenFileReader
@@ -1364,6 +1391,14 @@ FileData FileSystem::ReadFile (int lump)
 
 FileReader FileSystem::OpenFileReader(int lump)
 {
+	if (lump == ThreadLump)
+	{
+		FileReader rdr;
+		rdr.OpenMemory(ThreadLumpData->Data(), ThreadLumpData->Size());
+		return rdr;
+	}
+	assert(ThreadLumpData == nullptr);
+
 	if ((unsigned)lump >= (unsigned)FileInfo.Size())
 	{
 		I_Error("OpenFileReader: %u >= NumEntries", lump);
@@ -144,6 +144,10 @@ public:
 	FileReader ReopenFileReader(int lump, bool alwayscache = false);		// opens an independent reader.
 	FileReader OpenFileReader(const char* name);
 
+	// Makes OpenFileReader and ReadFile on the calling thread serve 'lump' from 'data'.
+	// This allows worker threads to process a lump that was read on the main thread.
+	static void SetThreadLump(int lump, const TArray<uint8_t> *data);
+
 	int FindLump (const char *name, int *lastlump, bool anyns=false);		// [RH] Find lumps with duplication
 	int FindLumpMulti (const char **names, int *lastlump, bool anyns = false, int *nameindex = NULL); // same with multiple possible names
 	int FindLumpFullName(const char* name, int* lastlump, bool noext = false);
@@ -211,6 +211,143 @@ CCMD (dumpclasses)
 	Printf ("%d classes shown, %d omitted\n", shown, omitted);
 }
 
+//==========================================================================
+//
+// CCMD objectpools
+//
+// Lists the classes with the most memory in their object pools.
+//
+//==========================================================================
+
+CCMD (objectpools)
+{
+	TArray<PClass *> pooled;
+	size_t used = 0, total = 0;
+
+	for (auto cls : PClass::AllClasses)
+	{
+		if (cls->ObjectPool != nullptr)
+		{
+			pooled.Push(cls);
+			used += cls->ObjectPool->UsedSlots() * cls->ObjectPool->GetSlotSize();
+			total += (cls->ObjectPool->UsedSlots() + cls->ObjectPool->FreeSlots()) * cls->ObjectPool->GetSlotSize();
+		}
+	}
+	std::sort(pooled.begin(), pooled.end(), [](PClass *a, PClass *b)
+	{
+		auto pa = a->ObjectPool, pb = b->ObjectPool;
+		return (pa->UsedSlots() + pa->FreeSlots()) * pa->GetSlotSize() > (pb->UsedSlots() + pb->FreeSlots()) * pb->GetSlotSize();
+	});
+
+	unsigned count = argv.argc() > 1 ? (unsigned)atoi(argv[1]) : 20;
+	for (unsigned i = 0; i < pooled.Size() && i < count; i++)
+	{
+		auto pool = pooled[i]->ObjectPool;
+		Printf("%-32s %6u used %6u free %5zu bytes each\n", pooled[i]->TypeName.GetChars(), pool->UsedSlots(), pool->FreeSlots(), pool->GetSlotSize());
+	}
+	Printf("%u classes pooled, %zuK of %zuK in use\n", pooled.Size(), (used + 1023) >> 10, (total + 1023) >> 10);
+}
+
+//==========================================================================
+//
+// DObject :: AllocObject
+//
+// Pooled objects are counted by their slot size, so that the GC gets the
+// same idea of how much is being allocated as it would from the heap.
+// The arena blocks themselves are never counted, neither when they are
+// allocated here nor when the arena is deleted in DeleteObjectPool.
+//
+//==========================================================================
+
+struct alignas(16) FObjectHeader
+{
+	FSlotArena *Pool;		// nullptr for objects on the heap
+};
+static_assert(sizeof(FObjectHeader) == DObject::AllocHeaderSize, "DObject::AllocHeaderSize is wrong");
+
+static void DeleteObjectPool(FSlotArena *pool)
+{
+	size_t alloc = GC::AllocBytes;
+	delete pool;
+	GC::AllocBytes = alloc;
+}
+
+void *DObject::AllocObject(FSlotArena *pool, size_t len)
+{
+	FObjectHeader *header;
+
+	if (pool != nullptr && len + sizeof(FObjectHeader) > pool->GetSlotSize())
+	{
+		pool = nullptr;		// the class has grown since its pool was set up.
+	}
+	if (pool != nullptr)
+	{
+		size_t alloc = GC::AllocBytes;
+		header = (FObjectHeader *)pool->Alloc();
+		GC::AllocBytes = alloc + pool->GetSlotSize();	// new arena blocks are not counted, only the slots in use
+	}
+	else
+	{
+		header = (FObjectHeader *)M_Malloc(len + sizeof(FObjectHeader));
+	}
+	header->Pool = pool;
+	return header + 1;
+}
+
+//==========================================================================
+//
+// DObject :: FreeObject
+//
+//==========================================================================
+
+void DObject::FreeObject(void *mem)
+{
+	if (mem == nullptr)
+	{
+		return;
+	}
+	auto header = (FObjectHeader *)mem - 1;
+	auto pool = header->Pool;
+	if (pool != nullptr)
+	{
+		GC::AllocBytes -= pool->GetSlotSize();
+		pool->Free(header);
+		if (pool->Orphaned && pool->UsedSlots() == 0)
+		{
+			DeleteObjectPool(pool);
+		}
+	}
+	else
+	{
+		M_Free(header);
+	}
+}
+
+//==========================================================================
+//
+// DObject :: ReleaseObjectPool
+//
+// Called when a class goes away. Instances that outlived it still need
+// their arena, so in that case it is deleted along with the last of them.
+//
+//==========================================================================
+
+void DObject::ReleaseObjectPool(FSlotArena *pool)
+{
+	if (pool == nullptr)
+	{
+		return;
+	}
+	if (pool->UsedSlots() == 0)
+	{
+		DeleteObjectPool(pool);
+	}
+	else
+	{
+		pool->Orphaned = true;
+	}
+}
+
 //==========================================================================
 //
 //
@@ -47,6 +47,7 @@ class PClass;
 class PType;
 class FSerializer;
 class FSoundID;
+class FSlotArena;
 
 class   DObject;
 /*
@@ -267,20 +268,28 @@ private:
 
 	void *operator new(size_t len, nonew&)
 	{
-		return M_Calloc(len, 1);
+		return memset(AllocObject(nullptr, len), 0, len);
 	}
 public:
 
 	void operator delete (void *mem, nonew&)
 	{
-		M_Free(mem);
+		FreeObject(mem);
 	}
 
 	void operator delete (void *mem)
 	{
-		M_Free(mem);
+		FreeObject(mem);
 	}
 
+	// All object memory goes through these, either from the heap or from
+	// a class's slot arena. FreeObject knows which one from a small header
+	// in front of the object.
+	static void *AllocObject(FSlotArena *pool, size_t len);
+	static void FreeObject(void *mem);
+	static void ReleaseObjectPool(FSlotArena *pool);
+	enum { AllocHeaderSize = 16 };
+
 	// GC fiddling
 
 	// An object is white if either white bit is set.
@@ -345,7 +354,7 @@ protected:
 
 	void operator delete (void *mem, EInPlace *)
 	{
-		M_Free (mem);
+		FreeObject (mem);
 	}
 
 	template<typename T, typename... Args>
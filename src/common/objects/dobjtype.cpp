@@ -69,6 +69,8 @@ TArray<VMFunction**> PClass::FunctionPtrList;
 bool PClass::bShutdown;
 bool PClass::bVMOperational;
 
+CVAR(Bool, gc_objectpools, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
 // Originally this was just a bogus pointer, but with the VM performing a read barrier on every object pointer write
 // that does not work anymore. WP_NOCHANGE needs to point to a vaild object to work as intended.
 // This Object does not need to be garbage collected, though, but it needs to provide the proper structure so that the
@@ -290,6 +292,8 @@ PClass::PClass()
 
 PClass::~PClass()
 {
+	DObject::ReleaseObjectPool(ObjectPool);
+	ObjectPool = nullptr;
 	if (Defaults != nullptr)
 	{
 		M_Free(Defaults);
@@ -419,7 +423,13 @@ PClass *PClass::FindClass (FName zaname)
 
 DObject *PClass::CreateNew()
 {
-	uint8_t *mem = (uint8_t *)M_Malloc (Size);
+	// Each class gets its own slot arena so that its instances end up next to each
+	// other and freed ones are recycled instead of going back to the system.
+	if (ObjectPool == nullptr && gc_objectpools)
+	{
+		ObjectPool = new FSlotArena(Size + DObject::AllocHeaderSize);
+	}
+	uint8_t *mem = (uint8_t *)DObject::AllocObject(gc_objectpools ? ObjectPool : nullptr, Size);
 	assert (mem != nullptr);
 
 	// Set this object's defaults before constructing it.
@@ -430,7 +440,7 @@ DObject *PClass::CreateNew()
 
 	if (ConstructNative == nullptr || bAbstract)
 	{
-		M_Free(mem);
+		DObject::FreeObject(mem);
 		I_Error("Attempt to instantiate abstract class %s.", TypeName.GetChars());
 	}
 	ConstructNative (mem);
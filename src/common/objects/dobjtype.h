@@ -71,6 +71,7 @@ public:
 	TArray<FTypeAndOffset> SpecialInits;
 	TArray<PField *> Fields;
 	PClassType			*VMType = nullptr;
+	FSlotArena			*ObjectPool = nullptr;	// memory for the instances created by CreateNew
 
 	void (*ConstructNative)(void *);
 
@@ -51,10 +51,51 @@ glcycle_t Dirty;
 glcycle_t drawcalls;
 glcycle_t twoD, Flush3D;
 glcycle_t MTWait, WTTotal;
-int vertexcount, flatvertices, flatprimitives;
+thread_local int vertexcount, flatvertices, flatprimitives;
 
-int rendered_lines,rendered_flats,rendered_sprites,render_vertexsplit,render_texsplit,rendered_decals, rendered_portals, rendered_commandbuffers;
-int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
+thread_local int rendered_lines,rendered_flats,rendered_sprites,render_vertexsplit,render_texsplit,rendered_decals, rendered_portals;
+int rendered_commandbuffers;
+thread_local int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
+
+//-----------------------------------------------------------------------------
+//
+// Transfers the counters between threads. Taking the addresses has to be
+// done by the thread whose counters are wanted.
+//
+//-----------------------------------------------------------------------------
+
+static void GetThreadCounters(int **counters)
+{
+	int *list[] =
+	{
+		&vertexcount, &flatvertices, &flatprimitives,
+		&rendered_lines, &rendered_flats, &rendered_sprites, &render_vertexsplit, &render_texsplit, &rendered_decals, &rendered_portals,
+		&iter_dlightf, &iter_dlight, &draw_dlight, &draw_dlightf
+	};
+	static_assert(sizeof(list) / sizeof(list[0]) == FRenderCounts::NumCounters, "FRenderCounts does not match the counter list");
+	memcpy(counters, list, sizeof(list));
+}
+
+void FRenderCounts::TakeFromThread()
+{
+	int *counters[NumCounters];
+	GetThreadCounters(counters);
+	for (int i = 0; i < NumCounters; i++)
+	{
+		Counts[i] = *counters[i];
+		*counters[i] = 0;
+	}
+}
+
+void FRenderCounts::AddToThread() const
+{
+	int *counters[NumCounters];
+	GetThreadCounters(counters);
+	for (int i = 0; i < NumCounters; i++)
+	{
+		*counters[i] += Counts[i];
+	}
+}
 
 void ResetProfilingData()
 {
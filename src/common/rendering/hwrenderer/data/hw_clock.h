@@ -14,11 +14,22 @@ extern glcycle_t Dirty;
 extern glcycle_t drawcalls, twoD, Flush3D;
 extern glcycle_t MTWait, WTTotal;
 
-extern int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
-extern int rendered_lines,rendered_flats,rendered_sprites,rendered_decals,render_vertexsplit,render_texsplit;
-extern int rendered_portals;
+// These are per thread so that the BSP workers can count without synchronization.
+// Their counts get added to the main thread's once they are done.
+extern thread_local int iter_dlightf, iter_dlight, draw_dlight, draw_dlightf;
+extern thread_local int rendered_lines,rendered_flats,rendered_sprites,rendered_decals,render_vertexsplit,render_texsplit;
+extern thread_local int rendered_portals;
 
-extern int vertexcount, flatvertices, flatprimitives;
+extern thread_local int vertexcount, flatvertices, flatprimitives;
+
+struct FRenderCounts
+{
+	enum { NumCounters = 14 };
+	int Counts[NumCounters];
+
+	void TakeFromThread();		// moves the calling thread's counts in here
+	void AddToThread() const;	// adds them to the calling thread's counts
+};
 
 void ResetProfilingData();
 void CheckBench();
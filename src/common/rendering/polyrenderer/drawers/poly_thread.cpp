@@ -28,11 +28,14 @@
 #include "model.h"
 #include "poly_thread.h"
 #include "screen_triangle.h"
+#include "c_cvars.h"
 
 #ifndef NO_SSE
 #include <immintrin.h>
 #endif
 
+EXTERN_CVAR(Bool, r_poly_tiles)
+
 PolyTriangleThreadData::PolyTriangleThreadData(int32_t core, int32_t num_cores, int32_t numa_node, int32_t num_numa_nodes, int numa_start_y, int numa_end_y)
 	: core(core), num_cores(num_cores), numa_node(numa_node), num_numa_nodes(num_numa_nodes), numa_start_y(numa_start_y), numa_end_y(numa_end_y)
 {
@@ -53,6 +56,18 @@ void PolyTriangleThreadData::ClearDepth(float value)
 		for (int x = 0; x < width; x++)
 			data[x] = value;
 		data += num_cores * width;
+
+		int y = skip + i * num_cores;
+		depthstencil->SetTileMaxValid(y, r_poly_tiles);
+		if (r_poly_tiles)
+		{
+			float *tilemax = depthstencil->TileMaxValues(0, y);
+			for (int x = 0; x < width; x += 8)
+			{
+				*tilemax = value;
+				tilemax += 8;
+			}
+		}
 	}
 }
 
@@ -82,18 +82,31 @@ private:
 class PolyDepthStencil
 {
 public:
-	PolyDepthStencil(int width, int height) : width(width), height(height), depthbuffer(width * height), stencilbuffer(width * height) { }
+	PolyDepthStencil(int width, int height) : width(width), height(height), depthbuffer(width * height), stencilbuffer(width * height), tilemax(TilesX() * ((height + 7) / 8) * 8), tilemaxvalid(height) { }
 
 	int Width() const { return width; }
 	int Height() const { return height; }
 	float *DepthValues() { return depthbuffer.data(); }
 	uint8_t *StencilValues() { return stencilbuffer.data(); }
 
+	// Largest depth value of each 8 pixel row segment, stored as 8 rows per 8x8 tile.
+	// Every depth write must update it, as the tile rasterizer uses it to reject whole tiles.
+	int TilesX() const { return (width + 7) / 8; }
+	float *TileMaxValues() { return tilemax.data(); }
+	float *TileMaxValues(int x, int y) { return tilemax.data() + ((y >> 3) * TilesX() + (x >> 3)) * 8 + (y & 7); }
+
+	// ClearDepth only keeps a row's tile max values when r_poly_tiles is on, so that the
+	// scanline path does not pay for them. Rows without them never reject tiles.
+	bool TileMaxValid(int y) const { return tilemaxvalid[y] != 0; }
+	void SetTileMaxValid(int y, bool valid) { tilemaxvalid[y] = valid; }
+
 private:
 	int width;
 	int height;
 	std::vector<float> depthbuffer;
 	std::vector<uint8_t> stencilbuffer;
+	std::vector<float> tilemax;
+	std::vector<uint8_t> tilemaxvalid;
 };
 
 struct PolyPushConstants
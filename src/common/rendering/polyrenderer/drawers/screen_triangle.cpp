@@ -25,12 +25,44 @@
 
 #include "filesystem.h"
 #include "v_video.h"
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "printf.h"
+#include "x86.h"
 #include "poly_triangle.h"
+#include "poly_thread.h"
 #include "screen_triangle.h"
 #include "screen_blend.h"
 #include "screen_scanline_setup.h"
 #include "screen_shader.h"
 #include <cmath>
+#include <chrono>
+#include <memory>
+
+#ifndef NO_SSE
+#include <immintrin.h>
+#endif
+
+// The tile path uses an exact top-left fill rule while the scanline path rounds its
+// edges, so the two must not be mixed within a frame or shared edges can get gaps or
+// double coverage. With r_poly_tiles on, every triangle goes through the tiles.
+CVAR(Bool, r_poly_tiles, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+static void UpdateTileMax(int y, int x0, int x1, PolyTriangleThreadData* thread)
+{
+	int width = thread->depthstencil->Width();
+	const float* line = thread->depthstencil->DepthValues() + (size_t)width * y;
+	float* tilemax = thread->depthstencil->TileMaxValues(x0, y);
+	for (int x = x0 & ~7; x < x1; x += 8)
+	{
+		int end = MIN(x + 8, width);
+		float value = line[x];
+		for (int i = x + 1; i < end; i++)
+			value = MAX(value, line[i]);
+		*tilemax = value;
+		tilemax += 8;
+	}
+}
 
 static void WriteDepth(int y, int x0, int x1, PolyTriangleThreadData* thread)
 {
@@ -51,6 +83,9 @@ static void WriteDepth(int y, int x0, int x1, PolyTriangleThreadData* thread)
 			line[x] = 65536.0f;
 		}
 	}
+
+	if (thread->depthstencil->TileMaxValid(y))
+		UpdateTileMax(y, x0, x1, thread);
 }
 
 static void WriteStencil(int y, int x0, int x1, PolyTriangleThreadData* thread)
@@ -200,6 +235,454 @@ static void SortVertices(const TriDrawTriangleArgs* args, ScreenTriVertex** sort
 		std::swap(sortedVertices[1], sortedVertices[2]);
 }
 
+//==========================================================================
+//
+// Tile rasterizer
+//
+// Walks the triangle in 8x8 tiles using edge functions in 28.4 fixed
+// point. Tiles outside an edge are skipped, tiles inside all edges need no
+// per pixel coverage, and with depth testing on, tiles where the triangle
+// is behind everything already drawn are rejected using the depth maxima
+// kept by PolyDepthStencil. The rest gets the coverage, depth and stencil
+// tests done 8 pixels at a time, and the passing runs go to DrawSpan.
+//
+//==========================================================================
+
+struct TileEdges
+{
+	int32_t Offsets[3][8];	// edge value steps for the pixels of a tile row
+	int32_t StepY[3];
+};
+
+struct TileRowTest
+{
+	const float* ZLine;
+	const float* WLine;
+	const uint8_t* SLine;
+	float DepthBias;
+	uint8_t StencilValue;
+	bool DepthTest;
+	bool StencilTest;
+	int Width;
+};
+
+struct TileKernels
+{
+	const char* Name;
+	void (*Coverage)(const TileEdges& edges, const int32_t* e, uint8_t* masks);
+	void (*TestRow)(uint8_t* masks, int tx0, int tx1, const TileRowTest& t);
+};
+
+static void TileCoverage_C(const TileEdges& edges, const int32_t* e, uint8_t* masks)
+{
+	for (int r = 0; r < 8; r++)
+	{
+		int32_t e0 = e[0] + edges.StepY[0] * r;
+		int32_t e1 = e[1] + edges.StepY[1] * r;
+		int32_t e2 = e[2] + edges.StepY[2] * r;
+		int mask = 0;
+		for (int c = 0; c < 8; c++)
+		{
+			int32_t inside = (e0 + edges.Offsets[0][c]) | (e1 + edges.Offsets[1][c]) | (e2 + edges.Offsets[2][c]);
+			mask |= (inside >= 0) << c;
+		}
+		masks[r] = mask;
+	}
+}
+
+static int TestPixels_C(int mask, int x, const TileRowTest& t)
+{
+	for (int c = 0; c < 8; c++)
+	{
+		if (!(mask & (1 << c)))
+			continue;
+		if ((t.DepthTest && !(t.ZLine[x + c] >= t.WLine[x + c] + t.DepthBias)) || (t.StencilTest && t.SLine[x + c] != t.StencilValue))
+			mask &= ~(1 << c);
+	}
+	return mask;
+}
+
+static void TestRow_C(uint8_t* masks, int tx0, int tx1, const TileRowTest& t)
+{
+	for (int tx = tx0; tx < tx1; tx++)
+	{
+		if (masks[tx - tx0])
+			masks[tx - tx0] = TestPixels_C(masks[tx - tx0], tx * 8, t);
+	}
+}
+
+static const TileKernels TileKernelsC = { "C", TileCoverage_C, TestRow_C };
+
+#ifndef NO_SSE
+
+static void TileCoverage_SSE2(const TileEdges& edges, const int32_t* e, uint8_t* masks)
+{
+	__m128i lo[3], hi[3], step[3];
+	for (int i = 0; i < 3; i++)
+	{
+		__m128i start = _mm_set1_epi32(e[i]);
+		lo[i] = _mm_add_epi32(start, _mm_loadu_si128((const __m128i*)edges.Offsets[i]));
+		hi[i] = _mm_add_epi32(start, _mm_loadu_si128((const __m128i*)(edges.Offsets[i] + 4)));
+		step[i] = _mm_set1_epi32(edges.StepY[i]);
+	}
+
+	for (int r = 0; r < 8; r++)
+	{
+		__m128i outsidelo = _mm_or_si128(_mm_or_si128(lo[0], lo[1]), lo[2]);
+		__m128i outsidehi = _mm_or_si128(_mm_or_si128(hi[0], hi[1]), hi[2]);
+		int outside = _mm_movemask_ps(_mm_castsi128_ps(outsidelo)) | (_mm_movemask_ps(_mm_castsi128_ps(outsidehi)) << 4);
+		masks[r] = ~outside & 0xff;
+
+		for (int i = 0; i < 3; i++)
+		{
+			lo[i] = _mm_add_epi32(lo[i], step[i]);
+			hi[i] = _mm_add_epi32(hi[i], step[i]);
+		}
+	}
+}
+
+static void TestRow_SSE2(uint8_t* masks, int tx0, int tx1, const TileRowTest& t)
+{
+	__m128 bias = _mm_set1_ps(t.DepthBias);
+	__m128i stencil = _mm_set1_epi8((char)t.StencilValue);
+	for (int tx = tx0; tx < tx1; tx++)
+	{
+		int mask = masks[tx - tx0];
+		int x = tx * 8;
+		if (mask == 0)
+			continue;
+
+		if (x + 8 > t.Width)
+		{
+			masks[tx - tx0] = TestPixels_C(mask, x, t);
+			continue;
+		}
+
+		if (t.DepthTest)
+		{
+			__m128 passlo = _mm_cmpge_ps(_mm_loadu_ps(t.ZLine + x), _mm_add_ps(_mm_loadu_ps(t.WLine + x), bias));
+			__m128 passhi = _mm_cmpge_ps(_mm_loadu_ps(t.ZLine + x + 4), _mm_add_ps(_mm_loadu_ps(t.WLine + x + 4), bias));
+			mask &= _mm_movemask_ps(passlo) | (_mm_movemask_ps(passhi) << 4);
+		}
+		if (t.StencilTest)
+		{
+			mask &= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i*)(t.SLine + x)), stencil));
+		}
+		masks[tx - tx0] = mask;
+	}
+}
+
+static const TileKernels TileKernelsSSE2 = { "SSE2", TileCoverage_SSE2, TestRow_SSE2 };
+
+AVX2_TARGET static void TileCoverage_AVX2(const TileEdges& edges, const int32_t* e, uint8_t* masks)
+{
+	__m256i e0 = _mm256_add_epi32(_mm256_set1_epi32(e[0]), _mm256_loadu_si256((const __m256i*)edges.Offsets[0]));
+	__m256i e1 = _mm256_add_epi32(_mm256_set1_epi32(e[1]), _mm256_loadu_si256((const __m256i*)edges.Offsets[1]));
+	__m256i e2 = _mm256_add_epi32(_mm256_set1_epi32(e[2]), _mm256_loadu_si256((const __m256i*)edges.Offsets[2]));
+	__m256i step0 = _mm256_set1_epi32(edges.StepY[0]);
+	__m256i step1 = _mm256_set1_epi32(edges.StepY[1]);
+	__m256i step2 = _mm256_set1_epi32(edges.StepY[2]);
+
+	for (int r = 0; r < 8; r++)
+	{
+		__m256i outside = _mm256_or_si256(_mm256_or_si256(e0, e1), e2);
+		masks[r] = ~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xff;
+		e0 = _mm256_add_epi32(e0, step0);
+		e1 = _mm256_add_epi32(e1, step1);
+		e2 = _mm256_add_epi32(e2, step2);
+	}
+}
+
+AVX2_TARGET static void TestRow_AVX2(uint8_t* masks, int tx0, int tx1, const TileRowTest& t)
+{
+	__m256 bias = _mm256_set1_ps(t.DepthBias);
+	__m128i stencil = _mm_set1_epi8((char)t.StencilValue);
+	for (int tx = tx0; tx < tx1; tx++)
+	{
+		int mask = masks[tx - tx0];
+		int x = tx * 8;
+		if (mask == 0)
+			continue;
+
+		if (x + 8 > t.Width)
+		{
+			masks[tx - tx0] = TestPixels_C(mask, x, t);
+			continue;
+		}
+
+		if (t.DepthTest)
+		{
+			__m256 pass = _mm256_cmp_ps(_mm256_loadu_ps(t.ZLine + x), _mm256_add_ps(_mm256_loadu_ps(t.WLine + x), bias), _CMP_GE_OQ);
+			mask &= _mm256_movemask_ps(pass);
+		}
+		if (t.StencilTest)
+		{
+			mask &= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i*)(t.SLine + x)), stencil));
+		}
+		masks[tx - tx0] = mask;
+	}
+}
+
+static const TileKernels TileKernelsAVX2 = { "AVX2", TileCoverage_AVX2, TestRow_AVX2 };
+
+#endif
+
+static const TileKernels* GetTileKernels()
+{
+#ifndef NO_SSE
+	if (CPU.bAVX2) return &TileKernelsAVX2;
+	return &TileKernelsSSE2;
+#else
+	return &TileKernelsC;
+#endif
+}
+
+static void DrawTileRow(int y, const uint8_t* masks, int tx0, int tx1, const TriDrawTriangleArgs* args, PolyTriangleThreadData* thread)
+{
+	int runstart = -1;
+	for (int tx = tx0; tx < tx1; tx++)
+	{
+		int mask = masks[tx - tx0];
+		int x = tx * 8;
+		if (mask == 0xff)
+		{
+			if (runstart < 0)
+				runstart = x;
+			continue;
+		}
+
+		for (int c = 0; c < 8; c++)
+		{
+			if (mask & (1 << c))
+			{
+				if (runstart < 0)
+					runstart = x + c;
+			}
+			else if (runstart >= 0)
+			{
+				DrawSpan(y, runstart, x + c, args, thread);
+				runstart = -1;
+			}
+		}
+	}
+	if (runstart >= 0)
+		DrawSpan(y, runstart, tx1 * 8, args, thread);
+}
+
+// The edge functions are evaluated per tile in 64 bit. Within a tile that an edge
+// crosses they fit in 32 bits, so the coverage kernels work on any triangle size.
+// Returns false only for vertices outside the fixed point range, which the clipping
+// in PolyTriangleThreadData::ClipEdge never produces.
+static bool DrawTiles(const TriDrawTriangleArgs* args, PolyTriangleThreadData* thread)
+{
+	const ScreenTriVertex* verts[3] = { args->v1, args->v2, args->v3 };
+
+	int64_t X[3], Y[3];
+	for (int i = 0; i < 3; i++)
+	{
+		if (!(std::fabs(verts[i]->x) < 32768.0f && std::fabs(verts[i]->y) < 32768.0f))
+			return false;
+		X[i] = (int64_t)std::lround(verts[i]->x * 16.0f);
+		Y[i] = (int64_t)std::lround(verts[i]->y * 16.0f);
+	}
+
+	// Make the edge functions positive inside
+	int64_t area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+	if (area == 0)
+		return true;
+	if (area < 0)
+	{
+		std::swap(X[1], X[2]);
+		std::swap(Y[1], Y[2]);
+	}
+
+	// Pixels that can have their center inside the triangle
+	int x0 = MAX(thread->clip.left, (int)((MIN(MIN(X[0], X[1]), X[2]) - 8) >> 4));
+	int x1 = MIN(thread->clip.right, (int)((MAX(MAX(X[0], X[1]), X[2]) - 8) >> 4) + 1);
+	int y0 = MAX(MAX(thread->clip.top, thread->numa_start_y), (int)((MIN(MIN(Y[0], Y[1]), Y[2]) - 8) >> 4));
+	int y1 = MIN(MIN(thread->clip.bottom, thread->numa_end_y), (int)((MAX(MAX(Y[0], Y[1]), Y[2]) - 8) >> 4) + 1);
+	if (x0 >= x1 || y0 >= y1)
+		return true;
+
+	int tx0 = x0 >> 3;
+	int tx1 = (x1 + 7) >> 3;
+	int ty0 = y0 >> 3;
+	int ty1 = (y1 + 7) >> 3;
+
+	TileEdges edges;
+	int64_t origin[3], stepX[3], stepY[3], maxOffset[3], minOffset[3];
+	for (int i = 0; i < 3; i++)
+	{
+		int a = i;
+		int b = (i + 1) % 3;
+		int64_t A = Y[a] - Y[b];
+		int64_t B = X[b] - X[a];
+		int64_t C = -(A * X[a] + B * Y[a]);
+
+		// Top-left fill rule: pixel centers exactly on an edge belong to the triangle only for top and left edges
+		if (!(A > 0 || (A == 0 && B > 0)))
+			C--;
+
+		stepX[i] = A * 16;
+		stepY[i] = B * 16;
+		origin[i] = A * (tx0 * 128 + 8) + B * (ty0 * 128 + 8) + C;
+		maxOffset[i] = MAX(stepX[i], (int64_t)0) * 7 + MAX(stepY[i], (int64_t)0) * 7;
+		minOffset[i] = MIN(stepX[i], (int64_t)0) * 7 + MIN(stepY[i], (int64_t)0) * 7;
+
+		for (int c = 0; c < 8; c++)
+			edges.Offsets[i][c] = (int32_t)(stepX[i] * c);
+		edges.StepY[i] = (int32_t)stepY[i];
+	}
+
+	const TileKernels* kernels = GetTileKernels();
+	PolyDepthStencil* depthstencil = thread->depthstencil;
+	int width = depthstencil->Width();
+
+	TileRowTest test;
+	test.WLine = thread->scanline.W;
+	test.DepthBias = thread->depthbias;
+	test.StencilValue = thread->StencilTestValue;
+	test.DepthTest = thread->DepthTest;
+	test.StencilTest = thread->StencilTest;
+	test.Width = width;
+
+	// 1/W at the center of pixel 0,0, as calculated by WriteW
+	float gradW_x = args->gradientX.W;
+	float gradW_y = args->gradientY.W;
+	float posW = args->v1->w + gradW_x * (0.5f - args->v1->x) + gradW_y * (0.5f - args->v1->y);
+
+	uint8_t coverage[8][MAXWIDTH / 8 + 1];
+	uint8_t tilemasks[8];
+	for (int ty = ty0; ty < ty1; ty++)
+	{
+		int rowmask = 0;
+		for (int r = 0; r < 8; r++)
+		{
+			int y = ty * 8 + r;
+			if (y >= y0 && y < y1 && !thread->line_skipped_by_thread(y))
+				rowmask |= 1 << r;
+		}
+		if (rowmask == 0)
+			continue;
+
+		// Rows whose tile max values were not kept up to date cannot be used for rejecting tiles
+		bool tilemaxvalid = true;
+		for (int r = 0; r < 8; r++)
+		{
+			if ((rowmask & (1 << r)) && !depthstencil->TileMaxValid(ty * 8 + r))
+				tilemaxvalid = false;
+		}
+
+		int rowstart[8], rowend[8];
+		for (int r = 0; r < 8; r++)
+		{
+			rowstart[r] = tx1;
+			rowend[r] = tx0;
+		}
+
+		for (int tx = tx0; tx < tx1; tx++)
+		{
+			int index = tx - tx0;
+			int64_t e[3];
+			bool outside = false, inside = true;
+			for (int i = 0; i < 3; i++)
+			{
+				e[i] = origin[i] + stepX[i] * (tx - tx0) * 8 + stepY[i] * (ty - ty0) * 8;
+				outside = outside || e[i] + maxOffset[i] < 0;
+				inside = inside && e[i] + minOffset[i] >= 0;
+			}
+
+			if (!outside && test.DepthTest && tilemaxvalid)
+			{
+				float corner = posW + gradW_x * (tx * 8) + gradW_y * (ty * 8);
+				float corners[4] = { corner, corner + gradW_x * 7, corner + gradW_y * 7, corner + gradW_x * 7 + gradW_y * 7 };
+				float lowest = MIN(MIN(corners[0], corners[1]), MIN(corners[2], corners[3]));
+				float highest = MAX(MAX(corners[0], corners[1]), MAX(corners[2], corners[3]));
+				if (lowest > 0.0f)
+				{
+					// Leave some room for the reciprocal approximation and the stepping in WriteW
+					float nearest = 0.999f / highest;
+					const float* tilemax = depthstencil->TileMaxValues(tx * 8, ty * 8);
+					float farthest = -FLT_MAX;
+					for (int r = 0; r < 8; r++)
+					{
+						if (rowmask & (1 << r))
+							farthest = MAX(farthest, tilemax[r]);
+					}
+					outside = farthest < nearest + test.DepthBias;
+				}
+			}
+
+			if (outside)
+			{
+				for (int r = 0; r < 8; r++)
+					coverage[r][index] = 0;
+				continue;
+			}
+
+			if (inside)
+			{
+				for (int r = 0; r < 8; r++)
+					tilemasks[r] = 0xff;
+			}
+			else
+			{
+				// Edges that cover the whole tile can be far too large for 32 bits. Clamping them to
+				// the smallest value that still covers it keeps all the sums in the kernels in range.
+				int32_t e32[3];
+				for (int i = 0; i < 3; i++)
+					e32[i] = (int32_t)MIN(e[i], -minOffset[i]);
+				kernels->Coverage(edges, e32, tilemasks);
+			}
+
+			int colmask = 0xff;
+			if (tx * 8 < x0)
+				colmask &= 0xff << (x0 - tx * 8);
+			if (tx * 8 + 8 > x1)
+				colmask &= 0xff >> (tx * 8 + 8 - x1);
+
+			for (int r = 0; r < 8; r++)
+			{
+				int mask = (rowmask & (1 << r)) ? tilemasks[r] & colmask : 0;
+				coverage[r][index] = mask;
+				if (mask)
+				{
+					rowstart[r] = MIN(rowstart[r], tx);
+					rowend[r] = tx + 1;
+				}
+			}
+		}
+
+		for (int r = 0; r < 8; r++)
+		{
+			if (rowstart[r] >= rowend[r])
+				continue;
+
+			int y = ty * 8 + r;
+			uint8_t* masks = coverage[r] + (rowstart[r] - tx0);
+
+			int first = masks[0];
+			int last = masks[rowend[r] - rowstart[r] - 1];
+			int xstart = rowstart[r] * 8;
+			int xend = rowend[r] * 8;
+			while (!(first & 1)) { first >>= 1; xstart++; }
+			while (!(last & 0x80)) { last <<= 1; xend--; }
+
+			WriteW(y, xstart, xend, args, thread);
+
+			if (test.DepthTest || test.StencilTest)
+			{
+				test.ZLine = depthstencil->DepthValues() + (size_t)width * y;
+				test.SLine = depthstencil->StencilValues() + (size_t)width * y;
+				kernels->TestRow(masks, rowstart[r], rowend[r], test);
+			}
+
+			DrawTileRow(y, masks, rowstart[r], rowend[r], args, thread);
+		}
+	}
+	return true;
+}
+
 void ScreenTriangle::Draw(const TriDrawTriangleArgs* args, PolyTriangleThreadData* thread)
 {
 	// Sort vertices by Y position
@@ -225,6 +708,9 @@ void ScreenTriangle::Draw(const TriDrawTriangleArgs* args, PolyTriangleThreadDat
 	SelectFragmentShader(thread);
 	SelectWriteColorFunc(thread);
 
+	if (r_poly_tiles && DrawTiles(args, thread))
+		return;
+
 	void(*testfunc)(int y, int x0, int x1, const TriDrawTriangleArgs * args, PolyTriangleThreadData * thread);
 
 	int opt = 0;
@@ -301,3 +787,137 @@ void(*ScreenTriangle::TestSpanOpts[])(int y, int x0, int x1, const TriDrawTriang
 	&StencilTestSpan,
 	&DepthStencilTestSpan
 };
+
+//==========================================================================
+//
+// CCMD bench_polytriangles
+//
+// Draws a canned 1920x1080 scene with the scanline and the tile rasterizer
+// and reports the time per frame: a few hundred overlapping walls at random
+// depths and a few thousand small triangles, in random order with depth
+// testing. The two use slightly different fill rules, so a small number of
+// edge pixels are expected to differ.
+//
+//==========================================================================
+
+CCMD(bench_polytriangles)
+{
+	int frames = argv.argc() > 1 ? clamp(atoi(argv[1]), 1, 10000) : 20;
+
+	const int width = 1920, height = 1080;
+	TArray<uint32_t> dest(width * height, true);
+	PolyDepthStencil depthstencil(width, height);
+	auto thread = std::make_unique<PolyTriangleThreadData>(0, 1, 0, 1, 0, height);
+
+	StreamData streamdata;
+	memset(&streamdata, 0, sizeof(StreamData));
+	streamdata.uObjectColor = 0xffffffff;
+	PolyPushConstants constants;
+	memset(&constants, 0, sizeof(PolyPushConstants));
+	constants.uFogEnabled = -3;
+	constants.uLightIndex = -1;
+
+	thread->SetViewport(0, 0, width, height, (uint8_t*)dest.Data(), width, height, width, true, &depthstencil, true);
+	thread->SetScissor(0, 0, width, height);
+	thread->SetDepthFunc(DF_LEqual);
+	thread->SetDepthMask(true);
+	thread->SetDepthRange(0.0f, 1.0f);
+	thread->EnableStencil(false);
+	thread->SetColorMask(true, true, true, true);
+	thread->SetRenderStyle(LegacyRenderStyles[STYLE_Normal]);
+	thread->SetShader(EFF_NONE, SHADER_NoTexture, false, false);
+	thread->PushStreamData(streamdata, constants);
+
+	uint32_t seed = 1;
+	auto random = [&](float low, float high)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return low + (high - low) * ((seed >> 8) * (1.0f / 16777216.0f));
+	};
+
+	TArray<ScreenTriVertex> vertices;
+	auto addvertex = [&](float x, float y, float depth, float r, float g, float b)
+	{
+		ScreenTriVertex v;
+		memset(&v, 0, sizeof(ScreenTriVertex));
+		v.x = clamp(x, 0.0f, (float)width);
+		v.y = clamp(y, 0.0f, (float)height);
+		v.w = 1.0f / depth;
+		v.a = 1.0f;
+		v.r = r;
+		v.g = g;
+		v.b = b;
+		vertices.Push(v);
+	};
+
+	for (int i = 0; i < 300; i++)
+	{
+		float x = random(-200.0f, width), y = random(-200.0f, height);
+		float w = random(100.0f, 800.0f), h = random(100.0f, 600.0f);
+		float depth = random(10.0f, 1000.0f), slope = random(-0.3f, 0.3f) * depth;
+		float r = random(0.0f, 1.0f), g = random(0.0f, 1.0f), b = random(0.0f, 1.0f);
+		addvertex(x, y, depth, r, g, b);
+		addvertex(x + w, y, depth + slope, r, g, b);
+		addvertex(x + w, y + h, depth + slope, r, g, b);
+		addvertex(x, y, depth, r, g, b);
+		addvertex(x + w, y + h, depth + slope, r, g, b);
+		addvertex(x, y + h, depth, r, g, b);
+	}
+	for (int i = 0; i < 5000; i++)
+	{
+		float x = random(0.0f, width), y = random(0.0f, height), size = random(4.0f, 48.0f);
+		float depth = random(10.0f, 1000.0f);
+		float r = random(0.0f, 1.0f), g = random(0.0f, 1.0f), b = random(0.0f, 1.0f);
+		addvertex(x, y, depth, r, g, b);
+		addvertex(x + random(-size, size), y + random(0.0f, size), depth, r, g, b);
+		addvertex(x + random(-size, size), y + random(0.0f, size), depth, r, g, b);
+	}
+
+	TArray<int> order(vertices.Size() / 3, true);
+	for (unsigned i = 0; i < order.Size(); i++)
+		order[i] = i;
+	for (unsigned i = order.Size() - 1; i > 0; i--)
+		std::swap(order[i], order[(unsigned)random(0.0f, i + 0.999f)]);
+
+	auto drawscene = [&]()
+	{
+		thread->ClearDepth(65535.0f);
+		thread->ClearStencil(0);
+		for (int index : order)
+		{
+			TriDrawTriangleArgs args;
+			args.v1 = &vertices[index * 3];
+			args.v2 = &vertices[index * 3 + 1];
+			args.v3 = &vertices[index * 3 + 2];
+			if (args.CalculateGradients())
+				ScreenTriangle::Draw(&args, thread.get());
+		}
+	};
+
+	bool savedtiles = r_poly_tiles;
+	TArray<float> reference(width * height, true);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		r_poly_tiles = pass == 1;
+		drawscene();
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < frames; i++)
+			drawscene();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (pass == 0)
+		{
+			memcpy(reference.Data(), depthstencil.DepthValues(), width * height * sizeof(float));
+			Printf("Scanline     %8.3f ms/frame\n", ms / frames);
+		}
+		else
+		{
+			int differ = 0;
+			for (int i = 0; i < width * height; i++)
+				differ += fabs(reference[i] - depthstencil.DepthValues()[i]) > reference[i] * 0.001f;
+			Printf("Tiles %-6s %8.3f ms/frame, %d pixels differ\n", GetTileKernels()->Name, ms / frames, differ);
+		}
+	}
+	r_poly_tiles = savedtiles;
+}
@@ -6871,6 +6871,16 @@ bool FxStructMember::RequestAddress(FCompileContext &ctx, bool *writable)
 			if (!scopeBarrier.writable)
 				bWritable = false;
 		}
+		if (bWritable && compileEnvironment.CheckFieldWrite)
+		{
+			PType *owner = classx->ValueType->isPointer() ? classx->ValueType->toPointer()->PointedType : classx->ValueType;
+			FName notify = owner->isContainer() ? compileEnvironment.CheckFieldWrite(static_cast<PContainerType *>(owner), membervar) : NAME_None;
+			if (notify != NAME_None)
+			{
+				WriteNotify = FindBuiltinFunction(notify);
+				assert(WriteNotify != nullptr);
+			}
+		}
 
 		*writable = bWritable;
 	}
@@ -7007,6 +7017,14 @@ FxExpression *FxStructMember::Resolve(FCompileContext &ctx)
 
 ExpEmit FxStructMember::Emit(VMFunctionBuilder *build)
 {
+	if (WriteNotify != nullptr)
+	{
+		// The write itself only happens once the address has been computed,
+		// so the callee must not rely on it having been done already.
+		FunctionCallEmitter emitters(WriteNotify->Variants[0].Implementation);
+		emitters.EmitCall(build);
+	}
+
 	ExpEmit obj = classx->Emit(build);
 	assert(obj.RegType == REGT_POINTER);
 
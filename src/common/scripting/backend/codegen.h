@@ -1380,6 +1380,7 @@ class FxStructMember : public FxMemberBase
 {
 public:
 	FxExpression *classx;
+	PFunction *WriteNotify = nullptr;
 
 	FxStructMember(FxExpression*, PField*, const FScriptPosition&);
 	~FxStructMember();
@@ -2155,6 +2156,7 @@ struct CompileEnvironment
 	FxExpression* (*CheckSpecialMember)(FxStructMember* func, FCompileContext& ctx);
 	FxExpression* (*CheckCustomGlobalFunctions)(FxFunctionCall* func, FCompileContext& ctx);
 	bool (*ResolveSpecialFunction)(FxVMFunctionCall* func, FCompileContext& ctx);
+	FName (*CheckFieldWrite)(PContainerType* owner, PField* field);	// returns a builtin that must be called before a script writes this field.
 	FName CustomBuiltinNew;	//override the 'new' function if some classes need special treatment.
 };
 
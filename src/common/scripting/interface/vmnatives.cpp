@@ -875,7 +875,7 @@ DEFINE_ACTION_FUNCTION(_CVar, FindCVar)
 {
 	PARAM_PROLOGUE;
 	PARAM_NAME(name);
-	ACTION_RETURN_POINTER(FindCVar(name.GetChars(), nullptr));
+	ACTION_RETURN_POINTER(FindCVar(name));
 }
 
 //=============================================================================
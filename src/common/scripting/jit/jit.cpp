@@ -2,6 +2,9 @@
 #include "jit.h"
 #include "jitintern.h"
 #include "printf.h"
+#include "workerpool.h"
+#include <atomic>
+#include <memory>
 
 extern PString *TypeString;
 extern PStruct *TypeVector2;
@@ -37,6 +40,138 @@ JitFuncPtr JitCompile(VMScriptFunction *sfunc)
 	}
 }
 
+//==========================================================================
+//
+// Background compilation
+//
+// Code generation is where almost all of the JIT's time goes and it only
+// reads the script function, so it can run on a worker thread. Copying the
+// result into executable memory, registering the unwind info and swapping
+// ScriptCall all happen on the main thread, the next time the function
+// gets called after its job has finished.
+//
+//==========================================================================
+
+struct FJitJob
+{
+	VMScriptFunction *Func;
+	asmjit::StringLogger Logger;
+	ThrowingErrorHandler ErrorHandler;
+	asmjit::CodeHolder Code;
+	std::unique_ptr<JitCompiler> Compiler;
+	asmjit::CCFunc *Result = nullptr;
+	FString Error;
+	std::exception_ptr Exception;
+	double CompileTime = 0;
+	std::atomic<bool> Ready = { false };
+	FWorkerJobPtr Finished;
+};
+
+FJitStats JitStats;
+static TArray<FJitJob *> JitJobs;
+
+static void RunJitJob(FJitJob *job)
+{
+	cycle_t timer;
+	timer.Reset();
+	timer.Clock();
+	try
+	{
+		job->Result = job->Compiler->Codegen();
+	}
+	catch (const CRecoverableError &e)
+	{
+		job->Error = e.what();
+	}
+	catch (...)
+	{
+		// Anything else gets rethrown on the main thread, same as for a synchronous compile.
+		job->Exception = std::current_exception();
+	}
+	timer.Unclock();
+	job->CompileTime = timer.TimeMS();
+	job->Ready.store(true, std::memory_order_release);
+}
+
+FJitJob *JitQueueCompile(VMScriptFunction *sfunc)
+{
+	auto job = new FJitJob;
+	job->Func = sfunc;
+	job->Code.init(GetHostCodeInfo());
+	job->Code.setErrorHandler(&job->ErrorHandler);
+	job->Code.setLogger(&job->Logger);
+	job->Compiler.reset(new JitCompiler(&job->Code, sfunc));
+	job->Finished = FWorkerPool::Push([=]() { RunJitJob(job); });
+	JitJobs.Push(job);
+	JitStats.Queued++;
+	return job;
+}
+
+bool JitCompileReady(const FJitJob *job)
+{
+	return job->Ready.load(std::memory_order_acquire);
+}
+
+JitFuncPtr JitFinishCompile(FJitJob *job)
+{
+	std::unique_ptr<FJitJob> owner(job);
+	job->Finished->Wait();
+	JitJobs.Delete(JitJobs.Find(job));
+	JitStats.CompileTime += job->CompileTime;
+	JitStats.MaxCompileTime = std::max(JitStats.MaxCompileTime, job->CompileTime);
+
+	if (job->Exception)
+	{
+		std::rethrow_exception(job->Exception);
+	}
+
+	void *p = nullptr;
+	if (job->Result != nullptr)
+	{
+		try
+		{
+			p = InstallJitFunction(&job->Code, job->Compiler.get(), job->Result);
+		}
+		catch (const CRecoverableError &e)
+		{
+			job->Error = e.what();
+		}
+	}
+	if (p == nullptr)
+	{
+		if (job->Error.IsNotEmpty())
+		{
+			OutputJitLog(job->Logger);
+			Printf("%s: Unexpected JIT error: %s\n", job->Func->PrintableName.GetChars(), job->Error.GetChars());
+		}
+		JitStats.Failed++;
+		return nullptr;
+	}
+	JitStats.Promoted++;
+	return reinterpret_cast<JitFuncPtr>(p);
+}
+
+int JitPendingCompiles()
+{
+	int count = 0;
+	for (auto job : JitJobs)
+	{
+		if (!JitCompileReady(job)) count++;
+	}
+	return count;
+}
+
+void JitWaitForCompiles()
+{
+	for (auto job : JitJobs)
+	{
+		job->Finished->Wait();
+		job->Func->JitJob = nullptr;
+		delete job;
+	}
+	JitJobs.Clear();
+}
+
 void JitDumpLog(FILE *file, VMScriptFunction *sfunc)
 {
 	using namespace asmjit;
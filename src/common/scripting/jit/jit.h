@@ -3,6 +3,22 @@
 
 #include "vmintern.h"
 
+struct FJitStats
+{
+	int Queued = 0;				// functions handed to the background workers
+	int Promoted = 0;			// background compiles that replaced the interpreter
+	int Failed = 0;
+	int Synchronous = 0;		// functions compiled on their first call
+	double CompileTime = 0;		// milliseconds spent generating code on the workers
+	double MaxCompileTime = 0;
+};
+
+extern FJitStats JitStats;
+
 JitFuncPtr JitCompile(VMScriptFunction *func);
+FJitJob *JitQueueCompile(VMScriptFunction *func);
+bool JitCompileReady(const FJitJob *job);
+JitFuncPtr JitFinishCompile(FJitJob *job);
+int JitPendingCompiles();
 void JitDumpLog(FILE *file, VMScriptFunction *func);
 FString JitCaptureStackTrace(int framesToSkip, bool includeNativeFrames);
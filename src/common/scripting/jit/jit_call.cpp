@@ -2,6 +2,7 @@
 #include "jitintern.h"
 #include <map>
 #include <memory>
+#include <mutex>
 
 void JitCompiler::EmitPARAM()
 {
@@ -566,6 +567,7 @@ void JitCompiler::EmitNativeCall(VMNativeFunction *target)
 }
 
 static std::map<FString, std::unique_ptr<TArray<uint8_t>>> argsCache;
+static std::mutex argsCacheMutex;	// functions may be compiled on the background JIT workers
 
 asmjit::FuncSignature JitCompiler::CreateFuncSignature()
 {
@@ -681,8 +683,10 @@ asmjit::FuncSignature JitCompiler::CreateFuncSignature()
 	}
 
 	// FuncSignature only keeps a pointer to its args array. Store a copy of each args array variant.
+	std::unique_lock<std::mutex> lock(argsCacheMutex);
 	std::unique_ptr<TArray<uint8_t>> &cachedArgs = argsCache[key];
 	if (!cachedArgs) cachedArgs.reset(new TArray<uint8_t>(args));
+	lock.unlock();
 
 	FuncSignature signature;
 	signature.init(CallConv::kIdHost, rettype, cachedArgs->Data(), cachedArgs->Size());
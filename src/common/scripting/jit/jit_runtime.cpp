@@ -252,12 +252,10 @@ static TArray<uint16_t> CreateUnwindInfoWindows(asmjit::CCFunc *func)
 	return info;
 }
 
-void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
+void *InstallJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler, asmjit::CCFunc *func)
 {
 	using namespace asmjit;
 
-	CCFunc *func = compiler->Codegen();
-
 	size_t codeSize = code->getCodeSize();
 	if (codeSize == 0)
 		return nullptr;
@@ -648,12 +646,10 @@ static TArray<uint8_t> CreateUnwindInfoUnix(asmjit::CCFunc *func, unsigned int &
 	return stream;
 }
 
-void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
+void *InstallJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler, asmjit::CCFunc *func)
 {
 	using namespace asmjit;
 
-	CCFunc *func = compiler->Codegen();
-
 	size_t codeSize = code->getCodeSize();
 	if (codeSize == 0)
 		return nullptr;
@@ -735,6 +731,12 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 }
 #endif
 
+void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
+{
+	asmjit::CCFunc *func = compiler->Codegen();
+	return InstallJitFunction(code, compiler, func);
+}
+
 void JitRelease()
 {
 #ifdef _WIN64
@@ -334,4 +334,5 @@ public:
 };
 
 void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler);
+void *InstallJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler, asmjit::CCFunc *func);
 asmjit::CodeInfo GetHostCodeInfo();
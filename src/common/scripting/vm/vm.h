@@ -55,6 +55,7 @@ extern FMemArena ClassDataAllocator;
 #define MAX_TRY_DEPTH	8	// Maximum number of nested TRYs in a single function
 
 void JitRelease();
+void JitWaitForCompiles();
 
 extern void (*VM_CastSpriteIDToString)(FString* a, unsigned int b);
 
@@ -430,6 +431,8 @@ public:
 	void operator delete[](void *block) {}
 	static void DeleteAll()
 	{
+		// background compiles still reference the functions
+		JitWaitForCompiles();
 		for (auto f : AllFunctions)
 		{
 			f->~VMFunction();
@@ -54,10 +54,13 @@ CUSTOM_CVAR(Bool, vm_jit, true, CVAR_NOINITCALL)
 	Printf("You must restart " GAMENAME " for this change to take effect.\n");
 	Printf("This cvar is currently not saved. You must specify it on the command line.");
 }
+CVAR(Bool, vm_jit_background, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CVAR(Int, vm_jit_threshold, 16, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 #else
 CVAR(Bool, vm_jit, false, CVAR_NOINITCALL|CVAR_NOSET)
 FString JitCaptureStackTrace(int framesToSkip, bool includeNativeFrames) { return FString(); }
 void JitRelease() {}
+void JitWaitForCompiles() {}
 #endif
 
 cycle_t VMCycles[10];
@@ -294,9 +297,18 @@ int VMScriptFunction::FirstScriptCall(VMFunction *func, VMValue *params, int num
 #ifdef HAVE_VM_JIT
 	if (vm_jit && CanJit(static_cast<VMScriptFunction*>(func)))
 	{
-		func->ScriptCall = JitCompile(static_cast<VMScriptFunction*>(func));
-		if (!func->ScriptCall)
-			func->ScriptCall = VMExec;
+		if (vm_jit_background)
+		{
+			// Interpret until the function has proven to be worth compiling.
+			func->ScriptCall = &VMScriptFunction::TieredScriptCall;
+		}
+		else
+		{
+			func->ScriptCall = JitCompile(static_cast<VMScriptFunction*>(func));
+			if (!func->ScriptCall)
+				func->ScriptCall = VMExec;
+			JitStats.Synchronous++;
+		}
 	}
 	else
 #endif // HAVE_VM_JIT
@@ -307,6 +319,40 @@ int VMScriptFunction::FirstScriptCall(VMFunction *func, VMValue *params, int num
 	return func->ScriptCall(func, params, numparams, ret, numret);
 }
 
+//==========================================================================
+//
+// VMScriptFunction :: TieredScriptCall
+//
+// Runs the function in the interpreter and queues it for compilation on
+// the JIT workers once it has been called often enough. As soon as the
+// native code is ready it replaces this as the function's entry point.
+//
+//==========================================================================
+
+int VMScriptFunction::TieredScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
+{
+#ifdef HAVE_VM_JIT
+	auto sfunc = static_cast<VMScriptFunction*>(func);
+	if (sfunc->JitJob == nullptr)
+	{
+		if (++sfunc->CallCount >= vm_jit_threshold)
+		{
+			sfunc->JitJob = JitQueueCompile(sfunc);
+		}
+	}
+	else if (JitCompileReady(sfunc->JitJob))
+	{
+		auto job = sfunc->JitJob;
+		sfunc->JitJob = nullptr;
+		func->ScriptCall = VMExec;
+		auto jitfunc = JitFinishCompile(job);
+		if (jitfunc) func->ScriptCall = jitfunc;
+		return func->ScriptCall(func, params, numparams, ret, numret);
+	}
+#endif // HAVE_VM_JIT
+	return VMExec(func, params, numparams, ret, numret);
+}
+
 int VMNativeFunction::NativeScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *returns, int numret)
 {
 	try
@@ -784,3 +830,19 @@ CCMD(vmengine)
 	Printf("Usage: vmengine <default|checked|unchecked>\n");
 }
 
+
+CCMD(vm_jit_stats)
+{
+#ifdef HAVE_VM_JIT
+	Printf("JIT: %s, %s compilation after %d calls\n", vm_jit ? "enabled" : "disabled",
+		vm_jit_background ? "background" : "synchronous", (int)vm_jit_threshold);
+	Printf("Compiled on first call: %d\n", JitStats.Synchronous);
+	Printf("Queued: %d, still compiling: %d\n", JitStats.Queued, JitPendingCompiles());
+	Printf("Promoted: %d, failed: %d\n", JitStats.Promoted, JitStats.Failed);
+	int finished = JitStats.Promoted + JitStats.Failed;
+	Printf("Compile time: %.2f ms total, %.3f ms average, %.3f ms peak\n", JitStats.CompileTime,
+		finished > 0 ? JitStats.CompileTime / finished : 0., JitStats.MaxCompileTime);
+#else
+	Printf("This build has no JIT compiler.\n");
+#endif
+}
@@ -442,6 +442,7 @@ extern thread_local VMFrameStack GlobalVMStack;
 typedef std::pair<const class PType *, unsigned> FTypeAndOffset;
 
 typedef int(*JitFuncPtr)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+struct FJitJob;
 
 class VMScriptFunction : public VMFunction
 {
@@ -472,6 +473,8 @@ public:
 	VM_UHALF MaxParam;		// Maximum number of parameters this function has on the stack at once
 	VM_UBYTE NumArgs;		// Number of arguments this function takes
 	TArray<FTypeAndOffset> SpecialInits;	// list of all contents on the extra stack which require construction and destruction
+	int CallCount = 0;		// interpreted calls so far, while waiting to be handed to the JIT
+	FJitJob *JitJob = nullptr;	// background compile in progress
 
 	void InitExtra(void *addr);
 	void DestroyExtra(void *addr);
@@ -480,4 +483,5 @@ public:
 
 private:
 	static int FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+	static int TieredScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
 };
@@ -164,6 +164,7 @@ public:
 	FDDSTexture (FileReader &lump, int lumpnum, void *surfdesc);
 
 	TArray<uint8_t> CreatePalettedPixels(int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 
 protected:
 	uint32_t Format;
@@ -49,6 +49,7 @@ class FFlatTexture : public FImageSource
 public:
 	FFlatTexture (int lumpnum);
 	TArray<uint8_t> CreatePalettedPixels(int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 };
 
 
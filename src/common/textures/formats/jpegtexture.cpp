@@ -186,6 +186,7 @@ public:
 
 	int CopyPixels(FBitmap *bmp, int conversion) override;
 	TArray<uint8_t> CreatePalettedPixels(int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 };
 
 //==========================================================================
@@ -64,6 +64,7 @@ public:
 	TArray<uint8_t> CreatePalettedPixels(int conversion) override;
 	int CopyPixels(FBitmap *bmp, int conversion) override;
 	bool SupportRemap0() override { return !badflag; }
+	bool CanDecodeOnWorker() override { return true; }
 	void DetectBadPatches();
 };
 
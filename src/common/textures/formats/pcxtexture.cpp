@@ -84,6 +84,7 @@ public:
 	FPCXTexture (int lumpnum, PCXHeader &);
 
 	int CopyPixels(FBitmap *bmp, int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 
 protected:
 	void ReadPCX1bit (uint8_t *dst, FileReader & lump, PCXHeader *hdr);
@@ -57,6 +57,7 @@ public:
 
 	int CopyPixels(FBitmap *bmp, int conversion) override;
 	TArray<uint8_t> CreatePalettedPixels(int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 
 protected:
 	void ReadAlphaRemap(FileReader *lump, uint8_t *alpharemap);
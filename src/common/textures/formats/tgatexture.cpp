@@ -80,6 +80,7 @@ public:
 	FTGATexture (int lumpnum, TGAHeader *);
 
 	int CopyPixels(FBitmap *bmp, int conversion) override;
+	bool CanDecodeOnWorker() override { return true; }
 
 protected:
 	void ReadCompressed(FileReader &lump, uint8_t * buffer, int bytesperpixel);
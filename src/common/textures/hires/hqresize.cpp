@@ -45,6 +45,8 @@
 #include "textures.h"
 #include "texturemanager.h"
 #include "printf.h"
+#include "md5.h"
+#include "m_swap.h"
 
 int upscalemask;
 
@@ -406,6 +408,31 @@ static unsigned char *xbrzHelper( void (*xbrzFunction) ( size_t, const uint32_t*
 	return newBuffer;
 }
 
+//===========================================================================
+// 
+// The disk cache is keyed by everything that affects the scaler's output.
+//
+//===========================================================================
+
+EXTERN_CVAR(Bool, gl_texture_hqresize_cache)
+bool ReadUpscaleCache(const uint8_t *key, FTextureBuffer &texbuffer);
+void WriteUpscaleCache(const uint8_t *key, const FTextureBuffer &texbuffer);
+
+static void CalcUpscaleCacheKey(uint8_t *key, const FTextureBuffer &texbuffer, int type, int mult)
+{
+	int32_t header[] = { LittleLong(texbuffer.mWidth), LittleLong(texbuffer.mHeight), LittleLong(type), LittleLong(mult) };
+
+	MD5Context md5;
+	md5.Update((const uint8_t *)header, sizeof(header));
+	if (type == 4 || type == 5)
+	{
+		float options[] = { xbrz_luminanceweight, xbrz_equalcolortolerance, xbrz_centerdirectionbias, xbrz_dominantdirectionthreshold, xbrz_steepdirectionthreshold, (float)xbrz_colorformat };
+		md5.Update((const uint8_t *)options, sizeof(options));
+	}
+	md5.Update(texbuffer.mBuffer, texbuffer.mWidth * texbuffer.mHeight * 4);
+	md5.Final(key);
+}
+
 static void xbrzOldScale(size_t factor, const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight, xbrz::ColorFormat colFmt, const xbrz_old::ScalerCfg& cfg, int yFirst, int yLast)
 {
 	xbrz_old::scale(factor, src, trg, srcWidth, srcHeight, cfg, yFirst, yLast);
@@ -442,46 +469,55 @@ void FTexture::CreateUpsampledTextureBuffer(FTextureBuffer &texbuffer, bool hasA
 
 	if (!checkonly)
 	{
-		if (type == 1)
-		{
-			if (mult == 2)
-				texbuffer.mBuffer = scaleNxHelper(&scale2x, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 3)
-				texbuffer.mBuffer = scaleNxHelper(&scale3x, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 4)
-				texbuffer.mBuffer = scaleNxHelper(&scale4x, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else return;
-		}
-		else if (type == 2)
+		uint8_t cachekey[16];
+		bool usecache = gl_texture_hqresize_cache;
+		if (usecache) CalcUpscaleCacheKey(cachekey, texbuffer, type, mult);
+
+		if (!usecache || !ReadUpscaleCache(cachekey, texbuffer))
 		{
-			if (mult == 2)
-				texbuffer.mBuffer = hqNxHelper(&hq2x_32, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 3)
-				texbuffer.mBuffer = hqNxHelper(&hq3x_32, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 4)
-				texbuffer.mBuffer = hqNxHelper(&hq4x_32, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else return;
-		}
+			if (type == 1)
+			{
+				if (mult == 2)
+					texbuffer.mBuffer = scaleNxHelper(&scale2x, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 3)
+					texbuffer.mBuffer = scaleNxHelper(&scale3x, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 4)
+					texbuffer.mBuffer = scaleNxHelper(&scale4x, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else return;
+			}
+			else if (type == 2)
+			{
+				if (mult == 2)
+					texbuffer.mBuffer = hqNxHelper(&hq2x_32, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 3)
+					texbuffer.mBuffer = hqNxHelper(&hq3x_32, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 4)
+					texbuffer.mBuffer = hqNxHelper(&hq4x_32, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else return;
+			}
 #ifdef HAVE_MMX
-		else if (type == 3)
-		{
-			if (mult == 2)
-				texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq2x_32, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 3)
-				texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq3x_32, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else if (mult == 4)
-				texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq4x_32, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-			else return;
-		}
+			else if (type == 3)
+			{
+				if (mult == 2)
+					texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq2x_32, 2, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 3)
+					texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq3x_32, 3, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else if (mult == 4)
+					texbuffer.mBuffer = hqNxAsmHelper(&HQnX_asm::hq4x_32, 4, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+				else return;
+			}
 #endif
-		else if (type == 4)
-			texbuffer.mBuffer = xbrzHelper(xbrz::scale, mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-		else if (type == 5)
-			texbuffer.mBuffer = xbrzHelper(xbrzOldScale, mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-		else if (type == 6)
-			texbuffer.mBuffer = normalNx(mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
-		else
-			return;
+			else if (type == 4)
+				texbuffer.mBuffer = xbrzHelper(xbrz::scale, mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+			else if (type == 5)
+				texbuffer.mBuffer = xbrzHelper(xbrzOldScale, mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+			else if (type == 6)
+				texbuffer.mBuffer = normalNx(mult, texbuffer.mBuffer, inWidth, inHeight, texbuffer.mWidth, texbuffer.mHeight);
+			else
+				return;
+
+			if (usecache) WriteUpscaleCache(cachekey, texbuffer);
+		}
 	}
 	else
 	{
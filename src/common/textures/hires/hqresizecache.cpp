@@ -0,0 +1,341 @@
+/*
+** hqresizecache.cpp
+** Disk cache for upscaled textures
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Upscaling a texture with the high quality scalers is a lot more expensive
+** than loading the result from disk, so the results are stored in the
+** cache directory, one file per texture, named after a hash of the source
+** pixels and the scaler settings. The files only get read when the texture
+** gets created. An index with the last use of each file is kept to delete
+** the least recently used ones when the cache exceeds its size limit.
+** Since the directory is the authority on what exists, losing the index
+** only loses the last uses, so it is only saved in batches and on exit.
+**
+*/
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <time.h>
+
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "i_specialpaths.h"
+#include "m_swap.h"
+#include "textures.h"
+
+CVAR(Bool, gl_texture_hqresize_cache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CUSTOM_CVAR(Int, gl_texture_hqresize_cachesize, 256, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// in megabytes
+{
+	if (self < 0) self = 0;
+}
+
+static const char UpscaleMagic[4] = { 'U', 'P', 'S', 'C' };
+static const char IndexMagic[4] = { 'U', 'P', 'S', 'I' };
+static const int IndexSaveInterval = 64;	// writes between two saves of the index
+
+struct FUpscaleCacheEntry
+{
+	uint32_t Size;
+	uint32_t LastUse;		// time of the last use, in seconds
+};
+
+class FUpscaleCache
+{
+public:
+	~FUpscaleCache();
+
+	bool Read(const uint8_t *key, FTextureBuffer &texbuffer);
+	void Write(const uint8_t *key, const FTextureBuffer &texbuffer);
+	void Clear();
+
+private:
+	void Open();
+	void SaveIndex();
+	void Evict(uint64_t limit);
+	FString FileName(const FString &name);
+
+	std::mutex Mutex;
+	FString Path;
+	TMap<FString, FUpscaleCacheEntry> Entries;
+	uint64_t TotalSize = 0;
+	bool Opened = false;
+	bool IndexChanged = false;
+	int WritesSinceSave = 0;
+};
+
+static FUpscaleCache UpscaleCache;
+
+static FString KeyName(const uint8_t *key)
+{
+	FString name;
+	for (int i = 0; i < 16; i++) name.AppendFormat("%02x", key[i]);
+	return name;
+}
+
+FString FUpscaleCache::FileName(const FString &name)
+{
+	return Path + name + ".upc";
+}
+
+//===========================================================================
+//
+// Builds the list of cached files. The directory is the authority on what
+// exists, the index only supplies the last use of each file.
+//
+//===========================================================================
+
+void FUpscaleCache::Open()
+{
+	if (Opened) return;
+	Opened = true;
+
+	Path = M_GetCachePath(true);
+	Path << "/upscale/";
+	CreatePath(Path);
+
+	TArray<FFileList> list;
+	ScanDirectory(list, Path);
+	for (auto &file : list)
+	{
+		if (file.isDirectory) continue;
+		FString name = ExtractFileBase(file.Filename);
+		size_t size;
+		time_t time;
+		if (name.Len() == 32 && GetFileInfo(file.Filename, &size, &time))
+		{
+			Entries.Insert(name, { (uint32_t)size, (uint32_t)time });
+			TotalSize += size;
+		}
+	}
+
+	FileReader fr;
+	if (fr.OpenFile(Path + "index.dat"))
+	{
+		char magic[4];
+		if (fr.Read(magic, 4) == 4 && memcmp(magic, IndexMagic, 4) == 0)
+		{
+			uint32_t count = fr.ReadUInt32();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				char name[33];
+				if (fr.Read(name, 32) != 32) break;
+				name[32] = 0;
+				uint32_t lastuse = fr.ReadUInt32();
+				auto entry = Entries.CheckKey(name);
+				if (entry) entry->LastUse = lastuse;
+			}
+		}
+	}
+}
+
+void FUpscaleCache::SaveIndex()
+{
+	WritesSinceSave = 0;
+	if (!IndexChanged) return;
+	IndexChanged = false;
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(Path + "index.dat"));
+	if (fw)
+	{
+		uint32_t count = LittleLong((uint32_t)Entries.CountUsed());
+		fw->Write(IndexMagic, 4);
+		fw->Write(&count, 4);
+
+		decltype(Entries)::Iterator it(Entries);
+		decltype(Entries)::Pair *pair;
+		while (it.NextPair(pair))
+		{
+			uint32_t lastuse = LittleLong(pair->Value.LastUse);
+			fw->Write(pair->Key.GetChars(), 32);
+			fw->Write(&lastuse, 4);
+		}
+	}
+}
+
+FUpscaleCache::~FUpscaleCache()
+{
+	if (Opened) SaveIndex();
+}
+
+//===========================================================================
+//
+// Deletes the least recently used files until the cache fits the limit.
+//
+//===========================================================================
+
+void FUpscaleCache::Evict(uint64_t limit)
+{
+	if (TotalSize <= limit) return;
+
+	TArray<std::pair<uint32_t, FString>> byage;
+	byage.Grow(Entries.CountUsed());
+
+	decltype(Entries)::Iterator it(Entries);
+	decltype(Entries)::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		byage.Push(std::make_pair(pair->Value.LastUse, pair->Key));
+	}
+	std::sort(byage.begin(), byage.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+	for (unsigned i = 0; i < byage.Size() && TotalSize > limit; i++)
+	{
+		auto &name = byage[i].second;
+		TotalSize -= Entries[name].Size;
+		Entries.Remove(name);
+		remove(FileName(name));
+	}
+	IndexChanged = true;
+}
+
+//===========================================================================
+//
+// Replaces the texture buffer's contents with the cached upscaled image.
+//
+//===========================================================================
+
+bool FUpscaleCache::Read(const uint8_t *key, FTextureBuffer &texbuffer)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Open();
+
+	FString name = KeyName(key);
+	auto entry = Entries.CheckKey(name);
+	if (entry == nullptr) return false;
+
+	FString filename = FileName(name);
+	FileReader fr;
+	if (fr.OpenMapped(filename) || fr.OpenFile(filename))
+	{
+		char magic[4];
+		if (fr.Read(magic, 4) == 4 && memcmp(magic, UpscaleMagic, 4) == 0)
+		{
+			uint32_t width = fr.ReadUInt32();
+			uint32_t height = fr.ReadUInt32();
+			size_t size = (size_t)width * height * 4;
+			if (width > 0 && height > 0 && 12 + size == (size_t)fr.GetLength())
+			{
+				auto buffer = new uint8_t[size];
+				if (fr.Read(buffer, size) == (FileReader::Size)size)
+				{
+					delete[] texbuffer.mBuffer;
+					texbuffer.mBuffer = buffer;
+					texbuffer.mWidth = width;
+					texbuffer.mHeight = height;
+					entry->LastUse = (uint32_t)time(nullptr);
+					IndexChanged = true;
+					return true;
+				}
+				delete[] buffer;
+			}
+		}
+		fr.Close();
+	}
+	// The file is gone or broken.
+	TotalSize -= entry->Size;
+	Entries.Remove(name);
+	remove(filename);
+	IndexChanged = true;
+	return false;
+}
+
+void FUpscaleCache::Write(const uint8_t *key, const FTextureBuffer &texbuffer)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Open();
+
+	uint64_t limit = (uint64_t)gl_texture_hqresize_cachesize * 1024 * 1024;
+	uint32_t size = 12 + texbuffer.mWidth * texbuffer.mHeight * 4;
+	if (size > limit) return;
+
+	FString name = KeyName(key);
+	auto entry = Entries.CheckKey(name);
+	if (entry != nullptr)
+	{
+		TotalSize -= entry->Size;
+		Entries.Remove(name);
+	}
+	Evict(limit - size);
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(FileName(name)));
+	if (fw)
+	{
+		uint32_t width = LittleLong((uint32_t)texbuffer.mWidth);
+		uint32_t height = LittleLong((uint32_t)texbuffer.mHeight);
+		fw->Write(UpscaleMagic, 4);
+		fw->Write(&width, 4);
+		fw->Write(&height, 4);
+		if (fw->Write(texbuffer.mBuffer, size - 12) == size - 12)
+		{
+			Entries.Insert(name, { size, (uint32_t)time(nullptr) });
+			TotalSize += size;
+		}
+		else
+		{
+			fw.reset();
+			remove(FileName(name));
+		}
+		IndexChanged = true;
+	}
+	if (++WritesSinceSave >= IndexSaveInterval) SaveIndex();
+}
+
+void FUpscaleCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	Open();
+	Evict(0);
+	SaveIndex();
+}
+
+//===========================================================================
+//
+// Interface for the upscaler
+//
+//===========================================================================
+
+bool ReadUpscaleCache(const uint8_t *key, FTextureBuffer &texbuffer)
+{
+	return UpscaleCache.Read(key, texbuffer);
+}
+
+void WriteUpscaleCache(const uint8_t *key, const FTextureBuffer &texbuffer)
+{
+	UpscaleCache.Write(key, texbuffer);
+}
+
+UNSAFE_CCMD(clearupscalecache)
+{
+	UpscaleCache.Clear();
+}
@@ -40,6 +40,19 @@
 #include "files.h"
 #include "cmdlib.h"
 #include "palettecontainer.h"
+#include "printf.h"
+#include "stats.h"
+#include "c_cvars.h"
+#include "workerpool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+CVAR(Int, gl_precache_threads, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// how many workers to keep busy, 0 means all of them, negative values decode on the main thread.
+
+extern thread_local TArray<std::pair<int, FString>> *DeferredPrints;
 
 FMemArena ImageArena(32768);
 TArray<FImageSource *>FImageSource::ImageForLump;
@@ -65,6 +78,140 @@ struct PrecacheDataRgba
 TArray<PrecacheDataPaletted> precacheDataPaletted;
 TArray<PrecacheDataRgba> precacheDataRgba;
 
+//===========================================================================
+//
+// Images that are needed in true color get decoded on worker threads while
+// the main thread uploads the ones that are already done. The file system
+// is not thread safe so the lumps get read on the main thread, a few jobs
+// ahead of the upload, which also limits how much decoded data is waiting.
+//
+//===========================================================================
+
+struct FPrecacheDecodeJob
+{
+	enum
+	{
+		Queued,
+		Running,
+		Done
+	};
+
+	FImageSource *Image;
+	TArray<uint8_t> Lump;
+	FBitmap Pixels;
+	int TransInfo = 0;
+	double DecodeMS = 0;
+	TArray<std::pair<int, FString>> Messages;
+	std::atomic<int> State{ Queued };
+	std::promise<void> Finished;	// only set when a worker ran the job
+	std::future<void> FinishedFuture = Finished.get_future();
+
+	// Whoever gets to switch the state to Running does the work.
+	bool Claim()
+	{
+		int expected = Queued;
+		return State.compare_exchange_strong(expected, Running);
+	}
+
+	void Decode()
+	{
+		auto start = std::chrono::steady_clock::now();
+		DeferredPrints = &Messages;
+		FileSystem::SetThreadLump(Image->LumpNum(), &Lump);
+		Pixels.Create(Image->GetWidth(), Image->GetHeight());
+		TransInfo = Image->CopyPixels(&Pixels, FImageSource::normal);
+		FileSystem::SetThreadLump(-1, nullptr);
+		DeferredPrints = nullptr;
+		Lump.Reset();
+		DecodeMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		State = Done;
+	}
+};
+
+static TArray<FImageSource *> precacheImages;	// in registration order
+static unsigned precacheNext;
+static TMap<int, std::shared_ptr<FPrecacheDecodeJob>> precacheJobs;
+static FImageSource::PrecacheStats precacheStats;
+static cycle_t precacheWait;
+
+static void QueuePrecacheJobs()
+{
+	unsigned maxjobs = precacheStats.Threads * 8;
+	while (precacheJobs.CountUsed() < maxjobs && precacheNext < precacheImages.Size())
+	{
+		auto img = precacheImages[precacheNext++];
+		auto info = precacheInfo.CheckKey(img->GetId());
+		if (info == nullptr || info->first == 0 || !img->CanDecodeOnWorker() || precacheJobs.CheckKey(img->GetId()))
+		{
+			continue;
+		}
+
+		auto job = std::make_shared<FPrecacheDecodeJob>();
+		job->Image = img;
+		job->Lump = fileSystem.GetFileData(img->LumpNum());
+		precacheJobs.Insert(img->GetId(), job);
+		FWorkerPool::Push([job]()
+		{
+			if (job->Claim())
+			{
+				job->Decode();
+				job->Finished.set_value();
+			}
+		});
+	}
+}
+
+static std::shared_ptr<FPrecacheDecodeJob> WaitForPrecacheJob(int imageID)
+{
+	auto pjob = precacheJobs.CheckKey(imageID);
+	if (pjob == nullptr) return nullptr;
+
+	auto job = *pjob;
+	precacheJobs.Remove(imageID);
+
+	precacheWait.Clock();
+	if (job->State != FPrecacheDecodeJob::Done)
+	{
+		if (job->Claim()) job->Decode();
+		else job->FinishedFuture.wait();
+	}
+	precacheWait.Unclock();
+
+	for (auto &msg : job->Messages)
+	{
+		PrintString(msg.first, msg.second.GetChars());
+	}
+	precacheStats.Decoded++;
+	precacheStats.DecodeMS += job->DecodeMS;
+	return job;
+}
+
+//===========================================================================
+//
+// Puts the result of a finished decoding job into the cache, so that
+// GetCachedBitmap can handle it like any other cached image.
+//
+//===========================================================================
+
+static void FinishPrecacheJob(int imageID)
+{
+	auto job = WaitForPrecacheJob(imageID);
+	if (job == nullptr) return;
+
+	auto info = precacheInfo.CheckKey(imageID);
+	if (info != nullptr && info->first > 0 && job->Pixels.GetPixels())
+	{
+		PrecacheDataRgba *pdr = &precacheDataRgba[precacheDataRgba.Reserve(1)];
+
+		pdr->ImageID = imageID;
+		pdr->RefCount = info->first;
+		info->first = 0;
+		pdr->Pixels = std::move(job->Pixels);
+		pdr->TransInfo = job->TransInfo;
+	}
+	QueuePrecacheJobs();
+}
+
 //===========================================================================
 // 
 // the default just returns an empty texture.
@@ -215,6 +362,7 @@ FBitmap FImageSource::GetCachedBitmap(const PalEntry *remap, int conversion, int
 	else
 	{
 		if (conversion == luminance) conversion = normal;	// luminance has no meaning for true color.
+		if (conversion == normal && precacheJobs.CountUsed() > 0) FinishPrecacheJob(imageID);
 		// Do we have this image in the cache?
 		unsigned index = conversion != normal? UINT_MAX : precacheDataRgba.FindEx([=](PrecacheDataRgba &entry) { return entry.ImageID == imageID; });
 		if (index < precacheDataRgba.Size())
@@ -250,6 +398,7 @@ FBitmap FImageSource::GetCachedBitmap(const PalEntry *remap, int conversion, int
 			{
 				// This is either the only copy needed or some access outside the caching block. In these cases create a new one and directly return it.
 				//Printf("returning fresh copy of %s\n", name.GetChars());
+				if (info && conversion == normal) info->first = 0;	// so that no decoding job gets started for it anymore.
 				ret.Create(Width, Height);
 				trans = CopyPixels(&ret, conversion);
 			}
@@ -291,20 +440,59 @@ void FImageSource::CollectForPrecache(PrecacheInfo &info, bool requiretruecolor)
 	{
 		auto pair = std::make_pair(tc, !tc);
 		info.Insert(ImageID, pair);
+		if (&info == &precacheInfo) precacheImages.Push(this);
 	}
 }
 
 void FImageSource::BeginPrecaching()
 {
 	precacheInfo.Clear();
+	precacheImages.Clear();
+	precacheNext = 0;
+	precacheStats = {};
+	precacheWait.Reset();
 }
 
 void FImageSource::EndPrecaching()
 {
+	// Jobs for images that never got requested still need to finish before their data goes away.
+	while (precacheJobs.CountUsed() > 0)
+	{
+		decltype(precacheJobs)::Iterator it(precacheJobs);
+		decltype(precacheJobs)::Pair *pair;
+		it.NextPair(pair);
+		WaitForPrecacheJob(pair->Key);
+	}
+	precacheStats.WaitMS = precacheWait.TimeMS();
+	precacheImages.Clear();
 	precacheDataPaletted.Clear();
 	precacheDataRgba.Clear();
 }
 
+//==========================================================================
+//
+// Starts decoding the registered images on worker threads. Must be called
+// after all images have been registered.
+//
+//==========================================================================
+
+void FImageSource::StartPrecacheDecoding()
+{
+	int numthreads = gl_precache_threads;
+	if (numthreads < 0) return;
+	if (numthreads == 0)
+	{
+		numthreads = FWorkerPool::NumThreads();
+	}
+	precacheStats.Threads = numthreads;
+	QueuePrecacheJobs();
+}
+
+FImageSource::PrecacheStats FImageSource::GetPrecacheStats()
+{
+	return precacheStats;
+}
+
 void FImageSource::RegisterForPrecache(FImageSource *img, bool requiretruecolor)
 {
 	img->CollectForPrecache(precacheInfo, requiretruecolor);
@@ -37,6 +37,7 @@ private:
 class FImageSource
 {
 	friend class FBrightmapTexture;
+	friend struct FPrecacheDecodeJob;
 protected:
 
 	static TArray<FImageSource *>ImageForLump;
@@ -59,6 +60,7 @@ protected:
 public:
 	virtual bool SupportRemap0() { return false; }		// Unfortunate hackery that's needed for Hexen's skies. Only the image can know about the needed parameters
 	virtual bool IsRawCompatible() { return true; }		// Same thing for mid texture compatibility handling. Can only be determined by looking at the composition data which is private to the image.
+	virtual bool CanDecodeOnWorker() { return false; }	// The image only needs its own lump to create its pixels so it can be decoded on a worker thread while precaching.
 
 	void CopySize(FImageSource &other)
 	{
@@ -146,6 +148,16 @@ public:
 	static void BeginPrecaching();
 	static void EndPrecaching();
 	static void RegisterForPrecache(FImageSource *img, bool requiretruecolor);
+	static void StartPrecacheDecoding();
+
+	struct PrecacheStats
+	{
+		int Threads;
+		int Decoded;		// images decoded by the precache jobs
+		double DecodeMS;	// total decoding time of these, summed over all threads
+		double WaitMS;		// time the main thread spent decoding or waiting for them
+	};
+	static PrecacheStats GetPrecacheStats();
 };
 
 
@@ -33,6 +33,17 @@
 **
 */
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <limits.h>
+
 #include "files.h"
 #include "templates.h"	// just for 'clamp'
 #include "zstring.h"
@@ -349,6 +360,86 @@ public:
 
 
 
+//==========================================================================
+//
+// MappedFileReader
+//
+// reads data from a memory mapping of a file. Since the entire file is
+// addressable, resource lumps can point into it instead of getting copied
+// to the heap. The mapping is copy-on-write, so code that modifies a cached
+// lump in place only gets a private copy of the affected pages.
+//
+//==========================================================================
+
+class MappedFileReader : public MemoryReader
+{
+	void *Mapping = nullptr;
+
+public:
+	MappedFileReader()
+	{}
+
+	~MappedFileReader()
+	{
+		if (Mapping != nullptr)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(Mapping);
+#else
+			munmap(Mapping, Length);
+#endif
+		}
+	}
+
+	bool Open(const char *filename)
+	{
+		if (sizeof(void*) < 8)
+		{
+			// Mapping whole resource files would eat up too much of a 32 bit address space.
+			return false;
+		}
+#ifdef _WIN32
+		auto widename = WideString(filename);
+		HANDLE file = CreateFileW(widename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		void *view = nullptr;
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart <= LONG_MAX)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+				CloseHandle(mapping);	// the view keeps the mapping alive.
+			}
+		}
+		CloseHandle(file);
+		if (view == nullptr) return false;
+		Length = (long)size.QuadPart;
+#else
+		int fd = open(filename, O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat info;
+		void *view = MAP_FAILED;
+		if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && info.st_size <= LONG_MAX)
+		{
+			view = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		}
+		close(fd);	// the mapping stays valid after the descriptor is gone.
+		if (view == MAP_FAILED) return false;
+		Length = (long)info.st_size;
+#endif
+		Mapping = view;
+		bufptr = (const char *)view;
+		FilePos = 0;
+		return true;
+	}
+};
+
+
+
 //==========================================================================
 //
 // FileReader
@@ -370,6 +461,19 @@ bool FileReader::OpenFile(const char *filename, FileReader::Size start, FileRead
 	return true;
 }
 
+bool FileReader::OpenMapped(const char *filename)
+{
+	auto reader = new MappedFileReader;
+	if (!reader->Open(filename))
+	{
+		delete reader;
+		return false;
+	}
+	Close();
+	mReader = reader;
+	return true;
+}
+
 bool FileReader::OpenFilePart(FileReader &parent, FileReader::Size start, FileReader::Size length)
 {
 	auto reader = new FileReaderRedirect(parent, (long)start, (long)length);
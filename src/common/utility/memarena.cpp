@@ -282,6 +282,69 @@ void *FMemArena::Block::Alloc(size_t size)
 	return res;
 }
 
+//==========================================================================
+//
+// FSlotArena Constructor
+//
+// Blocks start out small so that classes with only a few instances don't
+// waste much, and double in size up to maxslotsperblock slots.
+//
+//==========================================================================
+
+FSlotArena::FSlotArena(size_t slotsize, unsigned maxslotsperblock)
+	: FMemArena(0)
+{
+	SlotSize = (slotsize + 15) & ~15;
+	SlotsPerBlock = 8;
+	MaxSlotsPerBlock = maxslotsperblock;
+	BlockSize = SlotSize * SlotsPerBlock + sizeof(Block);	// the block header lives in the block, too
+}
+
+//==========================================================================
+//
+// FSlotArena :: Alloc
+//
+//==========================================================================
+
+void *FSlotArena::Alloc()
+{
+	void *mem;
+
+	if (FreeList != nullptr)
+	{
+		mem = FreeList;
+		FreeList = FreeList->Next;
+		NumFree--;
+	}
+	else
+	{
+		Block *top = TopBlock;
+		mem = iAlloc(SlotSize);
+		if (TopBlock != top && SlotsPerBlock < MaxSlotsPerBlock)
+		{
+			SlotsPerBlock *= 2;
+			BlockSize = SlotSize * SlotsPerBlock + sizeof(Block);
+		}
+	}
+	NumUsed++;
+	return mem;
+}
+
+//==========================================================================
+//
+// FSlotArena :: Free
+//
+//==========================================================================
+
+void FSlotArena::Free(void *mem)
+{
+	auto slot = (FreeSlot *)mem;
+	slot->Next = FreeList;
+	FreeList = slot;
+	NumUsed--;
+	NumFree++;
+}
+
 //==========================================================================
 //
 // FSharedStringArena Constructor
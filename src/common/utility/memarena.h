@@ -61,6 +61,37 @@ protected:
 	size_t BlockSize;
 };
 
+// An arena for slots of one fixed size, e.g. all instances of one class.
+// Freed slots go into a free list and get handed out again before the
+// arena grows, so the memory is never returned to the system.
+class FSlotArena : protected FMemArena
+{
+public:
+	FSlotArena(size_t slotsize, unsigned maxslotsperblock = 64);
+
+	void *Alloc();
+	void Free(void *mem);
+	size_t GetSlotSize() const { return SlotSize; }
+	unsigned UsedSlots() const { return NumUsed; }
+	unsigned FreeSlots() const { return NumFree; }
+	using FMemArena::DumpInfo;
+
+	bool Orphaned = false;		// the owner is gone, so the arena goes away with its last slot
+
+protected:
+	struct FreeSlot
+	{
+		FreeSlot *Next;
+	};
+
+	FreeSlot *FreeList = nullptr;
+	size_t SlotSize;
+	unsigned SlotsPerBlock;
+	unsigned MaxSlotsPerBlock;
+	unsigned NumUsed = 0;
+	unsigned NumFree = 0;
+};
+
 // An arena specializing in storage of FStrings. It knows how to free them,
 // but this means it also should never be used for allocating anything else.
 // Identical strings all return the same pointer.
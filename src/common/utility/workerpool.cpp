@@ -0,0 +1,208 @@
+/*
+** workerpool.cpp
+** The engine-wide pool of worker threads
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "workerpool.h"
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+class FWorkerThreads
+{
+public:
+	std::mutex QueueLock;
+	std::condition_variable QueueChanged;
+	std::deque<FWorkerJobPtr> Queue;
+	bool Stopping = false;
+
+	// Jobs signal their completion here. Waits are rare enough that
+	// they do not need their own condition variable per job.
+	std::mutex DoneLock;
+	std::condition_variable JobDone;
+
+	std::vector<std::thread> Threads;
+
+	FWorkerThreads()
+	{
+		int count = std::max<int>(1, std::thread::hardware_concurrency() - 1);
+		for (int i = 0; i < count; i++)
+		{
+			Threads.emplace_back([=]() { Worker(i + 1); });
+		}
+	}
+
+	~FWorkerThreads()
+	{
+		{
+			std::lock_guard<std::mutex> lock(QueueLock);
+			Stopping = true;
+		}
+		QueueChanged.notify_all();
+		for (auto &thread : Threads) thread.join();
+	}
+
+	void Worker(int index);
+};
+
+static thread_local int workerIndex;
+
+static FWorkerThreads &GetThreads()
+{
+	static FWorkerThreads threads;
+	return threads;
+}
+
+void FWorkerThreads::Worker(int index)
+{
+	workerIndex = index;
+	while (true)
+	{
+		FWorkerJobPtr job;
+		{
+			std::unique_lock<std::mutex> lock(QueueLock);
+			QueueChanged.wait(lock, [this]() { return Stopping || !Queue.empty(); });
+			// Whatever is still queued gets done before shutting down.
+			if (Queue.empty()) return;
+			job = std::move(Queue.front());
+			Queue.pop_front();
+		}
+		if (job->Claim()) job->Run();
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+bool FWorkerJob::Claim()
+{
+	int expected = Queued;
+	return State.compare_exchange_strong(expected, Running);
+}
+
+void FWorkerJob::Run()
+{
+	try
+	{
+		Func();
+	}
+	catch (...)
+	{
+		Exception = std::current_exception();
+	}
+	Func = nullptr;
+
+	auto &threads = GetThreads();
+	{
+		std::lock_guard<std::mutex> lock(threads.DoneLock);
+		State.store(Done, std::memory_order_release);
+	}
+	threads.JobDone.notify_all();
+}
+
+void FWorkerJob::Wait()
+{
+	if (Claim())
+	{
+		Run();
+	}
+	else if (!IsDone())
+	{
+		auto &threads = GetThreads();
+		std::unique_lock<std::mutex> lock(threads.DoneLock);
+		threads.JobDone.wait(lock, [this]() { return IsDone(); });
+	}
+	if (Exception)
+	{
+		std::rethrow_exception(Exception);
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FWorkerJobPtr FWorkerPool::Push(std::function<void()> func)
+{
+	auto job = std::make_shared<FWorkerJob>();
+	job->Func = std::move(func);
+
+	auto &threads = GetThreads();
+	{
+		std::lock_guard<std::mutex> lock(threads.QueueLock);
+		threads.Queue.push_back(job);
+	}
+	threads.QueueChanged.notify_one();
+	return job;
+}
+
+//==========================================================================
+//
+// Waits for a set of jobs that were pushed together. The workers take
+// the jobs from the front, so the caller helps out from the back before
+// it blocks for the ones that are already running.
+//
+//==========================================================================
+
+void FWorkerPool::WaitAll(std::vector<FWorkerJobPtr> &jobs)
+{
+	for (auto it = jobs.rbegin(); it != jobs.rend(); ++it)
+	{
+		if ((*it)->Claim()) (*it)->Run();
+	}
+	for (auto &job : jobs)
+	{
+		job->Wait();
+	}
+}
+
+int FWorkerPool::NumThreads()
+{
+	return (int)GetThreads().Threads.size();
+}
+
+int FWorkerPool::WorkerIndex()
+{
+	return workerIndex;
+}
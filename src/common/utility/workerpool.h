@@ -0,0 +1,103 @@
+/*
+** workerpool.h
+** The engine-wide pool of worker threads
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+** All systems that offload work to other threads share these workers
+** instead of each starting its own set of threads that then compete for
+** the same cores.
+**
+*/
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//==========================================================================
+//
+// A single job of the worker pool. Whoever claims it first runs it,
+// which is either a worker or the thread that waits for it.
+//
+//==========================================================================
+
+class FWorkerJob
+{
+	friend class FWorkerPool;
+	friend class FWorkerThreads;
+
+	enum
+	{
+		Queued,
+		Running,
+		Done
+	};
+
+	std::function<void()> Func;
+	std::atomic<int> State = { Queued };
+	std::exception_ptr Exception;
+
+	bool Claim();
+	void Run();
+
+public:
+	bool IsDone() const { return State.load(std::memory_order_acquire) == Done; }
+
+	// Runs the job right here if no worker has started it yet, otherwise
+	// blocks until it is finished. Exceptions thrown by the job are
+	// passed on to the caller.
+	void Wait();
+};
+
+using FWorkerJobPtr = std::shared_ptr<FWorkerJob>;
+
+//==========================================================================
+//
+// The threads get started on first use, one per spare core.
+//
+// Since a waiting thread runs the jobs it waits for if they have not been
+// picked up yet, waits never depend on how busy the workers are with
+// other systems' jobs, e.g. a long JIT compile or a savegame being written.
+//
+//==========================================================================
+
+class FWorkerPool
+{
+public:
+	static FWorkerJobPtr Push(std::function<void()> func);
+	static void WaitAll(std::vector<FWorkerJobPtr> &jobs);
+
+	static int NumThreads();
+
+	// 1..NumThreads() on the pool's threads, 0 on all others.
+	static int WorkerIndex();
+};
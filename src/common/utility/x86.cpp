@@ -65,6 +65,18 @@ FString DumpCPUInfo(const CPUInfo *cpu)
 #define __cpuid(output, func) __cpuidex(output, func, 0)
 #endif
 
+// Reads the register that tells which register sets the OS saves on a context switch.
+static uint64_t GetXCR0()
+{
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	uint32_t lo, hi;
+	__asm__ __volatile__("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+	return lo | (uint64_t(hi) << 32);
+#endif
+}
+
 void CheckCPUID(CPUInfo *cpu)
 {
 	int foo[4];
@@ -159,6 +171,18 @@ void CheckCPUID(CPUInfo *cpu)
 		__cpuidex(foo, 7, 1);
 		cpu->FeatureFlags[7] = foo[0];
 	}
+
+	// The AVX instructions can only be used if the OS saves the YMM (and for
+	// AVX-512 also the ZMM and mask) registers. Otherwise they fault.
+	uint64_t xcr0 = cpu->bOSXSAVE ? GetXCR0() : 0;
+	if ((xcr0 & 0x06) != 0x06)
+	{
+		cpu->bAVX = cpu->bAVX2 = cpu->bFMA3 = cpu->bF16C = 0;
+	}
+	if ((xcr0 & 0xe6) != 0xe6)
+	{
+		cpu->bAVX512_F = 0;	// all other AVX-512 extensions require this one
+	}
 }
 
 FString DumpCPUInfo(const CPUInfo *cpu)
@@ -231,5 +231,13 @@ extern CPUInfo CPU;
 void CheckCPUID (CPUInfo *cpu);
 FString DumpCPUInfo (const CPUInfo *cpu);
 
+// Lets GCC and Clang compile a single function for AVX2 without doing so for
+// the rest of the engine. Such functions may only be called if CPU.bAVX2 is set.
+#if !defined(NO_SSE) && defined(__GNUC__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
 #endif
 
@@ -64,6 +64,7 @@
 #include "i_sound.h"
 #include "i_video.h"
 #include "g_game.h"
+#include "g_benchmark.h"
 #include "hu_stuff.h"
 #include "wi_stuff.h"
 #include "st_stuff.h"
@@ -482,6 +483,7 @@ void D_Render(std::function<void()> action, bool interpolate)
 		else Level->HasDynamicLights = false;	// lights are off so effectively we have none.
 		if (interpolate) Level->interpolator.DoInterpolations(I_GetTimeFrac());
 		P_FindParticleSubsectors(Level);
+		if (Level->HasDynamicLights) Level->LightGrid.Update(Level);
 		PO_LinkToSubsectors(Level);
 	}
 	action();
@@ -3118,6 +3120,11 @@ static int D_DoomMain_Internal (void)
 		}
 		Printf("\n");
 	}
+	if (Args->CheckParm("-benchmark") && !Args->CheckParm("-nosound"))
+	{
+		// Benchmarks need to run on machines without a sound device.
+		Args->AppendArg("-nosound");
+	}
 
 	if (Args->CheckParm("-hashfiles"))
 	{
@@ -3573,7 +3580,12 @@ static int D_DoomMain_Internal (void)
 				return 1337; // special exit
 			}
 
-			V_Init2();
+			// Benchmarks run on machines without a video device, so they keep the
+			// stand-in framebuffer from V_InitScreen and never draw anything.
+			if (!Args->CheckParm("-benchmark"))
+			{
+				V_Init2();
+			}
 			twod->fullscreenautoaspect = gameinfo.fullscreenautoaspect;
 			// Initialize the size of the 2D drawer so that an attempt to access it outside the draw code won't crash.
 			twod->Begin(screen->GetWidth(), screen->GetHeight());
@@ -3600,11 +3612,18 @@ static int D_DoomMain_Internal (void)
 			else
 			{
 				v = Args->CheckValue("-timedemo");
+				FString *benchdemos;
+				int numbenchdemos = Args->CheckParmList("-benchmark", &benchdemos);
 				if (v)
 				{
 					G_TimeDemo(v);
 					D_DoomLoop();	// never returns
 				}
+				else if (numbenchdemos > 0)
+				{
+					G_StartBenchmark(numbenchdemos, benchdemos, Args->CheckValue("-benchout"));
+					D_DoomLoop();	// never returns
+				}
 				else
 				{
 					if (gameaction != ga_loadgame && gameaction != ga_loadgamehidecon)
@@ -3718,6 +3737,8 @@ int GameMain()
 
 void D_Cleanup()
 {
+	G_FinishSaveGame(true);
+
 	if (demorecording)
 	{
 		G_CheckDemoStatus();
@@ -0,0 +1,314 @@
+/*
+** g_benchmark.cpp
+** Batch demo benchmarking with machine readable output
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** -benchmark demo1 [demo2 ...] plays all given demos back to back like
+** -timedemo, without a video or sound device, and writes the timing of
+** every playsim tic, broken down by the existing profiling clocks, as
+** JSON to the file given with -benchout (default: benchmark.json).
+**
+*/
+
+#define RAPIDJSON_48BITPOINTER_OPTIMIZATION 0	// disable this insanity which is bound to make the code break over time.
+#define RAPIDJSON_HAS_CXX11_RVALUE_REFS 1
+#define RAPIDJSON_HAS_CXX11_RANGE_FOR 1
+
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/prettywriter.h"
+#include "doomdef.h"
+#include "doomstat.h"
+#include "stats.h"
+#include "files.h"
+#include "printf.h"
+#include "engineerrors.h"
+#include "version.h"
+#include "i_time.h"
+#include "m_argv.h"
+#include "g_game.h"
+#include "g_benchmark.h"
+
+extern cycle_t ThinkCycles, SightCycles, TryMoveCycles, ParticleCycles, ACSTime;
+extern cycle_t VMCycles[10];
+
+// The clocks a tic gets broken down into. Must match the order in BenchClockNames.
+enum
+{
+	BC_Total,
+	BC_Thinkers,
+	BC_Sight,
+	BC_TryMove,
+	BC_ACS,
+	BC_VM,
+	BC_Particles,
+	NUM_BENCHCLOCKS
+};
+
+static const char *BenchClockNames[] = { "total", "thinkers", "sight", "trymove", "acs", "vm", "particles" };
+
+struct FBenchmarkRun
+{
+	FString Demo;
+	int RealTics;
+	size_t PeakMemory;
+	TArray<float> Times[NUM_BENCHCLOCKS];	// per-tic times in ms
+};
+
+static TArray<FString> BenchDemos;
+static TArray<FBenchmarkRun> BenchRuns;
+static FString BenchOutput;
+static unsigned BenchCurrent;
+static bool BenchActive;
+static cycle_t TicCycles;
+static double VMTimeAtStart;
+
+//==========================================================================
+//
+// Peak resident memory of the process in bytes
+//
+//==========================================================================
+
+static size_t GetPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef __APPLE__
+		return usage.ru_maxrss;			// macOS reports bytes
+#else
+		return usage.ru_maxrss * 1024;	// everybody else reports kilobytes
+#endif
+	}
+	return 0;
+#endif
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static void StartDemo()
+{
+	auto &run = BenchRuns[BenchRuns.Reserve(1)];
+	run.Demo = BenchDemos[BenchCurrent];
+	run.RealTics = 0;
+	run.PeakMemory = 0;
+	G_TimeDemo(BenchDemos[BenchCurrent]);
+	// This is a playsim benchmark so rendering is always off.
+	nodrawers = noblit = true;
+}
+
+void G_StartBenchmark(int numdemos, const FString *demos, const char *outfile)
+{
+	BenchDemos.Clear();
+	BenchRuns.Clear();
+	for (int i = 0; i < numdemos; i++)
+	{
+		BenchDemos.Push(demos[i]);
+	}
+	if (BenchDemos.Size() == 0)
+	{
+		I_FatalError("-benchmark: No demos specified\n");
+	}
+	BenchOutput = outfile != nullptr ? outfile : "benchmark.json";
+	BenchCurrent = 0;
+	BenchActive = true;
+	StartDemo();
+}
+
+bool G_BenchmarkActive()
+{
+	return BenchActive;
+}
+
+//==========================================================================
+//
+// Brackets a single playsim tic.
+//
+//==========================================================================
+
+void G_BenchmarkBeginTic()
+{
+	if (!BenchActive || !demoplayback) return;
+
+	TryMoveCycles.Reset();
+	ParticleCycles.Reset();
+	VMTimeAtStart = VMCycles[0].TimeMS();
+	TicCycles.Reset();
+	TicCycles.Clock();
+}
+
+void G_BenchmarkEndTic()
+{
+	if (!BenchActive || !demoplayback) return;
+
+	TicCycles.Unclock();
+
+	auto &run = BenchRuns.Last();
+	run.Times[BC_Total].Push((float)TicCycles.TimeMS());
+	run.Times[BC_Thinkers].Push((float)ThinkCycles.TimeMS());
+	run.Times[BC_Sight].Push((float)SightCycles.TimeMS());
+	run.Times[BC_TryMove].Push((float)TryMoveCycles.TimeMS());
+	run.Times[BC_ACS].Push((float)ACSTime.TimeMS());
+	// The VM clock is a rolling counter that only gets reset by 'stat vm'.
+	run.Times[BC_VM].Push((float)std::max(0., VMCycles[0].TimeMS() - VMTimeAtStart));
+	run.Times[BC_Particles].Push((float)ParticleCycles.TimeMS());
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+template<class W>
+static void WriteStats(W &w, TArray<float> &times)
+{
+	TArray<float> sorted = times;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0;
+	for (auto t : sorted) total += t;
+
+	auto percentile = [&](double p) -> double
+	{
+		if (sorted.Size() == 0) return 0;
+		unsigned index = (unsigned)(p * (sorted.Size() - 1) + 0.5);
+		return sorted[index];
+	};
+
+	w.StartObject();
+	w.Key("total");	w.Double(total);
+	w.Key("mean");	w.Double(sorted.Size() ? total / sorted.Size() : 0.);
+	w.Key("p50");	w.Double(percentile(0.5));
+	w.Key("p90");	w.Double(percentile(0.9));
+	w.Key("p99");	w.Double(percentile(0.99));
+	w.Key("max");	w.Double(sorted.Size() ? sorted.Last() : 0.f);
+	w.EndObject();
+}
+
+static void WriteResults(bool pertic)
+{
+	rapidjson::StringBuffer buffer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> w(buffer);
+
+	w.StartObject();
+	w.Key("version");	w.String(GetVersionString());
+	w.Key("runs");
+	w.StartArray();
+	for (auto &run : BenchRuns)
+	{
+		w.StartObject();
+		w.Key("demo");			w.String(run.Demo.GetChars());
+		w.Key("tics");			w.Uint(run.Times[BC_Total].Size());
+		w.Key("realtics");		w.Int(run.RealTics);
+		w.Key("peakmemory");	w.Uint64(run.PeakMemory);
+		w.Key("clocks");
+		w.StartObject();
+		for (int i = 0; i < NUM_BENCHCLOCKS; i++)
+		{
+			w.Key(BenchClockNames[i]);
+			WriteStats(w, run.Times[i]);
+		}
+		w.EndObject();
+		if (pertic)
+		{
+			// One array of times in ms per clock so that the output stays compact.
+			w.Key("pertic");
+			w.StartObject();
+			for (int i = 0; i < NUM_BENCHCLOCKS; i++)
+			{
+				w.Key(BenchClockNames[i]);
+				w.StartArray();
+				for (auto t : run.Times[i]) w.Double(t);
+				w.EndArray();
+			}
+			w.EndObject();
+		}
+		w.EndObject();
+	}
+	w.EndArray();
+	w.EndObject();
+
+	auto fw = FileWriter::Open(BenchOutput);
+	if (fw == nullptr)
+	{
+		I_FatalError("Unable to write benchmark results to %s\n", BenchOutput.GetChars());
+	}
+	fw->Write(buffer.GetString(), buffer.GetSize());
+	delete fw;
+}
+
+//==========================================================================
+//
+// Called from G_CheckDemoStatus when a timed demo ends. Returns true if
+// another demo was started.
+//
+//==========================================================================
+
+bool G_BenchmarkNextDemo()
+{
+	if (!BenchActive) return false;
+
+	extern int starttime;
+	auto &run = BenchRuns.Last();
+	run.RealTics = I_GetTime() - starttime;
+	run.PeakMemory = GetPeakMemory();
+	Printf("%s: %u tics, %.2f ms/tic\n", run.Demo.GetChars(), run.Times[BC_Total].Size(),
+		run.Times[BC_Total].Size() ? run.RealTics * 1000. / TICRATE / run.Times[BC_Total].Size() : 0.);
+
+	if (++BenchCurrent < BenchDemos.Size())
+	{
+		StartDemo();
+		return true;
+	}
+
+	BenchActive = false;
+	WriteResults(!!Args->CheckParm("-benchpertic"));
+	Printf("Benchmark results written to %s\n", BenchOutput.GetChars());
+	throw CExitEvent(0);
+}
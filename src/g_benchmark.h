@@ -0,0 +1,10 @@
+#ifndef __G_BENCHMARK_H
+#define __G_BENCHMARK_H
+
+void G_StartBenchmark(int numdemos, const FString *demos, const char *outfile);
+bool G_BenchmarkActive();
+void G_BenchmarkBeginTic();
+void G_BenchmarkEndTic();
+bool G_BenchmarkNextDemo();
+
+#endif
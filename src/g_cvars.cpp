@@ -48,7 +48,8 @@ void I_UpdateWindowTitle();
 CVAR (Bool, cl_spreaddecals, true, CVAR_ARCHIVE)
 CVAR(Bool, var_pushers, true, CVAR_SERVERINFO);
 CVAR(Bool, gl_cachenodes, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
-CVAR(Float, gl_cachetime, 0.6f, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Float, gl_cachetime, 0.f, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Int, gl_cachesize, 64, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// in megabytes, 0 for no limit
 CVAR(Bool, alwaysapplydmflags, false, CVAR_SERVERINFO);
 
 // [RH] Feature control cvars
@@ -126,8 +127,8 @@ CUSTOM_CVAR(Int, r_maxparticles, 4000, CVAR_ARCHIVE | CVAR_NOINITCALL)
 {
 	if (self == 0)
 		self = 4000;
-	else if (self > 65535)
-		self = 65535;
+	else if (self > MAX_PARTICLES)
+		self = MAX_PARTICLES;
 	else if (self < 100)
 		self = 100;
 
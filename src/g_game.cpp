@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <memory>
+#include <atomic>
 
 #include "i_time.h"
 #include "templates.h"
@@ -86,6 +87,8 @@
 #include "d_buttons.h"
 #include "hwrenderer/scene/hw_drawinfo.h"
 #include "doommenu.h"
+#include "g_benchmark.h"
+#include "workerpool.h"
 
 
 static FRandom pr_dmspawn ("DMSpawn");
@@ -111,12 +114,14 @@ bool WriteZip(const char *filename, TArray<FString> &filenames, TArray<FCompress
 
 FIntCVar gameskill ("skill", 2, CVAR_SERVERINFO|CVAR_LATCH);
 CVAR(Bool, save_formatted, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// use formatted JSON for saves (more readable but a larger files and a bit slower.
+CVAR(Bool, save_binary, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// use the binary format for the level snapshots and globals. Switch it off to get JSON for debugging.
 CVAR (Int, deathmatch, 0, CVAR_SERVERINFO|CVAR_LATCH);
 CVAR (Bool, chasedemo, false, 0);
 CVAR (Bool, storesavepic, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (Bool, longsavemessages, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (String, save_dir, "", CVAR_ARCHIVE|CVAR_GLOBALCONFIG);
 CVAR (Bool, cl_waitforsave, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
+CVAR (Bool, save_async, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);	// compress and write savegames on a worker thread
 CVAR (Bool, enablescriptscreenshot, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 EXTERN_CVAR (Float, con_midtime);
 
@@ -139,6 +144,7 @@ CUSTOM_CVAR (Int, displaynametags, 0, CVAR_ARCHIVE)
 CVAR(Int, nametagcolor, CR_GOLD, CVAR_ARCHIVE)
 
 extern bool playedtitlemusic;
+extern thread_local TArray<std::pair<int, FString>> *DeferredPrints;
 
 gameaction_t	gameaction;
 gamestate_t 	gamestate = GS_STARTUP;
@@ -1129,6 +1135,8 @@ void G_Ticker ()
 		AddCommandString ("toggle vid_fullscreen");
 	}
 
+	G_FinishSaveGame(false);
+
 	// do things to change the game state
 	oldgamestate = gamestate;
 	while (gameaction != ga_nothing)
@@ -1285,7 +1293,9 @@ void G_Ticker ()
 	switch (gamestate)
 	{
 	case GS_LEVEL:
+		G_BenchmarkBeginTic ();
 		P_Ticker ();
+		G_BenchmarkEndTic ();
 		primaryLevel->automap->Ticker ();
 		break;
 
@@ -1965,6 +1975,8 @@ void G_DoLoadGame ()
 	hidecon = gameaction == ga_loadgamehidecon;
 	gameaction = ga_nothing;
 
+	G_FinishSaveGame(true);
+
 	std::unique_ptr<FResourceFile> resfile(FResourceFile::OpenResourceFile(savename.GetChars(), true, true));
 	if (resfile == nullptr)
 	{
@@ -2316,6 +2328,113 @@ static void PutSavePic (FileWriter *file, int width, int height)
 	}
 }
 
+//==========================================================================
+//
+// Savegames are written in two halves: The game thread serializes
+// everything into memory, and a worker compresses the JSON and writes the
+// zip, so that saving on big maps does not stall the game. Only one save
+// can be in flight, so starting another one, loading a game or shutting
+// down waits for it. The worker writes to a temporary file which only
+// replaces the savegame once it is complete, so the load menu never sees
+// a half written file.
+//
+//==========================================================================
+
+struct FSaveGameJob
+{
+	FString Filename;
+	FString TempFilename;
+	FString Description;
+	bool OkForQuicksave;
+	bool ForceQuicksave;
+	TArray<FString> Filenames;
+	TArray<FCompressedBuffer> Content;	// owned copies
+	TArray<std::pair<int, FString>> Messages;
+	bool Written = false;
+	std::atomic<bool> Done{ false };
+
+	~FSaveGameJob()
+	{
+		for (auto &buff : Content) buff.Clean();
+	}
+
+	void Write()
+	{
+		DeferredPrints = &Messages;
+		// The first entry is the savepic, which is compressed already.
+		for (unsigned i = 1; i < Content.Size(); i++)
+		{
+			CompressBuffer(Content[i]);
+		}
+		Written = WriteZip(TempFilename, Filenames, Content);
+		DeferredPrints = nullptr;
+		Done = true;
+	}
+};
+
+static std::shared_ptr<FSaveGameJob> SaveGameJob;
+static FWorkerJobPtr SaveGameFinished;
+
+//==========================================================================
+//
+// Reports the result of the last save once the worker is done with it.
+// Unless 'wait' is set, this returns right away if it is still busy.
+//
+//==========================================================================
+
+void G_FinishSaveGame(bool wait)
+{
+	if (SaveGameJob == nullptr) return;
+	if (!SaveGameJob->Done)
+	{
+		if (!wait) return;
+		SaveGameFinished->Wait();
+	}
+
+	auto job = std::move(SaveGameJob);
+	SaveGameJob = nullptr;
+
+	for (auto &msg : job->Messages)
+	{
+		PrintString(msg.first, msg.second.GetChars());
+	}
+
+	bool succeeded = false;
+
+	if (job->Written)
+	{
+		// Check whether the file is ok by trying to open it.
+		FResourceFile *test = FResourceFile::OpenResourceFile(job->TempFilename, true);
+		if (test != nullptr)
+		{
+			delete test;
+			// Not every platform's rename replaces an existing file.
+			succeeded = rename(job->TempFilename, job->Filename) == 0;
+			if (!succeeded && remove(job->Filename) == 0)
+			{
+				succeeded = rename(job->TempFilename, job->Filename) == 0;
+			}
+		}
+	}
+	if (!succeeded)
+	{
+		remove(job->TempFilename);
+	}
+
+	if (succeeded)
+	{
+		savegameManager.NotifyNewSave(job->Filename, job->Description, job->OkForQuicksave, job->ForceQuicksave);
+		BackupSaveName = job->Filename;
+
+		if (longsavemessages) Printf("%s (%s)\n", GStrings("GGSAVED"), job->Filename.GetChars());
+		else Printf("%s\n", GStrings("GGSAVED"));
+	}
+	else
+	{
+		Printf(PRINT_HIGH, "%s\n", GStrings("TXT_SAVEFAILED"));
+	}
+}
+
 void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, const char *description)
 {
 	TArray<FCompressedBuffer> savegame_content;
@@ -2330,6 +2449,8 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 		return;
 	}
 
+	G_FinishSaveGame(true);
+
 	if (demoplayback)
 	{
 		filename = G_BuildSaveName ("demosave." SAVEGAME_EXT, -1);
@@ -2341,7 +2462,7 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 	insave = true;
 	try
 	{
-		level.SnapshotLevel();
+		level.SnapshotLevel(false);
 	}
 	catch(CRecoverableError &err)
 	{
@@ -2368,7 +2489,7 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 	FSerializer savegameglobals;	// and this for non-level related info that must be saved.
 
 	savegameinfo.OpenWriter(true);
-	savegameglobals.OpenWriter(save_formatted);
+	savegameglobals.OpenWriter(save_formatted, save_binary);
 
 	SaveVersion = SAVEVER;
 	PutSavePic(&savepic, SAVEPICWIDTH, SAVEPICHEIGHT);
@@ -2418,49 +2539,46 @@ void G_DoSaveGame (bool okForQuicksave, bool forceQuicksave, FString filename, c
 
 	savegame_content.Push(bufpng);
 	savegame_filenames.Push("savepic.png");
-	savegame_content.Push(savegameinfo.GetCompressedOutput());
+	savegame_content.Push(savegameinfo.GetStoredOutput());
 	savegame_filenames.Push("info.json");
-	savegame_content.Push(savegameglobals.GetCompressedOutput());
+	savegame_content.Push(savegameglobals.GetStoredOutput());
 	savegame_filenames.Push("globals.json");
 
 	G_WriteSnapshots (savegame_filenames, savegame_content);
-	
 
-	bool succeeded = false;
+	auto job = std::make_shared<FSaveGameJob>();
+	job->Filename = filename;
+	job->TempFilename = filename + ".tmp";
+	job->Description = description;
+	job->OkForQuicksave = okForQuicksave;
+	job->ForceQuicksave = forceQuicksave;
+	job->Filenames = std::move(savegame_filenames);
 
-	if (WriteZip(filename, savegame_filenames, savegame_content))
+	// The JSON buffers created just above and the snapshot of the current level
+	// can be handed over. The other levels' snapshots still belong to the game
+	// and must be copied.
+	for (unsigned i = 0; i < savegame_content.Size(); i++)
 	{
-		// Check whether the file is ok by trying to open it.
-		FResourceFile *test = FResourceFile::OpenResourceFile(filename, true);
-		if (test != nullptr)
+		FCompressedBuffer buff = savegame_content[i];
+		if (i != 1 && i != 2 && buff.mBuffer != level.info->Snapshot.mBuffer)
 		{
-			delete test;
-			succeeded = true;
+			buff.mBuffer = new char[buff.mCompressedSize];
+			memcpy(buff.mBuffer, savegame_content[i].mBuffer, buff.mCompressedSize);
 		}
+		job->Content.Push(buff);
 	}
 
-	if (succeeded)
-	{
-		savegameManager.NotifyNewSave(filename, description, okForQuicksave, forceQuicksave);
-		BackupSaveName = filename;
+	// We don't need the snapshot any longer.
+	level.info->Snapshot.mBuffer = nullptr;
+	level.info->Snapshot.Clean();
 
-		if (longsavemessages) Printf("%s (%s)\n", GStrings("GGSAVED"), filename.GetChars());
-		else Printf("%s\n", GStrings("GGSAVED"));
-	}
-	else
+	SaveGameJob = job;
+	SaveGameFinished = FWorkerPool::Push([job]() { job->Write(); });
+	if (!save_async)
 	{
-		Printf(PRINT_HIGH, "%s\n", GStrings("TXT_SAVEFAILED"));
+		G_FinishSaveGame(true);
 	}
 
-
-	// delete the JSON buffers we created just above. Everything else will
-	// either still be needed or taken care of automatically.
-	savegame_content[1].Clean();
-	savegame_content[2].Clean();
-
-	// We don't need the snapshot any longer.
-	level.info->Snapshot.Clean();
-		
 	insave = false;
 
 	if (cl_waitforsave)
@@ -2998,6 +3116,10 @@ bool G_CheckDemoStatus (void)
 		}
 		if (singledemo || timingdemo)
 		{
+			if (timingdemo && G_BenchmarkNextDemo())
+			{
+				return true;
+			}
 			if (timingdemo)
 			{
 				// Trying to get back to a stable state after timing a demo
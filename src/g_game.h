@@ -63,6 +63,7 @@ void G_DoLoadGame (void);
 
 // Called by M_Responder.
 void G_SaveGame (const char *filename, const char *description);
+void G_FinishSaveGame (bool wait);
 // Called by messagebox
 void G_DoQuickSave ();
 
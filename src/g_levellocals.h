@@ -54,6 +54,7 @@
 #include "r_data/r_sections.h"
 #include "r_data/r_canvastexture.h"
 #include "r_data/r_interpolate.h"
+#include "r_data/r_lightgrid.h"
 #include "doom_aabbtree.h"
 
 //============================================================================
@@ -169,7 +170,7 @@ private:
 	void PlayerSpawnPickClass (int playernum);
 
 public:
-	void SnapshotLevel();
+	void SnapshotLevel(bool compress = true);
 	void UnSnapshotLevel(bool hubLoad);
 
 	void FinalizePortals();
@@ -631,10 +632,8 @@ public:
 	DSeqNode *SequenceListHead;
 
 	// [RH] particle globals
-	uint32_t			ActiveParticles;
-	uint32_t			InactiveParticles;
-	TArray<particle_t>	Particles;
-	TArray<uint16_t>	ParticlesInSubsec;
+	FParticles			Particles;
+	TArray<uint32_t>	ParticlesInSubsec;
 	FThinkerCollection Thinkers;
 
 	TArray<DVector2>	Scrolls;		// NULL if no DScrollers in this level
@@ -666,6 +665,7 @@ public:
 	int			ImpactDecalCount;
 
 	FDynamicLight *lights;
+	FLightGrid LightGrid;
 
 	// links to global game objects
 	TArray<TObjPtr<AActor *>> CorpseQueue;
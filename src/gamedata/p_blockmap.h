@@ -15,6 +15,7 @@ struct FBlockNode
 	FBlockNode *NextActor;			// next actor in this block
 	FBlockNode **PrevBlock;			// previous block this actor is in
 	FBlockNode *NextBlock;			// next block this actor is in
+	int ThingIndex;					// index into the block's FBlockThings arrays
 
 	static FBlockNode *Create (AActor *who, int x, int y, int group = -1);
 	void Release ();
@@ -22,6 +23,22 @@ struct FBlockNode
 	static FBlockNode *FreeBlocks;
 };
 
+// Contiguous copy of a block's actor chain, so that FBlockThingsIterator
+// doesn't need to chase FBlockNode pointers through the arena. New actors
+// get appended and unlinked ones are only cleared, so walking the arrays
+// backwards visits the actors in exactly the same order as the chain.
+// The holes are compacted once per tic when no iterator can be active,
+// and right away when a block collects too many of them while nothing
+// depends on the arrays' layout.
+struct FBlockThings
+{
+	TArray<AActor *> Actors;		// nullptr for unlinked entries
+	TArray<uint8_t> SingleBlock;	// the actor is not linked into any other block
+	TArray<FBlockNode *> Nodes;
+	int NumHoles = 0;
+	bool Dirty = false;
+};
+
 // BLOCKMAP
 // Created from axis aligned bounding box
 // of the map, a rectangular array of
@@ -40,6 +57,9 @@ struct FBlockmap
 	double				bmaporgx;
 	double				bmaporgy;		// origin of block map
 	FBlockNode**		blocklinks; 	// for thing chains
+	FBlockThings*		blockthings = nullptr;	// same as blocklinks, as arrays
+	TArray<int>			dirtythings;	// blocks in blockthings that need compacting
+	int					thinglocks = 0;	// iterators and predicted players that need blockthings to stay as it is
 
 	// mapblocks are used to check movement
 	// against lines and things
@@ -75,6 +95,13 @@ struct FBlockmap
 
 	bool VerifyBlockMap(int count, unsigned numlines);
 
+	void LinkThing(FBlockNode *node);
+	void UnlinkThing(FBlockNode *node);
+	void RestoreThing(FBlockNode *node);
+	void SetSingleBlock(FBlockNode *node);
+	void CompactThings();
+	void CompactBlock(FBlockThings &block);
+
 	void Clear()
 	{
 		if (blockmaplump != nullptr)
@@ -87,6 +114,12 @@ struct FBlockmap
 			delete[] blocklinks;
 			blocklinks = nullptr;
 		}
+		if (blockthings != nullptr)
+		{
+			delete[] blockthings;
+			blockthings = nullptr;
+		}
+		dirtythings.Clear();
 	}
 
 	~FBlockmap()
@@ -63,6 +63,7 @@
 
 EXTERN_CVAR(Bool, gl_cachenodes)
 EXTERN_CVAR(Float, gl_cachetime)
+EXTERN_CVAR(Int, gl_cachesize)
 
 // fixed 32 bit gl_vert format v2.0+ (glBsp 1.91)
 struct mapglvertex_t
@@ -1011,6 +1012,58 @@ static FString CreateCacheName(MapData *map, bool create)
 	return path;
 }
 
+//==========================================================================
+//
+// Keeps the node cache below gl_cachesize megabytes by deleting the
+// oldest files. The one that was just written is always kept.
+//
+//==========================================================================
+
+static void TrimNodeCache(const FString &keep)
+{
+	if (gl_cachesize <= 0) return;
+
+	TArray<FFileList> list;
+	FString path = M_GetCachePath(false);
+	path += "/";
+	if (!ScanDirectory(list, path)) return;
+
+	struct FCacheFile
+	{
+		FString Filename;
+		size_t Size;
+		time_t Time;
+	};
+	TArray<FCacheFile> files;
+	uint64_t total = 0;
+	for (auto &entry : list)
+	{
+		size_t size;
+		time_t time;
+		if (!entry.isDirectory && entry.Filename.Len() > 4 && entry.Filename.Right(4).CompareNoCase(".gzc") == 0 &&
+			GetFileInfo(entry.Filename, &size, &time))
+		{
+			files.Push({ entry.Filename, size, time });
+			total += size;
+		}
+	}
+
+	uint64_t limit = uint64_t(gl_cachesize) * 1024 * 1024;
+	if (total <= limit) return;
+
+	std::sort(files.begin(), files.end(), [](const FCacheFile &a, const FCacheFile &b) { return a.Time < b.Time; });
+	for (auto &file : files)
+	{
+		if (total <= limit) break;
+		if (file.Filename.Compare(keep) == 0) continue;
+		if (remove(file.Filename) == 0)
+		{
+			DPrintf(DMSG_NOTIFY, "Removed %s from the node cache\n", file.Filename.GetChars());
+			total -= file.Size;
+		}
+	}
+}
+
 static void WriteByte(MemFile &f, uint8_t b)
 {
 	f.Push(b);
@@ -1134,6 +1187,7 @@ void MapLoader::CreateCachedNodes(MapData *map)
 			Printf("Error saving nodes to file %s\n", path.GetChars());
 		}
 		delete fw;
+		TrimNodeCache(path);
 	}
 	else
 	{
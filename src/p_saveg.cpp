@@ -34,6 +34,8 @@
 */
 
 
+#include <chrono>
+
 #include "p_local.h"
 #include "p_spec.h"
 
@@ -61,8 +63,11 @@
 #include "version.h"
 #include "fragglescript/t_script.h"
 #include "s_music.h"
+#include "c_dispatch.h"
+#include "gamestate.h"
 
 EXTERN_CVAR(Bool, save_formatted)
+EXTERN_CVAR(Bool, save_binary)
 
 //==========================================================================
 //
@@ -1067,11 +1072,12 @@ void FLevelLocals::Serialize(FSerializer &arc, bool hubload)
 
 //==========================================================================
 //
-// Archives the current level
+// Archives the current level. Savegames leave the compression to the
+// thread that writes the file.
 //
 //==========================================================================
 
-void FLevelLocals::SnapshotLevel()
+void FLevelLocals::SnapshotLevel(bool compress)
 {
 	info->Snapshot.Clean();
 
@@ -1079,11 +1085,11 @@ void FLevelLocals::SnapshotLevel()
 	{
 		FDoomSerializer arc(this);
 
-		if (arc.OpenWriter(save_formatted))
+		if (arc.OpenWriter(save_formatted, save_binary))
 		{
 			SaveVersion = SAVEVER;
 			Serialize(arc, false);
-			info->Snapshot = arc.GetCompressedOutput();
+			info->Snapshot = compress ? arc.GetCompressedOutput() : arc.GetStoredOutput();
 		}
 	}
 }
@@ -1148,3 +1154,53 @@ void FLevelLocals::UnSnapshotLevel(bool hubLoad)
 	}
 }
 
+//==========================================================================
+//
+// Compares the snapshot formats on the current level. Reading only
+// covers building the document because everything after that is the
+// same for both formats and would replace the running level.
+//
+//==========================================================================
+
+CCMD(bench_savegame)
+{
+	if (gamestate != GS_LEVEL)
+	{
+		Printf("You must be in a level to compare the savegame formats.\n");
+		return;
+	}
+	int runs = argv.argc() > 1 ? max(atoi(argv[1]), 1) : 5;
+
+	for (int binary = 0; binary < 2; binary++)
+	{
+		FCompressedBuffer buff = { 0, 0, METHOD_STORED, 0, 0, nullptr };
+		double writems = 0, readms = 0;
+
+		for (int i = 0; i < runs; i++)
+		{
+			buff.Clean();
+			auto start = std::chrono::steady_clock::now();
+			{
+				FDoomSerializer arc(primaryLevel);
+				arc.OpenWriter(false, !!binary);
+				SaveVersion = SAVEVER;
+				primaryLevel->Serialize(arc, false);
+				buff = arc.GetStoredOutput();
+			}
+			auto mid = std::chrono::steady_clock::now();
+			{
+				FSerializer arc;
+				arc.OpenReader(&buff);
+			}
+			auto end = std::chrono::steady_clock::now();
+			writems += std::chrono::duration<double, std::milli>(mid - start).count();
+			readms += std::chrono::duration<double, std::milli>(end - mid).count();
+		}
+
+		unsigned size = buff.mSize;
+		CompressBuffer(buff);
+		Printf("%-6s write %8.2f ms, read %8.2f ms, %9u bytes, %9u compressed\n", binary ? "Binary" : "JSON", writems / runs, readms / runs, size, buff.mCompressedSize);
+		buff.Clean();
+	}
+}
+
@@ -152,7 +152,8 @@ static void AddToList(uint8_t *hitlist, FTextureID texid, int bitmask)
 
 static void PrecacheLevel(FLevelLocals *Level)
 {
-	if (demoplayback)
+	// Nothing to upload to when running on the stand-in framebuffer of -benchmark.
+	if (demoplayback || screen->RenderState() == nullptr)
 		return;
 
 	int i;
@@ -328,6 +329,7 @@ void FLevelLocals::ClearLevelData()
 	FraggleScriptThinker = nullptr;
 	CorpseQueue.Clear();
 	canvasTextureInfo.EmptyList();
+	LightGrid.Clear();
 	sections.Clear();
 	segs.Clear();
 	extsectors.Clear();
@@ -154,6 +154,9 @@ void P_Ticker (void)
 		auto it = Level->GetThinkerIterator<AActor>();
 		AActor *ac;
 
+		// No blockmap iterator can be active here so this is the place to remove the holes from the thing arrays.
+		Level->blockmap.CompactThings();
+
 		while ((ac = it.Next()))
 		{
 			ac->ClearInterpolation();
@@ -209,6 +209,7 @@ void FDynamicLight::ReleaseLight()
 	else Level->lights = next;
 	if (next != nullptr) next->prev = prev;
 	next = prev = nullptr;
+	Level->LightGrid.MarkDirty();
 	FreeList.Push(this);
 }
 
@@ -662,6 +663,8 @@ void FDynamicLight::LinkLight()
 {
 	// mark the old light nodes
 	FLightNode * node;
+
+	Level->LightGrid.MarkDirty();
 	
 	node = touching_sides;
 	while (node)
@@ -721,6 +724,7 @@ void FDynamicLight::LinkLight()
 //==========================================================================
 void FDynamicLight::UnlinkLight ()
 {
+	Level->LightGrid.MarkDirty();
 	while (touching_sides) touching_sides = DeleteLightNode(touching_sides);
 	while (touching_sector) touching_sector = DeleteLightNode(touching_sector);
 	shadowmapped = false;
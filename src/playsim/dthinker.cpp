@@ -45,7 +45,7 @@
 
 
 static int ThinkCount;
-static cycle_t ThinkCycles;
+cycle_t ThinkCycles;
 extern cycle_t BotSupportCycles;
 extern cycle_t ActionCycles;
 extern int BotWTG;
@@ -111,6 +111,11 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 		// Tick every thinker left from last time
 		for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 		{
+			if (i == STAT_DEFAULT)
+			{
+				// The players have moved by now, so this is the last moment before the monsters start looking for them.
+				P_PrefetchLookSight(Level);
+			}
 			Thinkers[i].TickThinkers(nullptr);
 		}
 
@@ -2138,6 +2138,7 @@ void FParser::SF_SetLineBlocking(void)
 			{
 				Level->lines[i].flags = (Level->lines[i].flags & ~(ML_BLOCKING | ML_BLOCKEVERYTHING)) | blocking;
 			}
+			P_GeometryChanged();
 		}
 	}
 }
@@ -3802,6 +3803,7 @@ void FParser::SF_SetLineTrigger()
 				(f & ~(ML_MONSTERSCANACTIVATE | ML_REPEAT_SPECIAL | ML_SPAC_MASK | ML_FIRSTSIDEONLY));
 
 		}
+		P_GeometryChanged();
 	}
 }
 
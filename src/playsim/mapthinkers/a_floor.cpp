@@ -1213,6 +1213,7 @@ void DWaggleBase::DoWaggle (bool ceiling)
 			m_Sector->ChangePlaneTexZ(pos, -plane->HeightDiff (m_OriginalDist));
 			plane->setD(m_OriginalDist);
 			P_ChangeSector (m_Sector, true, dist, ceiling, false);
+			P_GeometryChanged();
 			if (ceiling)
 			{
 				m_Sector->ceilingdata = nullptr;
@@ -1248,6 +1249,7 @@ void DWaggleBase::DoWaggle (bool ceiling)
 	P_Scroll3dMidtex(m_Sector, 1, dist, ceiling);
 	P_MoveLinkedSectors(m_Sector, 1, dist, ceiling);
 	P_ChangeSector (m_Sector, 1, dist, ceiling, false);
+	P_GeometryChanged();
 }
 
 //==========================================================================
@@ -145,6 +145,19 @@ bool sector_t::MoveAttached(int crush, double move, int floorOrCeiling, bool res
 	return true;
 }
 
+//==========================================================================
+//
+// Moving a plane takes several steps, some of which run other code, e.g.
+// when things get crushed. So cached sight checks are only known to be
+// out of date once the move is complete, whichever way it ends.
+//
+//==========================================================================
+
+struct FPlaneMoveGuard
+{
+	~FPlaneMoveGuard() { P_GeometryChanged(); }
+};
+
 //
 // Move a plane (floor or ceiling) and check for crushing
 // [RH] Crush specifies the actual amount of crushing damage inflictable.
@@ -153,6 +166,7 @@ bool sector_t::MoveAttached(int crush, double move, int floorOrCeiling, bool res
 //
 EMoveResult sector_t::MoveFloor(double speed, double dest, int crush, int direction, bool hexencrush, bool instant)
 {
+	FPlaneMoveGuard guard;
 	bool	 	flag;
 	double 	lastpos;
 	double		movedest;
@@ -288,6 +302,7 @@ DEFINE_ACTION_FUNCTION(_Sector, MoveFloor)
 
 EMoveResult sector_t::MoveCeiling(double speed, double dest, int crush, int direction, bool hexencrush)
 {
+	FPlaneMoveGuard guard;
 	bool	 	flag;
 	double 	lastpos;
 	double		movedest;
@@ -36,6 +36,7 @@
 */
 
 #include <assert.h>
+#include <queue>
 
 #include "templates.h"
 #include "doomdef.h"
@@ -630,7 +631,7 @@ inline int PitchToACS(DAngle ang)
 
 struct CallReturn
 {
-	CallReturn(int pc, ScriptFunction *func, FBehavior *module, const ACSLocalVariables &locals, ACSLocalArrays *arrays, bool discard, unsigned int runaway)
+	CallReturn(int *pc, ScriptFunction *func, FBehavior *module, const ACSLocalVariables &locals, ACSLocalArrays *arrays, bool discard, unsigned int runaway)
 		: ReturnFunction(func),
 		  ReturnModule(module),
 		  ReturnLocals(locals),
@@ -644,7 +645,7 @@ struct CallReturn
 	FBehavior *ReturnModule;
 	ACSLocalVariables ReturnLocals;
 	ACSLocalArrays *ReturnArrays;
-	int ReturnAddress;
+	int *ReturnAddress;
 	int bDiscardResult;
 	unsigned int EntryInstrCount;
 };
@@ -2677,6 +2678,8 @@ bool FBehavior::Init(FLevelLocals *Level, int lumpnum, FileReader * fr, int len,
 		}
 	}
 
+	DecodeCode ();
+
 	DPrintf (DMSG_NOTIFY, "Loaded %d scripts, %d functions\n", NumScripts, NumFunctions);
 	return true;
 }
@@ -2723,6 +2726,492 @@ FBehavior::~FBehavior ()
 	}
 }
 
+//============================================================================
+//
+// GetPCodeOperands
+//
+// Describes the operands that follow a p-code in the object file, one
+// character each: W is a four-byte word and J a word holding a jump target,
+// B and S are a byte and a short in ACS_LittleEnhanced objects and a word
+// otherwise, and R is a byte in every format. PUSHBYTES and CASEGOTOSORTED
+// have a variable number of operands and are not described here.
+//
+//============================================================================
+
+#define ACS_VARIABLE_PCODES(op) \
+	case PCD_##op##SCRIPTVAR: case PCD_##op##MAPVAR: case PCD_##op##WORLDVAR: case PCD_##op##GLOBALVAR: \
+	case PCD_##op##SCRIPTARRAY: case PCD_##op##MAPARRAY: case PCD_##op##WORLDARRAY: case PCD_##op##GLOBALARRAY:
+
+static const char *GetPCodeOperands (int pcd)
+{
+	switch (pcd)
+	{
+	ACS_VARIABLE_PCODES(ASSIGN)
+	ACS_VARIABLE_PCODES(PUSH)
+	ACS_VARIABLE_PCODES(ADD)
+	ACS_VARIABLE_PCODES(SUB)
+	ACS_VARIABLE_PCODES(MUL)
+	ACS_VARIABLE_PCODES(DIV)
+	ACS_VARIABLE_PCODES(MOD)
+	ACS_VARIABLE_PCODES(AND)
+	ACS_VARIABLE_PCODES(EOR)
+	ACS_VARIABLE_PCODES(OR)
+	ACS_VARIABLE_PCODES(LS)
+	ACS_VARIABLE_PCODES(RS)
+	ACS_VARIABLE_PCODES(INC)
+	ACS_VARIABLE_PCODES(DEC)
+	case PCD_LSPEC1: case PCD_LSPEC2: case PCD_LSPEC3: case PCD_LSPEC4: case PCD_LSPEC5:
+	case PCD_LSPEC5RESULT: case PCD_PUSHFUNCTION: case PCD_CALL: case PCD_CALLDISCARD:
+		return "B";
+
+	case PCD_CALLFUNC:				return "BS";
+	case PCD_LSPEC1DIRECT:			return "BW";
+	case PCD_LSPEC2DIRECT:			return "BWW";
+	case PCD_LSPEC3DIRECT:			return "BWWW";
+	case PCD_LSPEC4DIRECT:			return "BWWWW";
+	case PCD_LSPEC5DIRECT:			return "BWWWWW";
+
+	case PCD_PUSHBYTE:
+	case PCD_DELAYDIRECTB:			return "R";
+	case PCD_PUSH2BYTES:
+	case PCD_RANDOMDIRECTB:
+	case PCD_LSPEC1DIRECTB:			return "RR";
+	case PCD_PUSH3BYTES:
+	case PCD_LSPEC2DIRECTB:			return "RRR";
+	case PCD_PUSH4BYTES:
+	case PCD_LSPEC3DIRECTB:			return "RRRR";
+	case PCD_PUSH5BYTES:
+	case PCD_LSPEC4DIRECTB:			return "RRRRR";
+	case PCD_LSPEC5DIRECTB:			return "RRRRRR";
+
+	case PCD_PUSHNUMBER: case PCD_LSPEC5EX: case PCD_LSPEC5EXRESULT: case PCD_DELAYDIRECT:
+	case PCD_TAGWAITDIRECT: case PCD_POLYWAITDIRECT: case PCD_SCRIPTWAITDIRECT: case PCD_SETFONTDIRECT:
+	case PCD_SETGRAVITYDIRECT: case PCD_SETAIRCONTROLDIRECT: case PCD_CHECKINVENTORYDIRECT:
+		return "W";
+
+	case PCD_RANDOMDIRECT: case PCD_THINGCOUNTDIRECT: case PCD_CHANGEFLOORDIRECT:
+	case PCD_CHANGECEILINGDIRECT: case PCD_GIVEINVENTORYDIRECT: case PCD_TAKEINVENTORYDIRECT:
+		return "WW";
+
+	case PCD_SETMUSICDIRECT: case PCD_LOCALSETMUSICDIRECT: case PCD_CONSOLECOMMANDDIRECT:
+		return "WWW";
+
+	case PCD_SPAWNSPOTDIRECT:		return "WWWW";
+	case PCD_SPAWNDIRECT:			return "WWWWWW";
+
+	case PCD_GOTO: case PCD_IFGOTO: case PCD_IFNOTGOTO:
+		return "J";
+
+	case PCD_CASEGOTO:				return "WJ";
+
+	default:
+		return "";
+	}
+}
+
+#undef ACS_VARIABLE_PCODES
+
+//============================================================================
+//
+// PCodeEndsBlock
+//
+// True if execution never continues with the instruction after this one.
+//
+//============================================================================
+
+static bool PCodeEndsBlock (int pcd)
+{
+	switch (pcd)
+	{
+	case PCD_TERMINATE:
+	case PCD_GOTO:
+	case PCD_GOTOSTACK:
+	case PCD_RESTART:
+	case PCD_RETURNVOID:
+	case PCD_RETURNVAL:
+		return true;
+
+	default:
+		return (unsigned)pcd >= PCODE_COMMAND_COUNT;
+	}
+}
+
+//============================================================================
+//
+// FPCodeReader
+//
+// Reads p-codes and operands out of an object file's bytecode the way the
+// interpreter used to, but refuses to read past the end of it.
+//
+//============================================================================
+
+struct FPCodeReader
+{
+	const uint8_t *Data;
+	uint32_t Size;
+	ACSFormat Format;
+	uint32_t Ofs = 0;
+	bool Overrun = false;
+
+	FPCodeReader(const uint8_t *data, uint32_t size, ACSFormat format) : Data(data), Size(size), Format(format) {}
+
+	bool Check(uint32_t len)
+	{
+		if (Ofs > Size || Size - Ofs < len)
+		{
+			Overrun = true;
+			return false;
+		}
+		return true;
+	}
+
+	int Byte()
+	{
+		return Check(1) ? Data[Ofs++] : 0;
+	}
+
+	int Short()
+	{
+		if (!Check(2)) return 0;
+		int16_t res = int16_t(Data[Ofs] | (Data[Ofs+1] << 8));
+		Ofs += 2;
+		return res;
+	}
+
+	int Word()
+	{
+		if (!Check(4)) return 0;
+		int res = Data[Ofs] | (Data[Ofs+1] << 8) | (Data[Ofs+2] << 16) | (Data[Ofs+3] << 24);
+		Ofs += 4;
+		return res;
+	}
+
+	int PCode()
+	{
+		if (Format != ACS_LittleEnhanced)
+		{
+			return Word();
+		}
+		int pcd = Byte();
+		if (pcd >= 256-16)
+		{
+			pcd = (256-16) + ((pcd - (256-16)) << 8) + Byte();
+		}
+		return pcd;
+	}
+
+	int Operand(char type)
+	{
+		switch (type)
+		{
+		case 'B':	return Format == ACS_LittleEnhanced ? Byte() : Word();
+		case 'S':	return Format == ACS_LittleEnhanced ? Short() : Word();
+		case 'R':	return Byte();
+		default:	return Word();
+		}
+	}
+};
+
+//============================================================================
+//
+// ReadPCodeInstruction
+//
+// Reads the instruction at the reader's position and appends its p-code
+// and operands to code, one word each. The indices of the operands that
+// are jump targets are appended to jumps; those operands still hold
+// offsets into the bytecode.
+//
+//============================================================================
+
+static int ReadPCodeInstruction (FPCodeReader &reader, TArray<int> &code, TArray<unsigned> &jumps)
+{
+	int pcd = reader.PCode();
+	code.Push(pcd);
+	if (pcd == PCD_PUSHBYTES)
+	{
+		int count = reader.Byte();
+		code.Push(count);
+		for (int i = 0; i < count; ++i)
+		{
+			code.Push(reader.Byte());
+		}
+	}
+	else if (pcd == PCD_CASEGOTOSORTED)
+	{
+		// The count and jump table are 4-byte aligned
+		reader.Ofs = (reader.Ofs + 3) & ~3;
+		int count = reader.Word();
+		if (reader.Overrun || count < 0 || uint32_t(count) > (reader.Size - reader.Ofs) / 8)
+		{
+			reader.Overrun = true;
+			return pcd;
+		}
+		code.Push(count);
+		for (int i = 0; i < count; ++i)
+		{
+			code.Push(reader.Word());
+			jumps.Push(code.Push(reader.Word()));
+		}
+	}
+	else
+	{
+		for (const char *op = GetPCodeOperands(pcd); *op != 0; ++op)
+		{
+			unsigned index = code.Push(reader.Operand(*op));
+			if (*op == 'J') jumps.Push(index);
+		}
+	}
+	return pcd;
+}
+
+//============================================================================
+//
+// FBehavior :: DecodeCode
+//
+// Translates all code reachable from the module's scripts, functions and
+// jump points into Code, so that the interpreter does not need to care
+// about the object format or unaligned operands, and never has to look up
+// a jump target. Code is decoded starting from the lowest pending offset,
+// so falling through into an instruction that was already decoded, which
+// needs an extra GOTO, only happens for odd control flow. Offsets that were
+// never decoded, such as from a savegame for a different version of the
+// module, end up at the PCD_TERMINATE at index 0.
+//
+//============================================================================
+
+void FBehavior::DecodeCode ()
+{
+	std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> pending;
+	TArray<unsigned> jumps;
+	FPCodeReader reader(Data, DataSize, Format);
+	int i;
+
+	Code.Clear();
+	CodeOrigin.Clear();
+	CodeIndex.Clear();
+	Code.Push(PCD_TERMINATE);
+	CodeOrigin.Push(0);
+
+	for (i = 0; i < NumScripts; ++i)
+	{
+		pending.push(Scripts[i].Address);
+	}
+	for (i = 0; i < NumFunctions; ++i)
+	{
+		if (Functions[i].ImportNum == 0 && Functions[i].Address != 0)
+		{
+			pending.push(Functions[i].Address);
+		}
+	}
+	for (auto ofs : JumpPoints)
+	{
+		pending.push(ofs);
+	}
+
+	while (!pending.empty())
+	{
+		uint32_t ofs = pending.top();
+		pending.pop();
+		if (CodeIndex.CheckKey(ofs) != nullptr)
+		{
+			continue;
+		}
+		for (;;)
+		{
+			unsigned start = Code.Size();
+			unsigned firstjump = jumps.Size();
+
+			CodeIndex[ofs] = start;
+			reader.Ofs = ofs;
+			int pcd = ReadPCodeInstruction(reader, Code, jumps);
+			if (reader.Overrun)
+			{
+				// The instruction does not fit in the code, so there is no
+				// sensible way to run it.
+				reader.Overrun = false;
+				Code.Resize(start);
+				jumps.Resize(firstjump);
+				Code.Push(pcd = PCD_TERMINATE);
+			}
+			while (CodeOrigin.Size() < Code.Size())
+			{
+				CodeOrigin.Push(ofs);
+			}
+			for (unsigned j = firstjump; j < jumps.Size(); ++j)
+			{
+				pending.push(Code[jumps[j]]);
+			}
+			if (PCodeEndsBlock(pcd))
+			{
+				break;
+			}
+
+			ofs = reader.Ofs;
+			if (auto next = CodeIndex.CheckKey(ofs))
+			{
+				// Fall through into code that has already been decoded.
+				Code.Push(PCD_GOTO);
+				Code.Push(int(*next) - int(Code.Size()));
+				CodeOrigin.Push(ofs);
+				CodeOrigin.Push(ofs);
+				break;
+			}
+		}
+	}
+
+	// Now that every instruction has a place, turn the jump targets from
+	// offsets in Data into distances in Code.
+	for (auto index : jumps)
+	{
+		auto target = CodeIndex.CheckKey(Code[index]);
+		Code[index] = (target != nullptr ? int(*target) : 0) - int(index);
+	}
+
+	for (i = 0; i < NumFunctions; ++i)
+	{
+		ScriptFunction *func = &Functions[i];
+		auto index = func->ImportNum == 0 ? CodeIndex.CheckKey(func->Address) : nullptr;
+		func->CodeIndex = index != nullptr ? *index : 0;
+	}
+	Code.ShrinkToFit();
+	CodeOrigin.ShrinkToFit();
+}
+
+//============================================================================
+//
+// FBehavior :: Ofs2PC
+//
+//============================================================================
+
+int *FBehavior::Ofs2PC (uint32_t ofs) const
+{
+	auto index = CodeIndex.CheckKey(ofs);
+	return const_cast<int *>(&Code[index != nullptr ? *index : 0]);
+}
+
+//============================================================================
+//
+// FBehavior :: BenchmarkFetch
+//
+// Walks over every decoded instruction, once reading the p-code and its
+// operands out of the original bytecode the way RunScript did before
+// modules were decoded at load time, and once reading them out of Code.
+// Only instruction fetch is timed, not what the handlers do. Returns true
+// if both walks read the same values.
+//
+//============================================================================
+
+bool FBehavior::BenchmarkFetch (int passes, double &rawms, double &decodedms) const
+{
+	TArray<uint32_t> rawstarts, decodedstarts;
+	int64_t rawsum = 0, decodedsum = 0;
+	cycle_t rawtime, decodedtime;
+
+	// Leave out the TERMINATEs that stand in for instructions which run
+	// past the end of the code.
+	FPCodeReader reader(Data, DataSize, Format);
+	TArray<int> scratch;
+	TArray<unsigned> scratchjumps;
+	TMap<uint32_t, uint32_t>::ConstIterator it(CodeIndex);
+	TMap<uint32_t, uint32_t>::ConstPair *pair;
+	while (it.NextPair(pair))
+	{
+		reader.Ofs = pair->Key;
+		reader.Overrun = false;
+		ReadPCodeInstruction(reader, scratch, scratchjumps);
+		if (!reader.Overrun)
+		{
+			decodedstarts.Push(pair->Value);
+		}
+		scratch.Clear();
+		scratchjumps.Clear();
+	}
+	std::sort(decodedstarts.begin(), decodedstarts.end());
+	for (auto index : decodedstarts)
+	{
+		rawstarts.Push(CodeOrigin[index]);
+	}
+
+	rawtime.Reset();
+	decodedtime.Reset();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		rawtime.Clock();
+		for (auto ofs : rawstarts)
+		{
+			const uint8_t *p = Data + ofs;
+			auto word = [&p]() { int res = uallong(*(const int *)p); p += 4; return res; };
+			int pcd;
+
+			if (Format == ACS_LittleEnhanced)
+			{
+				pcd = *p++;
+				if (pcd >= 256-16)
+				{
+					pcd = (256-16) + ((pcd - (256-16)) << 8) + *p++;
+				}
+			}
+			else
+			{
+				pcd = word();
+			}
+			rawsum += pcd;
+			if (pcd == PCD_PUSHBYTES)
+			{
+				int count = *p++;
+				for (int j = 0; j < count; ++j) rawsum += *p++;
+			}
+			else if (pcd == PCD_CASEGOTOSORTED)
+			{
+				p = Data + ((p - Data + 3) & ~3);
+				int count = word();
+				for (int j = 0; j < count; ++j, p += 4) rawsum += word();
+			}
+			for (const char *op = GetPCodeOperands(pcd); *op != 0; ++op)
+			{
+				int val;
+				switch (*op)
+				{
+				case 'B':	if (Format == ACS_LittleEnhanced) val = *p++; else val = word(); break;
+				case 'S':	if (Format == ACS_LittleEnhanced) { val = LittleShort(*(const int16_t *)p); p += 2; } else val = word(); break;
+				case 'R':	val = *p++; break;
+				default:	val = word(); break;
+				}
+				if (*op != 'J') rawsum += val;
+			}
+		}
+		rawtime.Unclock();
+
+		decodedtime.Clock();
+		for (auto index : decodedstarts)
+		{
+			const int *pc = &Code[index];
+			int pcd = *pc++;
+
+			decodedsum += pcd;
+			if (pcd == PCD_PUSHBYTES)
+			{
+				int count = *pc++;
+				for (int j = 0; j < count; ++j) decodedsum += *pc++;
+			}
+			else if (pcd == PCD_CASEGOTOSORTED)
+			{
+				int count = *pc++;
+				for (int j = 0; j < count; ++j, pc += 2) decodedsum += pc[0];
+			}
+			for (const char *op = GetPCodeOperands(pcd); *op != 0; ++op)
+			{
+				int val = *pc++;
+				if (*op != 'J') decodedsum += val;
+			}
+		}
+		decodedtime.Unclock();
+	}
+	rawms = rawtime.TimeMS();
+	decodedms = decodedtime.TimeMS();
+	return rawsum == decodedsum;
+}
+
 void FBehavior::LoadScriptsDirectory ()
 {
 	union
@@ -6208,6 +6697,7 @@ doplaysound:			if (funcIndex == ACSF_PlayActorSound)
 				{
 					Level->lines[line].activation = args[1];
 				}
+				P_GeometryChanged();
 			}
 			break;
 
@@ -6750,28 +7240,52 @@ enum
 };
 
 
-#define NEXTWORD	(LittleLong(*pc++))
-#define NEXTBYTE	(fmt==ACS_LittleEnhanced?getbyte(pc):NEXTWORD)
-#define NEXTSHORT	(fmt==ACS_LittleEnhanced?getshort(pc):NEXTWORD)
+// Code has been decoded at load time, so that every p-code and operand is
+// one word, whatever size it has in the object file.
+#define NEXTWORD	(*pc++)
+#define NEXTBYTE	NEXTWORD
+#define NEXTSHORT	NEXTWORD
+
+#define ACS_RUNAWAY_LIMIT 2000000
+
+// Reads the next instruction's p-code into pcd.
+#define FETCHPCODE	(pcd = NEXTWORD)
+
+// With GCC and Clang RunScript uses direct threaded dispatch: each p-code
+// handler fetches the next instruction itself and jumps straight to its
+// handler, so that the CPU predicts every handler's successor separately
+// instead of funneling everything through the switch's single indirect
+// jump. Anything out of the ordinary (the script stopped running, the
+// runaway limit, unknown p-codes) still goes through the top of the loop.
+// Other compilers get a plain switch.
+#if defined(__GNUC__)
+#define ACS_THREADED_DISPATCH
+#endif
+
+#ifdef ACS_THREADED_DISPATCH
+#define PCODE(name)		case PCD_##name: pcode_##name:
+#define PCODE_DEFAULT	default: pcode_default:
+#define NEXTPCODE \
+	{ \
+		if (state == SCRIPT_Running && runaway < ACS_RUNAWAY_LIMIT) \
+		{ \
+			++runaway; \
+			FETCHPCODE; \
+			if ((unsigned)pcd < PCODE_COMMAND_COUNT) goto *pcodelabels[pcd]; \
+			goto pcode_default; \
+		} \
+	} \
+	break
+#else
+#define PCODE(name)		case PCD_##name:
+#define PCODE_DEFAULT	default:
+#define NEXTPCODE		break
+#endif
 #define STACK(a)	(Stack[sp - (a)])
 #define PushToStack(a)	(Stack[sp++] = (a))
 // Direct instructions that take strings need to have the tag applied.
 #define TAGSTR(a)	(a|activeBehavior->GetLibraryID())
 
-inline int getbyte (int *&pc)
-{
-	int res = *(uint8_t *)pc;
-	pc = (int *)((uint8_t *)pc+1);
-	return res;
-}
-
-inline int getshort (int *&pc)
-{
-	int res = LittleShort( *(int16_t *)pc);
-	pc = (int *)((uint8_t *)pc+2);
-	return res;
-}
-
 static bool CharArrayParms(int &capacity, int &offset, int &a, FACSStackMemory& Stack, int &sp, bool ranged)
 {
 	if (ranged)
@@ -6892,144 +7406,266 @@ int DLevelScript::RunScript()
 	int optstart = -1;
 	int temp;
 
+#ifdef ACS_THREADED_DISPATCH
+	// Indexed by p-code. Every code names its own label, so a handler that is
+	// missing or still a plain case label fails to compile instead of ending
+	// up in the default handler. Codes above the table go there.
+	static const void *const pcodelabels[] =
+	{
+		&&pcode_NOP, &&pcode_TERMINATE, &&pcode_SUSPEND, &&pcode_PUSHNUMBER,
+		&&pcode_LSPEC1, &&pcode_LSPEC2, &&pcode_LSPEC3, &&pcode_LSPEC4,
+		&&pcode_LSPEC5, &&pcode_LSPEC1DIRECT, &&pcode_LSPEC2DIRECT, &&pcode_LSPEC3DIRECT,
+		&&pcode_LSPEC4DIRECT, &&pcode_LSPEC5DIRECT, &&pcode_ADD, &&pcode_SUBTRACT,
+		&&pcode_MULTIPLY, &&pcode_DIVIDE, &&pcode_MODULUS, &&pcode_EQ,
+		&&pcode_NE, &&pcode_LT, &&pcode_GT, &&pcode_LE,
+		&&pcode_GE, &&pcode_ASSIGNSCRIPTVAR, &&pcode_ASSIGNMAPVAR, &&pcode_ASSIGNWORLDVAR,
+		&&pcode_PUSHSCRIPTVAR, &&pcode_PUSHMAPVAR, &&pcode_PUSHWORLDVAR, &&pcode_ADDSCRIPTVAR,
+		&&pcode_ADDMAPVAR, &&pcode_ADDWORLDVAR, &&pcode_SUBSCRIPTVAR, &&pcode_SUBMAPVAR,
+		&&pcode_SUBWORLDVAR, &&pcode_MULSCRIPTVAR, &&pcode_MULMAPVAR, &&pcode_MULWORLDVAR,
+		&&pcode_DIVSCRIPTVAR, &&pcode_DIVMAPVAR, &&pcode_DIVWORLDVAR, &&pcode_MODSCRIPTVAR,
+		&&pcode_MODMAPVAR, &&pcode_MODWORLDVAR, &&pcode_INCSCRIPTVAR, &&pcode_INCMAPVAR,
+		&&pcode_INCWORLDVAR, &&pcode_DECSCRIPTVAR, &&pcode_DECMAPVAR, &&pcode_DECWORLDVAR,
+		&&pcode_GOTO, &&pcode_IFGOTO, &&pcode_DROP, &&pcode_DELAY,
+		&&pcode_DELAYDIRECT, &&pcode_RANDOM, &&pcode_RANDOMDIRECT, &&pcode_THINGCOUNT,
+		&&pcode_THINGCOUNTDIRECT, &&pcode_TAGWAIT, &&pcode_TAGWAITDIRECT, &&pcode_POLYWAIT,
+		&&pcode_POLYWAITDIRECT, &&pcode_CHANGEFLOOR, &&pcode_CHANGEFLOORDIRECT, &&pcode_CHANGECEILING,
+		&&pcode_CHANGECEILINGDIRECT, &&pcode_RESTART, &&pcode_ANDLOGICAL, &&pcode_ORLOGICAL,
+		&&pcode_ANDBITWISE, &&pcode_ORBITWISE, &&pcode_EORBITWISE, &&pcode_NEGATELOGICAL,
+		&&pcode_LSHIFT, &&pcode_RSHIFT, &&pcode_UNARYMINUS, &&pcode_IFNOTGOTO,
+		&&pcode_LINESIDE, &&pcode_SCRIPTWAIT, &&pcode_SCRIPTWAITDIRECT, &&pcode_CLEARLINESPECIAL,
+		&&pcode_CASEGOTO, &&pcode_BEGINPRINT, &&pcode_ENDPRINT, &&pcode_PRINTSTRING,
+		&&pcode_PRINTNUMBER, &&pcode_PRINTCHARACTER, &&pcode_PLAYERCOUNT, &&pcode_GAMETYPE,
+		&&pcode_GAMESKILL, &&pcode_TIMER, &&pcode_SECTORSOUND, &&pcode_AMBIENTSOUND,
+		&&pcode_SOUNDSEQUENCE, &&pcode_SETLINETEXTURE, &&pcode_SETLINEBLOCKING, &&pcode_SETLINESPECIAL,
+		&&pcode_THINGSOUND, &&pcode_ENDPRINTBOLD, &&pcode_ACTIVATORSOUND, &&pcode_LOCALAMBIENTSOUND,
+		&&pcode_SETLINEMONSTERBLOCKING, &&pcode_PLAYERBLUESKULL, &&pcode_PLAYERREDSKULL, &&pcode_PLAYERYELLOWSKULL,
+		&&pcode_PLAYERMASTERSKULL, &&pcode_PLAYERBLUECARD, &&pcode_PLAYERREDCARD, &&pcode_PLAYERYELLOWCARD,
+		&&pcode_PLAYERMASTERCARD, &&pcode_PLAYERBLACKSKULL, &&pcode_PLAYERSILVERSKULL, &&pcode_PLAYERGOLDSKULL,
+		&&pcode_PLAYERBLACKCARD, &&pcode_PLAYERSILVERCARD, &&pcode_ISNETWORKGAME, &&pcode_PLAYERTEAM,
+		&&pcode_PLAYERHEALTH, &&pcode_PLAYERARMORPOINTS, &&pcode_PLAYERFRAGS, &&pcode_PLAYEREXPERT,
+		&&pcode_BLUETEAMCOUNT, &&pcode_REDTEAMCOUNT, &&pcode_BLUETEAMSCORE, &&pcode_REDTEAMSCORE,
+		&&pcode_ISONEFLAGCTF, &&pcode_LSPEC6, &&pcode_LSPEC6DIRECT, &&pcode_PRINTNAME,
+		&&pcode_MUSICCHANGE, &&pcode_CONSOLECOMMANDDIRECT, &&pcode_CONSOLECOMMAND, &&pcode_SINGLEPLAYER,
+		&&pcode_FIXEDMUL, &&pcode_FIXEDDIV, &&pcode_SETGRAVITY, &&pcode_SETGRAVITYDIRECT,
+		&&pcode_SETAIRCONTROL, &&pcode_SETAIRCONTROLDIRECT, &&pcode_CLEARINVENTORY, &&pcode_GIVEINVENTORY,
+		&&pcode_GIVEINVENTORYDIRECT, &&pcode_TAKEINVENTORY, &&pcode_TAKEINVENTORYDIRECT, &&pcode_CHECKINVENTORY,
+		&&pcode_CHECKINVENTORYDIRECT, &&pcode_SPAWN, &&pcode_SPAWNDIRECT, &&pcode_SPAWNSPOT,
+		&&pcode_SPAWNSPOTDIRECT, &&pcode_SETMUSIC, &&pcode_SETMUSICDIRECT, &&pcode_LOCALSETMUSIC,
+		&&pcode_LOCALSETMUSICDIRECT, &&pcode_PRINTFIXED, &&pcode_PRINTLOCALIZED, &&pcode_MOREHUDMESSAGE,
+		&&pcode_OPTHUDMESSAGE, &&pcode_ENDHUDMESSAGE, &&pcode_ENDHUDMESSAGEBOLD, &&pcode_SETSTYLE,
+		&&pcode_SETSTYLEDIRECT, &&pcode_SETFONT, &&pcode_SETFONTDIRECT, &&pcode_PUSHBYTE,
+		&&pcode_LSPEC1DIRECTB, &&pcode_LSPEC2DIRECTB, &&pcode_LSPEC3DIRECTB, &&pcode_LSPEC4DIRECTB,
+		&&pcode_LSPEC5DIRECTB, &&pcode_DELAYDIRECTB, &&pcode_RANDOMDIRECTB, &&pcode_PUSHBYTES,
+		&&pcode_PUSH2BYTES, &&pcode_PUSH3BYTES, &&pcode_PUSH4BYTES, &&pcode_PUSH5BYTES,
+		&&pcode_SETTHINGSPECIAL, &&pcode_ASSIGNGLOBALVAR, &&pcode_PUSHGLOBALVAR, &&pcode_ADDGLOBALVAR,
+		&&pcode_SUBGLOBALVAR, &&pcode_MULGLOBALVAR, &&pcode_DIVGLOBALVAR, &&pcode_MODGLOBALVAR,
+		&&pcode_INCGLOBALVAR, &&pcode_DECGLOBALVAR, &&pcode_FADETO, &&pcode_FADERANGE,
+		&&pcode_CANCELFADE, &&pcode_PLAYMOVIE, &&pcode_SETFLOORTRIGGER, &&pcode_SETCEILINGTRIGGER,
+		&&pcode_GETACTORX, &&pcode_GETACTORY, &&pcode_GETACTORZ, &&pcode_STARTTRANSLATION,
+		&&pcode_TRANSLATIONRANGE1, &&pcode_TRANSLATIONRANGE2, &&pcode_ENDTRANSLATION, &&pcode_CALL,
+		&&pcode_CALLDISCARD, &&pcode_RETURNVOID, &&pcode_RETURNVAL, &&pcode_PUSHMAPARRAY,
+		&&pcode_ASSIGNMAPARRAY, &&pcode_ADDMAPARRAY, &&pcode_SUBMAPARRAY, &&pcode_MULMAPARRAY,
+		&&pcode_DIVMAPARRAY, &&pcode_MODMAPARRAY, &&pcode_INCMAPARRAY, &&pcode_DECMAPARRAY,
+		&&pcode_DUP, &&pcode_SWAP, &&pcode_WRITETOINI, &&pcode_GETFROMINI,
+		&&pcode_SIN, &&pcode_COS, &&pcode_VECTORANGLE, &&pcode_CHECKWEAPON,
+		&&pcode_SETWEAPON, &&pcode_TAGSTRING, &&pcode_PUSHWORLDARRAY, &&pcode_ASSIGNWORLDARRAY,
+		&&pcode_ADDWORLDARRAY, &&pcode_SUBWORLDARRAY, &&pcode_MULWORLDARRAY, &&pcode_DIVWORLDARRAY,
+		&&pcode_MODWORLDARRAY, &&pcode_INCWORLDARRAY, &&pcode_DECWORLDARRAY, &&pcode_PUSHGLOBALARRAY,
+		&&pcode_ASSIGNGLOBALARRAY, &&pcode_ADDGLOBALARRAY, &&pcode_SUBGLOBALARRAY, &&pcode_MULGLOBALARRAY,
+		&&pcode_DIVGLOBALARRAY, &&pcode_MODGLOBALARRAY, &&pcode_INCGLOBALARRAY, &&pcode_DECGLOBALARRAY,
+		&&pcode_SETMARINEWEAPON, &&pcode_SETACTORPROPERTY, &&pcode_GETACTORPROPERTY, &&pcode_PLAYERNUMBER,
+		&&pcode_ACTIVATORTID, &&pcode_SETMARINESPRITE, &&pcode_GETSCREENWIDTH, &&pcode_GETSCREENHEIGHT,
+		&&pcode_THING_PROJECTILE2, &&pcode_STRLEN, &&pcode_SETHUDSIZE, &&pcode_GETCVAR,
+		&&pcode_CASEGOTOSORTED, &&pcode_SETRESULTVALUE, &&pcode_GETLINEROWOFFSET, &&pcode_GETACTORFLOORZ,
+		&&pcode_GETACTORANGLE, &&pcode_GETSECTORFLOORZ, &&pcode_GETSECTORCEILINGZ, &&pcode_LSPEC5RESULT,
+		&&pcode_GETSIGILPIECES, &&pcode_GETLEVELINFO, &&pcode_CHANGESKY, &&pcode_PLAYERINGAME,
+		&&pcode_PLAYERISBOT, &&pcode_SETCAMERATOTEXTURE, &&pcode_ENDLOG, &&pcode_GETAMMOCAPACITY,
+		&&pcode_SETAMMOCAPACITY, &&pcode_PRINTMAPCHARARRAY, &&pcode_PRINTWORLDCHARARRAY, &&pcode_PRINTGLOBALCHARARRAY,
+		&&pcode_SETACTORANGLE, &&pcode_GRABINPUT, &&pcode_SETMOUSEPOINTER, &&pcode_MOVEMOUSEPOINTER,
+		&&pcode_SPAWNPROJECTILE, &&pcode_GETSECTORLIGHTLEVEL, &&pcode_GETACTORCEILINGZ, &&pcode_SETACTORPOSITION,
+		&&pcode_CLEARACTORINVENTORY, &&pcode_GIVEACTORINVENTORY, &&pcode_TAKEACTORINVENTORY, &&pcode_CHECKACTORINVENTORY,
+		&&pcode_THINGCOUNTNAME, &&pcode_SPAWNSPOTFACING, &&pcode_PLAYERCLASS, &&pcode_ANDSCRIPTVAR,
+		&&pcode_ANDMAPVAR, &&pcode_ANDWORLDVAR, &&pcode_ANDGLOBALVAR, &&pcode_ANDMAPARRAY,
+		&&pcode_ANDWORLDARRAY, &&pcode_ANDGLOBALARRAY, &&pcode_EORSCRIPTVAR, &&pcode_EORMAPVAR,
+		&&pcode_EORWORLDVAR, &&pcode_EORGLOBALVAR, &&pcode_EORMAPARRAY, &&pcode_EORWORLDARRAY,
+		&&pcode_EORGLOBALARRAY, &&pcode_ORSCRIPTVAR, &&pcode_ORMAPVAR, &&pcode_ORWORLDVAR,
+		&&pcode_ORGLOBALVAR, &&pcode_ORMAPARRAY, &&pcode_ORWORLDARRAY, &&pcode_ORGLOBALARRAY,
+		&&pcode_LSSCRIPTVAR, &&pcode_LSMAPVAR, &&pcode_LSWORLDVAR, &&pcode_LSGLOBALVAR,
+		&&pcode_LSMAPARRAY, &&pcode_LSWORLDARRAY, &&pcode_LSGLOBALARRAY, &&pcode_RSSCRIPTVAR,
+		&&pcode_RSMAPVAR, &&pcode_RSWORLDVAR, &&pcode_RSGLOBALVAR, &&pcode_RSMAPARRAY,
+		&&pcode_RSWORLDARRAY, &&pcode_RSGLOBALARRAY, &&pcode_GETPLAYERINFO, &&pcode_CHANGELEVEL,
+		&&pcode_SECTORDAMAGE, &&pcode_REPLACETEXTURES, &&pcode_NEGATEBINARY, &&pcode_GETACTORPITCH,
+		&&pcode_SETACTORPITCH, &&pcode_PRINTBIND, &&pcode_SETACTORSTATE, &&pcode_THINGDAMAGE2,
+		&&pcode_USEINVENTORY, &&pcode_USEACTORINVENTORY, &&pcode_CHECKACTORCEILINGTEXTURE, &&pcode_CHECKACTORFLOORTEXTURE,
+		&&pcode_GETACTORLIGHTLEVEL, &&pcode_SETMUGSHOTSTATE, &&pcode_THINGCOUNTSECTOR, &&pcode_THINGCOUNTNAMESECTOR,
+		&&pcode_CHECKPLAYERCAMERA, &&pcode_MORPHACTOR, &&pcode_UNMORPHACTOR, &&pcode_GETPLAYERINPUT,
+		&&pcode_CLASSIFYACTOR, &&pcode_PRINTBINARY, &&pcode_PRINTHEX, &&pcode_CALLFUNC,
+		&&pcode_SAVESTRING, &&pcode_PRINTMAPCHRANGE, &&pcode_PRINTWORLDCHRANGE, &&pcode_PRINTGLOBALCHRANGE,
+		&&pcode_STRCPYTOMAPCHRANGE, &&pcode_STRCPYTOWORLDCHRANGE, &&pcode_STRCPYTOGLOBALCHRANGE, &&pcode_PUSHFUNCTION,
+		&&pcode_CALLSTACK, &&pcode_SCRIPTWAITNAMED, &&pcode_TRANSLATIONRANGE3, &&pcode_GOTOSTACK,
+		&&pcode_ASSIGNSCRIPTARRAY, &&pcode_PUSHSCRIPTARRAY, &&pcode_ADDSCRIPTARRAY, &&pcode_SUBSCRIPTARRAY,
+		&&pcode_MULSCRIPTARRAY, &&pcode_DIVSCRIPTARRAY, &&pcode_MODSCRIPTARRAY, &&pcode_INCSCRIPTARRAY,
+		&&pcode_DECSCRIPTARRAY, &&pcode_ANDSCRIPTARRAY, &&pcode_EORSCRIPTARRAY, &&pcode_ORSCRIPTARRAY,
+		&&pcode_LSSCRIPTARRAY, &&pcode_RSSCRIPTARRAY, &&pcode_PRINTSCRIPTCHARARRAY, &&pcode_PRINTSCRIPTCHRANGE,
+		&&pcode_STRCPYTOSCRIPTCHRANGE, &&pcode_LSPEC5EX, &&pcode_LSPEC5EXRESULT, &&pcode_TRANSLATIONRANGE4,
+		&&pcode_TRANSLATIONRANGE5,
+	};
+	static_assert(countof(pcodelabels) == PCODE_COMMAND_COUNT, "p-code label table does not match the p-code list");
+#endif
+
 	while (state == SCRIPT_Running)
 	{
-		if (++runaway > 2000000)
+		if (++runaway > ACS_RUNAWAY_LIMIT)
 		{
 			Printf ("Runaway %s terminated\n", ScriptPresentation(script).GetChars());
 			state = SCRIPT_PleaseRemove;
 			break;
 		}
 
-		if (fmt == ACS_LittleEnhanced)
-		{
-			pcd = getbyte(pc);
-			if (pcd >= 256-16)
-			{
-				pcd = (256-16) + ((pcd - (256-16)) << 8) + getbyte(pc);
-			}
-		}
-		else
-		{
-			pcd = NEXTWORD;
-		}
+		FETCHPCODE;
 
 		switch (pcd)
 		{
-		default:
+		// Reserved p-codes that were never implemented.
+		PCODE(PLAYERBLUESKULL)
+		PCODE(PLAYERREDSKULL)
+		PCODE(PLAYERYELLOWSKULL)
+		PCODE(PLAYERMASTERSKULL)
+		PCODE(PLAYERBLUECARD)
+		PCODE(PLAYERREDCARD)
+		PCODE(PLAYERYELLOWCARD)
+		PCODE(PLAYERMASTERCARD)
+		PCODE(PLAYERBLACKSKULL)
+		PCODE(PLAYERSILVERSKULL)
+		PCODE(PLAYERGOLDSKULL)
+		PCODE(PLAYERBLACKCARD)
+		PCODE(PLAYERSILVERCARD)
+		PCODE(PLAYEREXPERT)
+		PCODE(BLUETEAMCOUNT)
+		PCODE(REDTEAMCOUNT)
+		PCODE(BLUETEAMSCORE)
+		PCODE(REDTEAMSCORE)
+		PCODE(ISONEFLAGCTF)
+		PCODE(LSPEC6)
+		PCODE(LSPEC6DIRECT)
+		PCODE(SETSTYLE)
+		PCODE(SETSTYLEDIRECT)
+		PCODE(WRITETOINI)
+		PCODE(GETFROMINI)
+		PCODE(GRABINPUT)
+		PCODE(SETMOUSEPOINTER)
+		PCODE(MOVEMOUSEPOINTER)
+		PCODE_DEFAULT
 			Printf ("Unknown P-Code %d in %s\n", pcd, ScriptPresentation(script).GetChars());
 			activeBehavior = savedActiveBehavior;
 			// fall through
-		case PCD_TERMINATE:
+		PCODE(TERMINATE)
 			DPrintf (DMSG_NOTIFY, "%s finished\n", ScriptPresentation(script).GetChars());
 			state = SCRIPT_PleaseRemove;
-			break;
+			NEXTPCODE;
 
-		case PCD_NOP:
-			break;
+		PCODE(NOP)
+			NEXTPCODE;
 
-		case PCD_SUSPEND:
+		PCODE(SUSPEND)
 			state = SCRIPT_Suspended;
-			break;
+			NEXTPCODE;
 
-		case PCD_TAGSTRING:
+		PCODE(TAGSTRING)
 			//Stack[sp-1] |= activeBehavior->GetLibraryID();
 			Stack[sp-1] = GlobalACSStrings.AddString(activeBehavior->LookupString(Stack[sp-1]));
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHNUMBER:
-			PushToStack (uallong(pc[0]));
+		PCODE(PUSHNUMBER)
+			PushToStack (pc[0]);
 			pc++;
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHBYTE:
-			PushToStack (*(uint8_t *)pc);
-			pc = (int *)((uint8_t *)pc + 1);
-			break;
+		PCODE(PUSHBYTE)
+			PushToStack (NEXTWORD);
+			NEXTPCODE;
 
-		case PCD_PUSH2BYTES:
-			Stack[sp] = ((uint8_t *)pc)[0];
-			Stack[sp+1] = ((uint8_t *)pc)[1];
+		PCODE(PUSH2BYTES)
+			Stack[sp] = pc[0];
+			Stack[sp+1] = pc[1];
 			sp += 2;
-			pc = (int *)((uint8_t *)pc + 2);
-			break;
+			pc += 2;
+			NEXTPCODE;
 
-		case PCD_PUSH3BYTES:
-			Stack[sp] = ((uint8_t *)pc)[0];
-			Stack[sp+1] = ((uint8_t *)pc)[1];
-			Stack[sp+2] = ((uint8_t *)pc)[2];
+		PCODE(PUSH3BYTES)
+			Stack[sp] = pc[0];
+			Stack[sp+1] = pc[1];
+			Stack[sp+2] = pc[2];
 			sp += 3;
-			pc = (int *)((uint8_t *)pc + 3);
-			break;
+			pc += 3;
+			NEXTPCODE;
 
-		case PCD_PUSH4BYTES:
-			Stack[sp] = ((uint8_t *)pc)[0];
-			Stack[sp+1] = ((uint8_t *)pc)[1];
-			Stack[sp+2] = ((uint8_t *)pc)[2];
-			Stack[sp+3] = ((uint8_t *)pc)[3];
+		PCODE(PUSH4BYTES)
+			Stack[sp] = pc[0];
+			Stack[sp+1] = pc[1];
+			Stack[sp+2] = pc[2];
+			Stack[sp+3] = pc[3];
 			sp += 4;
-			pc = (int *)((uint8_t *)pc + 4);
-			break;
-
-		case PCD_PUSH5BYTES:
-			Stack[sp] = ((uint8_t *)pc)[0];
-			Stack[sp+1] = ((uint8_t *)pc)[1];
-			Stack[sp+2] = ((uint8_t *)pc)[2];
-			Stack[sp+3] = ((uint8_t *)pc)[3];
-			Stack[sp+4] = ((uint8_t *)pc)[4];
+			pc += 4;
+			NEXTPCODE;
+
+		PCODE(PUSH5BYTES)
+			Stack[sp] = pc[0];
+			Stack[sp+1] = pc[1];
+			Stack[sp+2] = pc[2];
+			Stack[sp+3] = pc[3];
+			Stack[sp+4] = pc[4];
 			sp += 5;
-			pc = (int *)((uint8_t *)pc + 5);
-			break;
+			pc += 5;
+			NEXTPCODE;
 
-		case PCD_PUSHBYTES:
-			temp = *(uint8_t *)pc;
-			pc = (int *)((uint8_t *)pc + temp + 1);
-			for (temp = -temp; temp; temp++)
+		PCODE(PUSHBYTES)
+			for (temp = NEXTWORD; temp > 0; temp--)
 			{
-				PushToStack (*((uint8_t *)pc + temp));
+				PushToStack (NEXTWORD);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DUP:
+		PCODE(DUP)
 			Stack[sp] = Stack[sp-1];
 			sp++;
-			break;
+			NEXTPCODE;
 
-		case PCD_SWAP:
+		PCODE(SWAP)
 			std::swap(Stack[sp-2], Stack[sp-1]);
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC1:
+		PCODE(LSPEC1)
 			P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(1) & specialargmask, 0, 0, 0, 0);
 			sp -= 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC2:
+		PCODE(LSPEC2)
 			P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask, 0, 0, 0);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC3:
+		PCODE(LSPEC3)
 			P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(3) & specialargmask,
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask, 0, 0);
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC4:
+		PCODE(LSPEC4)
 			P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(4) & specialargmask,
 									STACK(3) & specialargmask,
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask, 0);
 			sp -= 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC5:
+		PCODE(LSPEC5)
 			P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(5) & specialargmask,
 									STACK(4) & specialargmask,
@@ -7037,9 +7673,9 @@ int DLevelScript::RunScript()
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask);
 			sp -= 5;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC5RESULT:
+		PCODE(LSPEC5RESULT)
 			STACK(5) = P_ExecuteSpecial(Level, NEXTBYTE, activationline, activator, backSide,
 									STACK(5) & specialargmask,
 									STACK(4) & specialargmask,
@@ -7047,9 +7683,9 @@ int DLevelScript::RunScript()
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask);
 			sp -= 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC5EX:
+		PCODE(LSPEC5EX)
 			P_ExecuteSpecial(Level, NEXTWORD, activationline, activator, backSide,
 									STACK(5) & specialargmask,
 									STACK(4) & specialargmask,
@@ -7057,9 +7693,9 @@ int DLevelScript::RunScript()
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask);
 			sp -= 5;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC5EXRESULT:
+		PCODE(LSPEC5EXRESULT)
 			STACK(5) = P_ExecuteSpecial(Level, NEXTWORD, activationline, activator, backSide,
 									STACK(5) & specialargmask,
 									STACK(4) & specialargmask,
@@ -7067,87 +7703,87 @@ int DLevelScript::RunScript()
 									STACK(2) & specialargmask,
 									STACK(1) & specialargmask);
 			sp -= 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC1DIRECT:
+		PCODE(LSPEC1DIRECT)
 			temp = NEXTBYTE;
 			P_ExecuteSpecial(Level, temp, activationline, activator, backSide,
-								uallong(pc[0]) & specialargmask ,0, 0, 0, 0);
+								pc[0] & specialargmask ,0, 0, 0, 0);
 			pc += 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC2DIRECT:
+		PCODE(LSPEC2DIRECT)
 			temp = NEXTBYTE;
 			P_ExecuteSpecial(Level, temp, activationline, activator, backSide,
-								uallong(pc[0]) & specialargmask,
-								uallong(pc[1]) & specialargmask, 0, 0, 0);
+								pc[0] & specialargmask,
+								pc[1] & specialargmask, 0, 0, 0);
 			pc += 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC3DIRECT:
+		PCODE(LSPEC3DIRECT)
 			temp = NEXTBYTE;
 			P_ExecuteSpecial(Level, temp, activationline, activator, backSide,
-								uallong(pc[0]) & specialargmask,
-								uallong(pc[1]) & specialargmask,
-								uallong(pc[2]) & specialargmask, 0, 0);
+								pc[0] & specialargmask,
+								pc[1] & specialargmask,
+								pc[2] & specialargmask, 0, 0);
 			pc += 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC4DIRECT:
+		PCODE(LSPEC4DIRECT)
 			temp = NEXTBYTE;
 			P_ExecuteSpecial(Level, temp, activationline, activator, backSide,
-								uallong(pc[0]) & specialargmask,
-								uallong(pc[1]) & specialargmask,
-								uallong(pc[2]) & specialargmask,
-								uallong(pc[3]) & specialargmask, 0);
+								pc[0] & specialargmask,
+								pc[1] & specialargmask,
+								pc[2] & specialargmask,
+								pc[3] & specialargmask, 0);
 			pc += 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSPEC5DIRECT:
+		PCODE(LSPEC5DIRECT)
 			temp = NEXTBYTE;
 			P_ExecuteSpecial(Level, temp, activationline, activator, backSide,
-								uallong(pc[0]) & specialargmask,
-								uallong(pc[1]) & specialargmask,
-								uallong(pc[2]) & specialargmask,
-								uallong(pc[3]) & specialargmask,
-								uallong(pc[4]) & specialargmask);
+								pc[0] & specialargmask,
+								pc[1] & specialargmask,
+								pc[2] & specialargmask,
+								pc[3] & specialargmask,
+								pc[4] & specialargmask);
 			pc += 5;
-			break;
+			NEXTPCODE;
 
 		// Parameters for PCD_LSPEC?DIRECTB are by definition bytes so never need and-ing.
-		case PCD_LSPEC1DIRECTB:
-			P_ExecuteSpecial(Level, ((uint8_t *)pc)[0], activationline, activator, backSide,
-				((uint8_t *)pc)[1], 0, 0, 0, 0);
-			pc = (int *)((uint8_t *)pc + 2);
-			break;
+		PCODE(LSPEC1DIRECTB)
+			P_ExecuteSpecial(Level, pc[0], activationline, activator, backSide,
+				pc[1], 0, 0, 0, 0);
+			pc += 2;
+			NEXTPCODE;
 
-		case PCD_LSPEC2DIRECTB:
-			P_ExecuteSpecial(Level, ((uint8_t *)pc)[0], activationline, activator, backSide,
-				((uint8_t *)pc)[1], ((uint8_t *)pc)[2], 0, 0, 0);
-			pc = (int *)((uint8_t *)pc + 3);
-			break;
+		PCODE(LSPEC2DIRECTB)
+			P_ExecuteSpecial(Level, pc[0], activationline, activator, backSide,
+				pc[1], pc[2], 0, 0, 0);
+			pc += 3;
+			NEXTPCODE;
 
-		case PCD_LSPEC3DIRECTB:
-			P_ExecuteSpecial(Level, ((uint8_t *)pc)[0], activationline, activator, backSide,
-				((uint8_t *)pc)[1], ((uint8_t *)pc)[2], ((uint8_t *)pc)[3], 0, 0);
-			pc = (int *)((uint8_t *)pc + 4);
-			break;
+		PCODE(LSPEC3DIRECTB)
+			P_ExecuteSpecial(Level, pc[0], activationline, activator, backSide,
+				pc[1], pc[2], pc[3], 0, 0);
+			pc += 4;
+			NEXTPCODE;
 
-		case PCD_LSPEC4DIRECTB:
-			P_ExecuteSpecial(Level, ((uint8_t *)pc)[0], activationline, activator, backSide,
-				((uint8_t *)pc)[1], ((uint8_t *)pc)[2], ((uint8_t *)pc)[3],
-				((uint8_t *)pc)[4], 0);
-			pc = (int *)((uint8_t *)pc + 5);
-			break;
+		PCODE(LSPEC4DIRECTB)
+			P_ExecuteSpecial(Level, pc[0], activationline, activator, backSide,
+				pc[1], pc[2], pc[3],
+				pc[4], 0);
+			pc += 5;
+			NEXTPCODE;
 
-		case PCD_LSPEC5DIRECTB:
-			P_ExecuteSpecial(Level, ((uint8_t *)pc)[0], activationline, activator, backSide,
-				((uint8_t *)pc)[1], ((uint8_t *)pc)[2], ((uint8_t *)pc)[3],
-				((uint8_t *)pc)[4], ((uint8_t *)pc)[5]);
-			pc = (int *)((uint8_t *)pc + 6);
-			break;
+		PCODE(LSPEC5DIRECTB)
+			P_ExecuteSpecial(Level, pc[0], activationline, activator, backSide,
+				pc[1], pc[2], pc[3],
+				pc[4], pc[5]);
+			pc += 6;
+			NEXTPCODE;
 
-		case PCD_CALLFUNC:
+		PCODE(CALLFUNC)
 			{
 				int argCount = NEXTBYTE;
 				int funcIndex = NEXTSHORT;
@@ -7156,18 +7792,18 @@ int DLevelScript::RunScript()
 				sp -= argCount-1;
 				STACK(1) = retval;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHFUNCTION:
+		PCODE(PUSHFUNCTION)
 		{
 			int funcnum = NEXTBYTE;
 			// Not technically a string, but since we use the same tagging mechanism
 			PushToStack(TAGSTR(funcnum));
 			break;
 		}
-		case PCD_CALL:
-		case PCD_CALLDISCARD:
-		case PCD_CALLSTACK:
+		PCODE(CALL)
+		PCODE(CALLDISCARD)
+		PCODE(CALLSTACK)
 			{
 				int funcnum;
 				int i;
@@ -7210,19 +7846,19 @@ int DLevelScript::RunScript()
 					Stack[sp+i] = 0;
 				}
 				sp += i;
-				::new(&Stack[sp]) CallReturn(activeBehavior->PC2Ofs(pc), activeFunction,
+				::new(&Stack[sp]) CallReturn(pc, activeFunction,
 					activeBehavior, mylocals, localarrays, pcd == PCD_CALLDISCARD, runaway);
 				sp += (sizeof(CallReturn) + sizeof(int) - 1) / sizeof(int);
-				pc = module->Ofs2PC (func->Address);
+				pc = module->GetFunctionAddress (func);
 				localarrays = &func->LocalArrays;
 				activeFunction = func;
 				activeBehavior = module;
 				fmt = module->GetFormat();
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_RETURNVOID:
-		case PCD_RETURNVAL:
+		PCODE(RETURNVOID)
+		PCODE(RETURNVAL)
 			{
 				int value;
 				union
@@ -7243,7 +7879,7 @@ int DLevelScript::RunScript()
 				retsp = &Stack[sp];
 				activeBehavior->GetFunctionProfileData(activeFunction)->AddRun(runaway - ret->EntryInstrCount);
 				sp = int(locals.GetPointer() - &Stack[0]);
-				pc = ret->ReturnModule->Ofs2PC(ret->ReturnAddress);
+				pc = ret->ReturnAddress;
 				activeFunction = ret->ReturnFunction;
 				activeBehavior = ret->ReturnModule;
 				fmt = activeBehavior->GetFormat();
@@ -7255,24 +7891,24 @@ int DLevelScript::RunScript()
 				}
 				ret->~CallReturn();
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ADD:
+		PCODE(ADD)
 			STACK(2) = STACK(2) + STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBTRACT:
+		PCODE(SUBTRACT)
 			STACK(2) = STACK(2) - STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_MULTIPLY:
+		PCODE(MULTIPLY)
 			STACK(2) = STACK(2) * STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVIDE:
+		PCODE(DIVIDE)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7282,9 +7918,9 @@ int DLevelScript::RunScript()
 				STACK(2) = STACK(2) / STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODULUS:
+		PCODE(MODULUS)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7294,271 +7930,271 @@ int DLevelScript::RunScript()
 				STACK(2) = STACK(2) % STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_EQ:
+		PCODE(EQ)
 			STACK(2) = (STACK(2) == STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_NE:
+		PCODE(NE)
 			STACK(2) = (STACK(2) != STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LT:
+		PCODE(LT)
 			STACK(2) = (STACK(2) < STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_GT:
+		PCODE(GT)
 			STACK(2) = (STACK(2) > STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LE:
+		PCODE(LE)
 			STACK(2) = (STACK(2) <= STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_GE:
+		PCODE(GE)
 			STACK(2) = (STACK(2) >= STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNSCRIPTVAR:
+		PCODE(ASSIGNSCRIPTVAR)
 			locals[NEXTBYTE] = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
 
-		case PCD_ASSIGNMAPVAR:
+		PCODE(ASSIGNMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNWORLDVAR:
+		PCODE(ASSIGNWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNGLOBALVAR:
+		PCODE(ASSIGNGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNSCRIPTARRAY:
+		PCODE(ASSIGNSCRIPTARRAY)
 			localarrays->Set(locals, NEXTBYTE, STACK(2), STACK(1));
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNMAPARRAY:
+		PCODE(ASSIGNMAPARRAY)
 			activeBehavior->SetArrayVal (*(activeBehavior->MapVars[NEXTBYTE]), STACK(2), STACK(1));
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNWORLDARRAY:
+		PCODE(ASSIGNWORLDARRAY)
 			ACS_WorldArrays[NEXTBYTE][STACK(2)] = STACK(1);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_ASSIGNGLOBALARRAY:
+		PCODE(ASSIGNGLOBALARRAY)
 			ACS_GlobalArrays[NEXTBYTE][STACK(2)] = STACK(1);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHSCRIPTVAR:
+		PCODE(PUSHSCRIPTVAR)
 			PushToStack (locals[NEXTBYTE]);
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHMAPVAR:
+		PCODE(PUSHMAPVAR)
 			PushToStack (*(activeBehavior->MapVars[NEXTBYTE]));
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHWORLDVAR:
+		PCODE(PUSHWORLDVAR)
 			PushToStack (ACS_WorldVars[NEXTBYTE]);
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHGLOBALVAR:
+		PCODE(PUSHGLOBALVAR)
 			PushToStack (ACS_GlobalVars[NEXTBYTE]);
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHSCRIPTARRAY:
+		PCODE(PUSHSCRIPTARRAY)
 			STACK(1) = localarrays->Get(locals, NEXTBYTE, STACK(1));
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHMAPARRAY:
+		PCODE(PUSHMAPARRAY)
 			STACK(1) = activeBehavior->GetArrayVal (*(activeBehavior->MapVars[NEXTBYTE]), STACK(1));
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHWORLDARRAY:
+		PCODE(PUSHWORLDARRAY)
 			STACK(1) = ACS_WorldArrays[NEXTBYTE][STACK(1)];
-			break;
+			NEXTPCODE;
 
-		case PCD_PUSHGLOBALARRAY:
+		PCODE(PUSHGLOBALARRAY)
 			STACK(1) = ACS_GlobalArrays[NEXTBYTE][STACK(1)];
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDSCRIPTVAR:
+		PCODE(ADDSCRIPTVAR)
 			locals[NEXTBYTE] += STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDMAPVAR:
+		PCODE(ADDMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) += STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDWORLDVAR:
+		PCODE(ADDWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] += STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDGLOBALVAR:
+		PCODE(ADDGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] += STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDSCRIPTARRAY:
+		PCODE(ADDSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) + STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDMAPARRAY:
+		PCODE(ADDMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) + STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDWORLDARRAY:
+		PCODE(ADDWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] += STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ADDGLOBALARRAY:
+		PCODE(ADDGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] += STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBSCRIPTVAR:
+		PCODE(SUBSCRIPTVAR)
 			locals[NEXTBYTE] -= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBMAPVAR:
+		PCODE(SUBMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) -= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBWORLDVAR:
+		PCODE(SUBWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] -= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBGLOBALVAR:
+		PCODE(SUBGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] -= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBSCRIPTARRAY:
+		PCODE(SUBSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) - STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBMAPARRAY:
+		PCODE(SUBMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) - STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBWORLDARRAY:
+		PCODE(SUBWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] -= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SUBGLOBALARRAY:
+		PCODE(SUBGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] -= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MULSCRIPTVAR:
+		PCODE(MULSCRIPTVAR)
 			locals[NEXTBYTE] *= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_MULMAPVAR:
+		PCODE(MULMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) *= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_MULWORLDVAR:
+		PCODE(MULWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] *= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_MULGLOBALVAR:
+		PCODE(MULGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] *= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_MULSCRIPTARRAY:
+		PCODE(MULSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) * STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MULMAPARRAY:
+		PCODE(MULMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) * STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MULWORLDARRAY:
+		PCODE(MULWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] *= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MULGLOBALARRAY:
+		PCODE(MULGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] *= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVSCRIPTVAR:
+		PCODE(DIVSCRIPTVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7568,9 +8204,9 @@ int DLevelScript::RunScript()
 				locals[NEXTBYTE] /= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVMAPVAR:
+		PCODE(DIVMAPVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7580,9 +8216,9 @@ int DLevelScript::RunScript()
 				*(activeBehavior->MapVars[NEXTBYTE]) /= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVWORLDVAR:
+		PCODE(DIVWORLDVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7592,9 +8228,9 @@ int DLevelScript::RunScript()
 				ACS_WorldVars[NEXTBYTE] /= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVGLOBALVAR:
+		PCODE(DIVGLOBALVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7604,9 +8240,9 @@ int DLevelScript::RunScript()
 				ACS_GlobalVars[NEXTBYTE] /= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVSCRIPTARRAY:
+		PCODE(DIVSCRIPTARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7617,9 +8253,9 @@ int DLevelScript::RunScript()
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) / STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVMAPARRAY:
+		PCODE(DIVMAPARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7631,9 +8267,9 @@ int DLevelScript::RunScript()
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) / STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVWORLDARRAY:
+		PCODE(DIVWORLDARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7644,9 +8280,9 @@ int DLevelScript::RunScript()
 				ACS_WorldArrays[a][STACK(2)] /= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DIVGLOBALARRAY:
+		PCODE(DIVGLOBALARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_DivideBy0;
@@ -7657,9 +8293,9 @@ int DLevelScript::RunScript()
 				ACS_GlobalArrays[a][STACK(2)] /= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODSCRIPTVAR:
+		PCODE(MODSCRIPTVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7669,9 +8305,9 @@ int DLevelScript::RunScript()
 				locals[NEXTBYTE] %= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODMAPVAR:
+		PCODE(MODMAPVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7681,9 +8317,9 @@ int DLevelScript::RunScript()
 				*(activeBehavior->MapVars[NEXTBYTE]) %= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODWORLDVAR:
+		PCODE(MODWORLDVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7693,9 +8329,9 @@ int DLevelScript::RunScript()
 				ACS_WorldVars[NEXTBYTE] %= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODGLOBALVAR:
+		PCODE(MODGLOBALVAR)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7705,9 +8341,9 @@ int DLevelScript::RunScript()
 				ACS_GlobalVars[NEXTBYTE] %= STACK(1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODSCRIPTARRAY:
+		PCODE(MODSCRIPTARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7718,9 +8354,9 @@ int DLevelScript::RunScript()
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) % STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODMAPARRAY:
+		PCODE(MODMAPARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7732,9 +8368,9 @@ int DLevelScript::RunScript()
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) % STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODWORLDARRAY:
+		PCODE(MODWORLDARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7745,9 +8381,9 @@ int DLevelScript::RunScript()
 				ACS_WorldArrays[a][STACK(2)] %= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_MODGLOBALARRAY:
+		PCODE(MODGLOBALARRAY)
 			if (STACK(1) == 0)
 			{
 				state = SCRIPT_ModulusBy0;
@@ -7758,582 +8394,581 @@ int DLevelScript::RunScript()
 				ACS_GlobalArrays[a][STACK(2)] %= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
 		//[MW] start
-		case PCD_ANDSCRIPTVAR:
+		PCODE(ANDSCRIPTVAR)
 			locals[NEXTBYTE] &= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDMAPVAR:
+		PCODE(ANDMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) &= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDWORLDVAR:
+		PCODE(ANDWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] &= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDGLOBALVAR:
+		PCODE(ANDGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] &= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDSCRIPTARRAY:
+		PCODE(ANDSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) & STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDMAPARRAY:
+		PCODE(ANDMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) & STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDWORLDARRAY:
+		PCODE(ANDWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] &= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDGLOBALARRAY:
+		PCODE(ANDGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] &= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_EORSCRIPTVAR:
+		PCODE(EORSCRIPTVAR)
 			locals[NEXTBYTE] ^= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_EORMAPVAR:
+		PCODE(EORMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) ^= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_EORWORLDVAR:
+		PCODE(EORWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] ^= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_EORGLOBALVAR:
+		PCODE(EORGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] ^= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_EORSCRIPTARRAY:
+		PCODE(EORSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) ^ STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_EORMAPARRAY:
+		PCODE(EORMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) ^ STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_EORWORLDARRAY:
+		PCODE(EORWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] ^= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_EORGLOBALARRAY:
+		PCODE(EORGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] ^= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ORSCRIPTVAR:
+		PCODE(ORSCRIPTVAR)
 			locals[NEXTBYTE] |= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORMAPVAR:
+		PCODE(ORMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) |= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORWORLDVAR:
+		PCODE(ORWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] |= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORGLOBALVAR:
+		PCODE(ORGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] |= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORSCRIPTARRAY:
+		PCODE(ORSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) | STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ORMAPARRAY:
+		PCODE(ORMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) | STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ORWORLDARRAY:
+		PCODE(ORWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] |= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ORGLOBALARRAY:
+		PCODE(ORGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				int i = STACK(2);
 				ACS_GlobalArrays[a][STACK(2)] |= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_LSSCRIPTVAR:
+		PCODE(LSSCRIPTVAR)
 			locals[NEXTBYTE] <<= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSMAPVAR:
+		PCODE(LSMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) <<= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSWORLDVAR:
+		PCODE(LSWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] <<= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSGLOBALVAR:
+		PCODE(LSGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] <<= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LSSCRIPTARRAY:
+		PCODE(LSSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) << STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_LSMAPARRAY:
+		PCODE(LSMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) << STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_LSWORLDARRAY:
+		PCODE(LSWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] <<= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_LSGLOBALARRAY:
+		PCODE(LSGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] <<= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_RSSCRIPTVAR:
+		PCODE(RSSCRIPTVAR)
 			locals[NEXTBYTE] >>= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RSMAPVAR:
+		PCODE(RSMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) >>= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RSWORLDVAR:
+		PCODE(RSWORLDVAR)
 			ACS_WorldVars[NEXTBYTE] >>= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RSGLOBALVAR:
+		PCODE(RSGLOBALVAR)
 			ACS_GlobalVars[NEXTBYTE] >>= STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RSSCRIPTARRAY:
+		PCODE(RSSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(2);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) >> STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_RSMAPARRAY:
+		PCODE(RSMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(2);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) >> STACK(1));
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_RSWORLDARRAY:
+		PCODE(RSWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(2)] >>= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_RSGLOBALARRAY:
+		PCODE(RSGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(2)] >>= STACK(1);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 		//[MW] end
 
-		case PCD_INCSCRIPTVAR:
+		PCODE(INCSCRIPTVAR)
 			++locals[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_INCMAPVAR:
+		PCODE(INCMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) += 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_INCWORLDVAR:
+		PCODE(INCWORLDVAR)
 			++ACS_WorldVars[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_INCGLOBALVAR:
+		PCODE(INCGLOBALVAR)
 			++ACS_GlobalVars[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_INCSCRIPTARRAY:
+		PCODE(INCSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(1);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) + 1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_INCMAPARRAY:
+		PCODE(INCMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(1);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) + 1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_INCWORLDARRAY:
+		PCODE(INCWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(1)] += 1;
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_INCGLOBALARRAY:
+		PCODE(INCGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_GlobalArrays[a][STACK(1)] += 1;
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DECSCRIPTVAR:
+		PCODE(DECSCRIPTVAR)
 			--locals[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_DECMAPVAR:
+		PCODE(DECMAPVAR)
 			*(activeBehavior->MapVars[NEXTBYTE]) -= 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_DECWORLDVAR:
+		PCODE(DECWORLDVAR)
 			--ACS_WorldVars[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_DECGLOBALVAR:
+		PCODE(DECGLOBALVAR)
 			--ACS_GlobalVars[NEXTBYTE];
-			break;
+			NEXTPCODE;
 
-		case PCD_DECSCRIPTARRAY:
+		PCODE(DECSCRIPTARRAY)
 			{
 				int a = NEXTBYTE, i = STACK(1);
 				localarrays->Set(locals, a, i, localarrays->Get(locals, a, i) - 1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DECMAPARRAY:
+		PCODE(DECMAPARRAY)
 			{
 				int a = *(activeBehavior->MapVars[NEXTBYTE]);
 				int i = STACK(1);
 				activeBehavior->SetArrayVal (a, i, activeBehavior->GetArrayVal (a, i) - 1);
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DECWORLDARRAY:
+		PCODE(DECWORLDARRAY)
 			{
 				int a = NEXTBYTE;
 				ACS_WorldArrays[a][STACK(1)] -= 1;
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DECGLOBALARRAY:
+		PCODE(DECGLOBALARRAY)
 			{
 				int a = NEXTBYTE;
 				int i = STACK(1);
 				ACS_GlobalArrays[a][STACK(1)] -= 1;
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GOTO:
-			pc = activeBehavior->Ofs2PC (LittleLong(*pc));
-			break;
+		PCODE(GOTO)
+			pc += *pc;
+			NEXTPCODE;
 
-		case PCD_GOTOSTACK:
+		PCODE(GOTOSTACK)
 			pc = activeBehavior->Jump2PC (STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_IFGOTO:
+		PCODE(IFGOTO)
 			if (STACK(1))
-				pc = activeBehavior->Ofs2PC (LittleLong(*pc));
+				pc += *pc;
 			else
 				pc++;
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETRESULTVALUE:
+		PCODE(SETRESULTVALUE)
 			resultValue = STACK(1);
 			[[fallthrough]];
-		case PCD_DROP: //fall through.
+		PCODE(DROP) //fall through.
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_DELAY:
+		PCODE(DELAY)
 			statedata = STACK(1) + (fmt == ACS_Old && gameinfo.gametype == GAME_Hexen);
 			if (statedata > 0)
 			{
 				state = SCRIPT_Delayed;
 			}
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_DELAYDIRECT:
-			statedata = uallong(pc[0]) + (fmt == ACS_Old && gameinfo.gametype == GAME_Hexen);
+		PCODE(DELAYDIRECT)
+			statedata = pc[0] + (fmt == ACS_Old && gameinfo.gametype == GAME_Hexen);
 			pc++;
 			if (statedata > 0)
 			{
 				state = SCRIPT_Delayed;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_DELAYDIRECTB:
-			statedata = *(uint8_t *)pc + (fmt == ACS_Old && gameinfo.gametype == GAME_Hexen);
+		PCODE(DELAYDIRECTB)
+			statedata = NEXTWORD + (fmt == ACS_Old && gameinfo.gametype == GAME_Hexen);
 			if (statedata > 0)
 			{
 				state = SCRIPT_Delayed;
 			}
-			pc = (int *)((uint8_t *)pc + 1);
-			break;
+			NEXTPCODE;
 
-		case PCD_RANDOM:
+		PCODE(RANDOM)
 			STACK(2) = Random (STACK(2), STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RANDOMDIRECT:
-			PushToStack (Random (uallong(pc[0]), uallong(pc[1])));
+		PCODE(RANDOMDIRECT)
+			PushToStack (Random (pc[0], pc[1]));
 			pc += 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_RANDOMDIRECTB:
-			PushToStack (Random (((uint8_t *)pc)[0], ((uint8_t *)pc)[1]));
-			pc = (int *)((uint8_t *)pc + 2);
-			break;
+		PCODE(RANDOMDIRECTB)
+			PushToStack (Random (pc[0], pc[1]));
+			pc += 2;
+			NEXTPCODE;
 
-		case PCD_THINGCOUNT:
+		PCODE(THINGCOUNT)
 			STACK(2) = ThingCount (STACK(2), -1, STACK(1), -1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGCOUNTDIRECT:
-			PushToStack (ThingCount (uallong(pc[0]), -1, uallong(pc[1]), -1));
+		PCODE(THINGCOUNTDIRECT)
+			PushToStack (ThingCount (pc[0], -1, pc[1], -1));
 			pc += 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGCOUNTNAME:
+		PCODE(THINGCOUNTNAME)
 			STACK(2) = ThingCount (-1, STACK(2), STACK(1), -1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGCOUNTNAMESECTOR:
+		PCODE(THINGCOUNTNAMESECTOR)
 			STACK(3) = ThingCount (-1, STACK(3), STACK(2), STACK(1));
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGCOUNTSECTOR:
+		PCODE(THINGCOUNTSECTOR)
 			STACK(3) = ThingCount (STACK(3), -1, STACK(2), STACK(1));
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_TAGWAIT:
+		PCODE(TAGWAIT)
 			state = SCRIPT_TagWait;
 			statedata = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_TAGWAITDIRECT:
+		PCODE(TAGWAITDIRECT)
 			state = SCRIPT_TagWait;
-			statedata = uallong(pc[0]);
+			statedata = pc[0];
 			pc++;
-			break;
+			NEXTPCODE;
 
-		case PCD_POLYWAIT:
+		PCODE(POLYWAIT)
 			state = SCRIPT_PolyWait;
 			statedata = STACK(1);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_POLYWAITDIRECT:
+		PCODE(POLYWAITDIRECT)
 			state = SCRIPT_PolyWait;
-			statedata = uallong(pc[0]);
+			statedata = pc[0];
 			pc++;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGEFLOOR:
+		PCODE(CHANGEFLOOR)
 			ChangeFlat (STACK(2), STACK(1), 0);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGEFLOORDIRECT:
-			ChangeFlat (uallong(pc[0]), TAGSTR(uallong(pc[1])), 0);
+		PCODE(CHANGEFLOORDIRECT)
+			ChangeFlat (pc[0], TAGSTR(pc[1]), 0);
 			pc += 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGECEILING:
+		PCODE(CHANGECEILING)
 			ChangeFlat (STACK(2), STACK(1), 1);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGECEILINGDIRECT:
-			ChangeFlat (uallong(pc[0]), TAGSTR(uallong(pc[1])), 1);
+		PCODE(CHANGECEILINGDIRECT)
+			ChangeFlat (pc[0], TAGSTR(pc[1]), 1);
 			pc += 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_RESTART:
+		PCODE(RESTART)
 			{
 				const ScriptPtr *scriptp;
 
 				scriptp = activeBehavior->FindScript (script);
 				pc = activeBehavior->GetScriptAddress (scriptp);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDLOGICAL:
+		PCODE(ANDLOGICAL)
 			STACK(2) = (STACK(2) && STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORLOGICAL:
+		PCODE(ORLOGICAL)
 			STACK(2) = (STACK(2) || STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ANDBITWISE:
+		PCODE(ANDBITWISE)
 			STACK(2) = (STACK(2) & STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_ORBITWISE:
+		PCODE(ORBITWISE)
 			STACK(2) = (STACK(2) | STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_EORBITWISE:
+		PCODE(EORBITWISE)
 			STACK(2) = (STACK(2) ^ STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_NEGATELOGICAL:
+		PCODE(NEGATELOGICAL)
 			STACK(1) = !STACK(1);
-			break;
+			NEXTPCODE;
 
 
 
 
-		case PCD_NEGATEBINARY:
+		PCODE(NEGATEBINARY)
 			STACK(1) = ~STACK(1);
-			break;
+			NEXTPCODE;
 
-		case PCD_LSHIFT:
+		PCODE(LSHIFT)
 			STACK(2) = (STACK(2) << STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_RSHIFT:
+		PCODE(RSHIFT)
 			STACK(2) = (STACK(2) >> STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_UNARYMINUS:
+		PCODE(UNARYMINUS)
 			STACK(1) = -STACK(1);
-			break;
+			NEXTPCODE;
 
-		case PCD_IFNOTGOTO:
+		PCODE(IFNOTGOTO)
 			if (!STACK(1))
-				pc = activeBehavior->Ofs2PC (LittleLong(*pc));
+				pc += *pc;
 			else
 				pc++;
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_LINESIDE:
+		PCODE(LINESIDE)
 			PushToStack (backSide);
-			break;
+			NEXTPCODE;
 
-		case PCD_SCRIPTWAIT:
+		PCODE(SCRIPTWAIT)
 			statedata = STACK(1);
 			sp--;
 scriptwait:
@@ -8342,12 +8977,12 @@ scriptwait:
 			else
 				state = SCRIPT_ScriptWaitPre;
 			PutLast ();
-			break;
+			NEXTPCODE;
 
-		case PCD_SCRIPTWAITDIRECT:
+		PCODE(SCRIPTWAITDIRECT)
 			if (!(Level->i_compatflags2 & COMPATF2_SCRIPTWAIT))
 			{
-				statedata = uallong(pc[0]);
+				statedata = pc[0];
 				pc++;
 				goto scriptwait;
 			}
@@ -8355,50 +8990,49 @@ scriptwait:
 			{
 				// Old implementation for compatibility with Daedalus MAP19
 				state = SCRIPT_ScriptWait;
-				statedata = uallong(pc[0]);
+				statedata = pc[0];
 				pc++;
 				PutLast();
 				break;
 			}
 
-		case PCD_SCRIPTWAITNAMED:
+		PCODE(SCRIPTWAITNAMED)
 			statedata = -FName(Level->Behaviors.LookupString(STACK(1))).GetIndex();
 			sp--;
 			goto scriptwait;
 
-		case PCD_CLEARLINESPECIAL:
+		PCODE(CLEARLINESPECIAL)
 			if (activationline != NULL)
 			{
 				activationline->special = 0;
+				P_GeometryChanged();
 				DPrintf(DMSG_SPAMMY, "Cleared line special on line %d\n", activationline->Index());
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_CASEGOTO:
-			if (STACK(1) == uallong(pc[0]))
+		PCODE(CASEGOTO)
+			if (STACK(1) == pc[0])
 			{
-				pc = activeBehavior->Ofs2PC (uallong(pc[1]));
+				pc += 1 + pc[1];
 				sp--;
 			}
 			else
 			{
 				pc += 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_CASEGOTOSORTED:
-			// The count and jump table are 4-byte aligned
-			pc = (int *)(((size_t)pc + 3) & ~3);
+		PCODE(CASEGOTOSORTED)
 			{
-				int numcases = uallong(pc[0]); pc++;
+				int numcases = pc[0]; pc++;
 				int min = 0, max = numcases-1;
 				while (min <= max)
 				{
 					int mid = (min + max) / 2;
-					int32_t caseval = LittleLong(pc[mid*2]);
+					int32_t caseval = pc[mid*2];
 					if (caseval == STACK(1))
 					{
-						pc = activeBehavior->Ofs2PC (LittleLong(pc[mid*2+1]));
+						pc += mid*2+1 + pc[mid*2+1];
 						sp--;
 						break;
 					}
@@ -8417,14 +9051,14 @@ scriptwait:
 					pc += numcases * 2;
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_BEGINPRINT:
+		PCODE(BEGINPRINT)
 			STRINGBUILDER_START(work);
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTSTRING:
-		case PCD_PRINTLOCALIZED:
+		PCODE(PRINTSTRING)
+		PCODE(PRINTLOCALIZED)
 			lookup = Level->Behaviors.LookupString (STACK(1), true);
 			if (pcd == PCD_PRINTLOCALIZED)
 			{
@@ -8435,38 +9069,38 @@ scriptwait:
 				work += lookup;
 			}
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTNUMBER:
+		PCODE(PRINTNUMBER)
 			work.AppendFormat ("%d", STACK(1));
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTBINARY:
+		PCODE(PRINTBINARY)
 			IGNORE_FORMAT_PRE
 			work.AppendFormat ("%B", STACK(1));
 			IGNORE_FORMAT_POST
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTHEX:
+		PCODE(PRINTHEX)
 			work.AppendFormat ("%X", STACK(1));
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTCHARACTER:
+		PCODE(PRINTCHARACTER)
 			work += (char)STACK(1);
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_PRINTFIXED:
+		PCODE(PRINTFIXED)
 			work.AppendFormat ("%g", ACSToDouble(STACK(1)));
 			--sp;
-			break;
+			NEXTPCODE;
 
 		// [BC] Print activator's name
 		// [RH] Fancied up a bit
-		case PCD_PRINTNAME:
+		PCODE(PRINTNAME)
 			{
 				player_t *player = NULL;
 
@@ -8545,11 +9179,11 @@ scriptwait:
 				}
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
 		// Print script character array
-		case PCD_PRINTSCRIPTCHARARRAY:
-		case PCD_PRINTSCRIPTCHRANGE:
+		PCODE(PRINTSCRIPTCHARARRAY)
+		PCODE(PRINTSCRIPTCHRANGE)
 			{
 				int capacity, offset, a, c;
 				if (CharArrayParms(capacity, offset, a, Stack, sp, pcd == PCD_PRINTSCRIPTCHRANGE))
@@ -8561,11 +9195,11 @@ scriptwait:
 					}
 				}
 			}
-			break;
+			NEXTPCODE;
 
 		// [JB] Print map character array
-		case PCD_PRINTMAPCHARARRAY:
-		case PCD_PRINTMAPCHRANGE:
+		PCODE(PRINTMAPCHARARRAY)
+		PCODE(PRINTMAPCHRANGE)
 			{
 				int capacity, offset, a, c;
 				if (CharArrayParms(capacity, offset, a, Stack, sp, pcd == PCD_PRINTMAPCHRANGE))
@@ -8577,11 +9211,11 @@ scriptwait:
 					}
 				}
 			}
-			break;
+			NEXTPCODE;
 
 		// [JB] Print world character array
-		case PCD_PRINTWORLDCHARARRAY:
-		case PCD_PRINTWORLDCHRANGE:
+		PCODE(PRINTWORLDCHARARRAY)
+		PCODE(PRINTWORLDCHRANGE)
 			{
 				int capacity, offset, a, c;
 				if (CharArrayParms(capacity, offset, a, Stack, sp, pcd == PCD_PRINTWORLDCHRANGE))
@@ -8593,11 +9227,11 @@ scriptwait:
 					}
 				}
 			}
-			break;
+			NEXTPCODE;
 
 		// [JB] Print global character array
-		case PCD_PRINTGLOBALCHARARRAY:
-		case PCD_PRINTGLOBALCHRANGE:
+		PCODE(PRINTGLOBALCHARARRAY)
+		PCODE(PRINTGLOBALCHRANGE)
 			{
 				int capacity, offset, a, c;
 				if (CharArrayParms(capacity, offset, a, Stack, sp, pcd == PCD_PRINTGLOBALCHRANGE))
@@ -8609,10 +9243,10 @@ scriptwait:
 					}
 				}
 			}
-			break;
+			NEXTPCODE;
 
 		// [GRB] Print key name(s) for a command
-		case PCD_PRINTBIND:
+		PCODE(PRINTBIND)
 			lookup = Level->Behaviors.LookupString (STACK(1));
 			if (lookup != NULL)
 			{
@@ -8628,12 +9262,12 @@ scriptwait:
 					work << "??? (" << (char *)lookup << ')';
 			}
 			--sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_ENDPRINT:
-		case PCD_ENDPRINTBOLD:
-		case PCD_MOREHUDMESSAGE:
-		case PCD_ENDLOG:
+		PCODE(ENDPRINT)
+		PCODE(ENDPRINTBOLD)
+		PCODE(MOREHUDMESSAGE)
+		PCODE(ENDLOG)
 			if (pcd == PCD_ENDLOG)
 			{
 				Printf ("%s\n", work.GetChars());
@@ -8662,14 +9296,14 @@ scriptwait:
 			{
 				optstart = -1;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_OPTHUDMESSAGE:
+		PCODE(OPTHUDMESSAGE)
 			optstart = sp;
-			break;
+			NEXTPCODE;
 
-		case PCD_ENDHUDMESSAGE:
-		case PCD_ENDHUDMESSAGEBOLD:
+		PCODE(ENDHUDMESSAGE)
+		PCODE(ENDHUDMESSAGEBOLD)
 			if (optstart == -1)
 			{
 				optstart = sp;
@@ -8764,23 +9398,23 @@ scriptwait:
 			}
 			STRINGBUILDER_FINISH(work);
 			sp = optstart-6;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETFONT:
+		PCODE(SETFONT)
 			DoSetFont (STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETFONTDIRECT:
-			DoSetFont (TAGSTR(uallong(pc[0])));
+		PCODE(SETFONTDIRECT)
+			DoSetFont (TAGSTR(pc[0]));
 			pc++;
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERCOUNT:
+		PCODE(PLAYERCOUNT)
 			PushToStack (CountPlayers ());
-			break;
+			NEXTPCODE;
 
-		case PCD_GAMETYPE:
+		PCODE(GAMETYPE)
 			if (gamestate == GS_TITLELEVEL)
 				PushToStack (GAME_TITLE_MAP);
 			else if (deathmatch)
@@ -8789,32 +9423,32 @@ scriptwait:
 				PushToStack (GAME_NET_COOPERATIVE);
 			else
 				PushToStack (GAME_SINGLE_PLAYER);
-			break;
+			NEXTPCODE;
 
-		case PCD_GAMESKILL:
+		PCODE(GAMESKILL)
 			PushToStack (G_SkillProperty(SKILLP_ACSReturn));
-			break;
+			NEXTPCODE;
 
 // [BC] Start ST PCD's
-		case PCD_ISNETWORKGAME:
+		PCODE(ISNETWORKGAME)
 			PushToStack(netgame);
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERTEAM:
+		PCODE(PLAYERTEAM)
 			if ( activator && activator->player )
 				PushToStack( activator->player->userinfo.GetTeam() );
 			else
 				PushToStack( 0 );
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERHEALTH:
+		PCODE(PLAYERHEALTH)
 			if (activator)
 				PushToStack (activator->health);
 			else
 				PushToStack (0);
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERARMORPOINTS:
+		PCODE(PLAYERARMORPOINTS)
 			if (activator)
 			{
 				auto armor = activator->FindInventory(NAME_BasicArmor);
@@ -8824,34 +9458,34 @@ scriptwait:
 			{
 				PushToStack (0);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERFRAGS:
+		PCODE(PLAYERFRAGS)
 			if (activator && activator->player)
 				PushToStack (activator->player->fragcount);
 			else
 				PushToStack (0);
-			break;
+			NEXTPCODE;
 
-		case PCD_MUSICCHANGE:
+		PCODE(MUSICCHANGE)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL)
 			{
 				S_ChangeMusic (lookup, STACK(1));
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SINGLEPLAYER:
+		PCODE(SINGLEPLAYER)
 			PushToStack (!multiplayer);
-			break;
+			NEXTPCODE;
 // [BC] End ST PCD's
 
-		case PCD_TIMER:
+		PCODE(TIMER)
 			PushToStack (Level->time);
-			break;
+			NEXTPCODE;
 
-		case PCD_SECTORSOUND:
+		PCODE(SECTORSOUND)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL)
 			{
@@ -8874,9 +9508,9 @@ scriptwait:
 				}
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_AMBIENTSOUND:
+		PCODE(AMBIENTSOUND)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL)
 			{
@@ -8885,9 +9519,9 @@ scriptwait:
 						 (float)(STACK(1)) / 127.f, ATTN_NONE);
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_LOCALAMBIENTSOUND:
+		PCODE(LOCALAMBIENTSOUND)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL && activator && activator->CheckLocalView())
 			{
@@ -8896,9 +9530,9 @@ scriptwait:
 						 (float)(STACK(1)) / 127.f, ATTN_NONE);
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_ACTIVATORSOUND:
+		PCODE(ACTIVATORSOUND)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL)
 			{
@@ -8916,9 +9550,9 @@ scriptwait:
 				}
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SOUNDSEQUENCE:
+		PCODE(SOUNDSEQUENCE)
 			lookup = Level->Behaviors.LookupString (STACK(1));
 			if (lookup != NULL)
 			{
@@ -8928,14 +9562,14 @@ scriptwait:
 				}
 			}
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETLINETEXTURE:
+		PCODE(SETLINETEXTURE)
 			SetLineTexture (STACK(4), STACK(3), STACK(2), STACK(1));
 			sp -= 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_REPLACETEXTURES:
+		PCODE(REPLACETEXTURES)
 		{
 			const char *fromname = Level->Behaviors.LookupString(STACK(3));
 			const char *toname = Level->Behaviors.LookupString(STACK(2));
@@ -8945,7 +9579,7 @@ scriptwait:
 			break;
 		}
 
-		case PCD_SETLINEBLOCKING:
+		PCODE(SETLINEBLOCKING)
 			{
 				int lineno;
 
@@ -8977,12 +9611,13 @@ scriptwait:
 						break;
 					}
 				}
+				P_GeometryChanged();
 
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETLINEMONSTERBLOCKING:
+		PCODE(SETLINEMONSTERBLOCKING)
 			{
 				int line;
 
@@ -8997,9 +9632,9 @@ scriptwait:
 
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETLINESPECIAL:
+		PCODE(SETLINESPECIAL)
 			{
 				int linenum = -1;
 				int specnum = STACK(6);
@@ -9025,11 +9660,12 @@ scriptwait:
 					DPrintf(DMSG_SPAMMY, "Set special on line %d (id %d) to %d(%d,%d,%d,%d,%d)\n",
 						linenum, STACK(7), specnum, arg0, STACK(4), STACK(3), STACK(2), STACK(1));
 				}
+				P_GeometryChanged();
 				sp -= 7;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETTHINGSPECIAL:
+		PCODE(SETTHINGSPECIAL)
 			{
 				int specnum = STACK(6);
 				int arg0 = STACK(5);
@@ -9067,9 +9703,9 @@ scriptwait:
 				}
 				sp -= 7;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGSOUND:
+		PCODE(THINGSOUND)
 			lookup = Level->Behaviors.LookupString (STACK(2));
 			if (lookup != NULL)
 			{
@@ -9084,14 +9720,14 @@ scriptwait:
 				}
 			}
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_FIXEDMUL:
+		PCODE(FIXEDMUL)
 			STACK(2) = MulScale(STACK(2), STACK(1), 16);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_FIXEDDIV:
+		PCODE(FIXEDDIV)
 		{
 			int a = STACK(2), b = STACK(1);
 			// Overflow check.
@@ -9100,58 +9736,58 @@ scriptwait:
 			sp--;
 			break;
 		}
-		case PCD_SETGRAVITY:
+		PCODE(SETGRAVITY)
 			Level->gravity = ACSToDouble(STACK(1));
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETGRAVITYDIRECT:
-			Level->gravity = ACSToDouble(uallong(pc[0]));
+		PCODE(SETGRAVITYDIRECT)
+			Level->gravity = ACSToDouble(pc[0]);
 			pc++;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETAIRCONTROL:
+		PCODE(SETAIRCONTROL)
 			Level->aircontrol = ACSToDouble(STACK(1));
 			sp--;
 			Level->AirControlChanged ();
-			break;
+			NEXTPCODE;
 
-		case PCD_SETAIRCONTROLDIRECT:
-			Level->aircontrol = ACSToDouble(uallong(pc[0]));
+		PCODE(SETAIRCONTROLDIRECT)
+			Level->aircontrol = ACSToDouble(pc[0]);
 			pc++;
 			Level->AirControlChanged ();
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWN:
+		PCODE(SPAWN)
 			STACK(6) = DoSpawn (STACK(6), STACK(5), STACK(4), STACK(3), STACK(2), STACK(1), false);
 			sp -= 5;
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWNDIRECT:
-			PushToStack (DoSpawn (TAGSTR(uallong(pc[0])), uallong(pc[1]), uallong(pc[2]), uallong(pc[3]), uallong(pc[4]), uallong(pc[5]), false));
+		PCODE(SPAWNDIRECT)
+			PushToStack (DoSpawn (TAGSTR(pc[0]), pc[1], pc[2], pc[3], pc[4], pc[5], false));
 			pc += 6;
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWNSPOT:
+		PCODE(SPAWNSPOT)
 			STACK(4) = DoSpawnSpot (STACK(4), STACK(3), STACK(2), STACK(1), false);
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWNSPOTDIRECT:
-			PushToStack (DoSpawnSpot (TAGSTR(uallong(pc[0])), uallong(pc[1]), uallong(pc[2]), uallong(pc[3]), false));
+		PCODE(SPAWNSPOTDIRECT)
+			PushToStack (DoSpawnSpot (TAGSTR(pc[0]), pc[1], pc[2], pc[3], false));
 			pc += 4;
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWNSPOTFACING:
+		PCODE(SPAWNSPOTFACING)
 			STACK(3) = DoSpawnSpotFacing (STACK(3), STACK(2), STACK(1), false);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_CLEARINVENTORY:
+		PCODE(CLEARINVENTORY)
 			ScriptUtil::Exec(NAME_ClearInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::End);
-			break;
+			NEXTPCODE;
 
-		case PCD_CLEARACTORINVENTORY:
+		PCODE(CLEARACTORINVENTORY)
 			if (STACK(1) == 0)
 			{
 				ScriptUtil::Exec(NAME_ClearInventory, ScriptUtil::Pointer, nullptr, ScriptUtil::End);
@@ -9166,9 +9802,9 @@ scriptwait:
 				}
 			}
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_GIVEINVENTORY:
+		PCODE(GIVEINVENTORY)
 		{
 			int typeindex = FName(Level->Behaviors.LookupString(STACK(2))).GetIndex();
 			ScriptUtil::Exec(NAME_GiveInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, STACK(1), ScriptUtil::End);
@@ -9176,7 +9812,7 @@ scriptwait:
 			break;
 		}
 
-		case PCD_GIVEACTORINVENTORY:
+		PCODE(GIVEACTORINVENTORY)
 		{
 			int typeindex = FName(Level->Behaviors.LookupString(STACK(2))).GetIndex();
 			FName type = FName(Level->Behaviors.LookupString(STACK(2)));
@@ -9197,15 +9833,15 @@ scriptwait:
 			break;
 		}
 
-		case PCD_GIVEINVENTORYDIRECT:
+		PCODE(GIVEINVENTORYDIRECT)
 		{
-			int typeindex = FName(Level->Behaviors.LookupString(TAGSTR(uallong(pc[0])))).GetIndex();
-			ScriptUtil::Exec(NAME_GiveInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, uallong(pc[1]), ScriptUtil::End);
+			int typeindex = FName(Level->Behaviors.LookupString(TAGSTR(pc[0]))).GetIndex();
+			ScriptUtil::Exec(NAME_GiveInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, pc[1], ScriptUtil::End);
 			pc += 2;
 			break;
 		}
 
-		case PCD_TAKEINVENTORY:
+		PCODE(TAKEINVENTORY)
 		{
 			int typeindex = FName(Level->Behaviors.LookupString(STACK(2))).GetIndex();
 			ScriptUtil::Exec(NAME_TakeInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, STACK(1), ScriptUtil::End);
@@ -9213,7 +9849,7 @@ scriptwait:
 			break;
 		}
 
-		case PCD_TAKEACTORINVENTORY:
+		PCODE(TAKEACTORINVENTORY)
 		{
 			int typeindex = FName(Level->Behaviors.LookupString(STACK(2))).GetIndex();
 			FName type = FName(Level->Behaviors.LookupString(STACK(2)));
@@ -9234,34 +9870,34 @@ scriptwait:
 			break;
 		}
 
-		case PCD_TAKEINVENTORYDIRECT:
+		PCODE(TAKEINVENTORYDIRECT)
 		{
-			int typeindex = FName(Level->Behaviors.LookupString(TAGSTR(uallong(pc[0])))).GetIndex();
-			ScriptUtil::Exec(NAME_TakeInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, uallong(pc[1]), ScriptUtil::End);
+			int typeindex = FName(Level->Behaviors.LookupString(TAGSTR(pc[0]))).GetIndex();
+			ScriptUtil::Exec(NAME_TakeInventory, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, typeindex, ScriptUtil::Int, pc[1], ScriptUtil::End);
 			pc += 2;
 			break;
 		}
 
-		case PCD_CHECKINVENTORY:
+		PCODE(CHECKINVENTORY)
 			STACK(1) = CheckInventory (activator, Level->Behaviors.LookupString (STACK(1)), false);
-			break;
+			NEXTPCODE;
 
-		case PCD_CHECKACTORINVENTORY:
+		PCODE(CHECKACTORINVENTORY)
 			STACK(2) = CheckInventory (Level->SingleActorFromTID(STACK(2), NULL),
 										Level->Behaviors.LookupString (STACK(1)), false);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHECKINVENTORYDIRECT:
-			PushToStack (CheckInventory (activator, Level->Behaviors.LookupString (TAGSTR(uallong(pc[0]))), false));
+		PCODE(CHECKINVENTORYDIRECT)
+			PushToStack (CheckInventory (activator, Level->Behaviors.LookupString (TAGSTR(pc[0])), false));
 			pc += 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_USEINVENTORY:
+		PCODE(USEINVENTORY)
 			STACK(1) = UseInventory (Level, activator, Level->Behaviors.LookupString (STACK(1)));
-			break;
+			NEXTPCODE;
 
-		case PCD_USEACTORINVENTORY:
+		PCODE(USEACTORINVENTORY)
 			{
 				int ret = 0;
 				const char *type = Level->Behaviors.LookupString(STACK(1));
@@ -9281,9 +9917,9 @@ scriptwait:
 				STACK(2) = ret;
 				sp--;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETSIGILPIECES:
+		PCODE(GETSIGILPIECES)
 			{
 				AActor *sigil;
 
@@ -9296,9 +9932,9 @@ scriptwait:
 					PushToStack (sigil->health);
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETAMMOCAPACITY:
+		PCODE(GETAMMOCAPACITY)
 			if (activator != NULL)
 			{
 				PClass *type = PClass::FindClass (Level->Behaviors.LookupString (STACK(1)));
@@ -9324,9 +9960,9 @@ scriptwait:
 			{
 				STACK(1) = 0;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETAMMOCAPACITY:
+		PCODE(SETAMMOCAPACITY)
 			if (activator != NULL)
 			{
 				PClassActor *type = PClass::FindActor (Level->Behaviors.LookupString (STACK(2)));
@@ -9350,46 +9986,46 @@ scriptwait:
 				}
 			}
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETMUSIC:
+		PCODE(SETMUSIC)
 			S_ChangeMusic (Level->Behaviors.LookupString (STACK(3)), STACK(2));
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETMUSICDIRECT:
-			S_ChangeMusic (Level->Behaviors.LookupString (TAGSTR(uallong(pc[0]))), uallong(pc[1]));
+		PCODE(SETMUSICDIRECT)
+			S_ChangeMusic (Level->Behaviors.LookupString (TAGSTR(pc[0])), pc[1]);
 			pc += 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_LOCALSETMUSIC:
+		PCODE(LOCALSETMUSIC)
 			if (Level->isConsolePlayer(activator))
 			{
 				S_ChangeMusic (Level->Behaviors.LookupString (STACK(3)), STACK(2));
 			}
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_LOCALSETMUSICDIRECT:
+		PCODE(LOCALSETMUSICDIRECT)
 			if (Level->isConsolePlayer(activator))
 			{
-				S_ChangeMusic (Level->Behaviors.LookupString (TAGSTR(uallong(pc[0]))), uallong(pc[1]));
+				S_ChangeMusic (Level->Behaviors.LookupString (TAGSTR(pc[0])), pc[1]);
 			}
 			pc += 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_FADETO:
+		PCODE(FADETO)
 			DoFadeTo (STACK(5), STACK(4), STACK(3), STACK(2), STACK(1));
 			sp -= 5;
-			break;
+			NEXTPCODE;
 
-		case PCD_FADERANGE:
+		PCODE(FADERANGE)
 			DoFadeRange (STACK(9), STACK(8), STACK(7), STACK(6),
 						 STACK(5), STACK(4), STACK(3), STACK(2), STACK(1));
 			sp -= 9;
-			break;
+			NEXTPCODE;
 
-		case PCD_CANCELFADE:
+		PCODE(CANCELFADE)
 			{
 				auto iterator = Level->GetThinkerIterator<DFlashFader>();
 				DFlashFader *fader;
@@ -9402,13 +10038,13 @@ scriptwait:
 					}
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYMOVIE:
+		PCODE(PLAYMOVIE)
 			STACK(1) = -1;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETACTORPOSITION:
+		PCODE(SETACTORPOSITION)
 			{
 				bool result = false;
 				AActor *actor = Level->SingleActorFromTID (STACK(5), activator);
@@ -9417,11 +10053,11 @@ scriptwait:
 				sp -= 4;
 				STACK(1) = result;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORX:
-		case PCD_GETACTORY:
-		case PCD_GETACTORZ:
+		PCODE(GETACTORX)
+		PCODE(GETACTORY)
+		PCODE(GETACTORZ)
 			{
 				AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 				if (actor == NULL)
@@ -9437,37 +10073,37 @@ scriptwait:
 					STACK(1) = DoubleToACS(pcd == PCD_GETACTORX ? actor->X() : actor->Y());
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORFLOORZ:
+		PCODE(GETACTORFLOORZ)
 			{
 				AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 				STACK(1) = actor == NULL ? 0 : DoubleToACS(actor->floorz);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORCEILINGZ:
+		PCODE(GETACTORCEILINGZ)
 			{
 				AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 				STACK(1) = actor == NULL ? 0 : DoubleToACS(actor->ceilingz);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORANGLE:
+		PCODE(GETACTORANGLE)
 			{
 				AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 				STACK(1) = actor == NULL ? 0 : AngleToACS(actor->Angles.Yaw);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORPITCH:
+		PCODE(GETACTORPITCH)
 			{
 				AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 				STACK(1) = actor == NULL ? 0 : PitchToACS(actor->Angles.Pitch);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETLINEROWOFFSET:
+		PCODE(GETLINEROWOFFSET)
 			if (activationline != NULL)
 			{
 				PushToStack (int(activationline->sidedef[0]->GetTextureYOffset(side_t::mid)));
@@ -9476,10 +10112,10 @@ scriptwait:
 			{
 				PushToStack (0);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETSECTORFLOORZ:
-		case PCD_GETSECTORCEILINGZ:
+		PCODE(GETSECTORFLOORZ)
+		PCODE(GETSECTORCEILINGZ)
 			// Arguments are (tag, x, y). If you don't use slopes, then (x, y) don't
 			// really matter and can be left as (0, 0) if you like.
 			// [Dusk] If tag = 0, then this returns the z height at whatever sector
@@ -9510,9 +10146,9 @@ scriptwait:
 				sp -= 2;
 				STACK(1) = DoubleToACS(z);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETSECTORLIGHTLEVEL:
+		PCODE(GETSECTORLIGHTLEVEL)
 			{
 				int secnum = Level->FindFirstSectorFromTag (STACK(1));
 				int z = -1;
@@ -9523,10 +10159,10 @@ scriptwait:
 				}
 				STACK(1) = z;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETFLOORTRIGGER:
-		case PCD_SETCEILINGTRIGGER:
+		PCODE(SETFLOORTRIGGER)
+		PCODE(SETCEILINGTRIGGER)
 		{
 			int secnum = Level->FindFirstSectorFromTag(STACK(8));
 			if (secnum >= 0)
@@ -9539,7 +10175,7 @@ scriptwait:
 			break;
 		}
 
-		case PCD_STARTTRANSLATION:
+		PCODE(STARTTRANSLATION)
 			{
 				int i = STACK(1);
 				sp--;
@@ -9550,9 +10186,9 @@ scriptwait:
 					transi = i - 1;
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_TRANSLATIONRANGE1:
+		PCODE(TRANSLATIONRANGE1)
 			{ // translation using palette shifting
 				int start = STACK(4);
 				int end = STACK(3);
@@ -9563,9 +10199,9 @@ scriptwait:
 				if (translation != NULL)
 					translation->AddIndexRange(start, end, pal1, pal2);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_TRANSLATIONRANGE2:
+		PCODE(TRANSLATIONRANGE2)
 			{ // translation using RGB values
 			  // (would HSV be a good idea too?)
 				int start = STACK(8);
@@ -9581,9 +10217,9 @@ scriptwait:
 				if (translation != NULL)
 					translation->AddColorRange(start, end, r1, g1, b1, r2, g2, b2);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_TRANSLATIONRANGE3:
+		PCODE(TRANSLATIONRANGE3)
 			{ // translation using desaturation
 				int start = STACK(8);
 				int end = STACK(7);
@@ -9600,9 +10236,9 @@ scriptwait:
 						ACSToDouble(r1), ACSToDouble(g1), ACSToDouble(b1),
 						ACSToDouble(r2), ACSToDouble(g2), ACSToDouble(b2));
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_TRANSLATIONRANGE4:
+		PCODE(TRANSLATIONRANGE4)
 			{ // Colourise translation
 				int start = STACK(5);
 				int end = STACK(4);
@@ -9614,9 +10250,9 @@ scriptwait:
 				if (translation != NULL)
 					translation->AddColourisation(start, end, r, g, b);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_TRANSLATIONRANGE5:
+		PCODE(TRANSLATIONRANGE5)
 			{ // Tint translation
 				int start = STACK(6);
 				int end = STACK(5);
@@ -9629,31 +10265,31 @@ scriptwait:
 				if (translation != NULL)
 					translation->AddTint(start, end, r, g, b, a);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ENDTRANSLATION:
+		PCODE(ENDTRANSLATION)
 			if (translation != NULL)
 			{
 				GPalette.UpdateTranslation(TRANSLATION(TRANSLATION_LevelScripted, transi), translation);
 				delete translation;
 				translation = NULL;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SIN:
+		PCODE(SIN)
 			STACK(1) = DoubleToACS(ACSToAngle(STACK(1)).Sin());
-			break;
+			NEXTPCODE;
 
-		case PCD_COS:
+		PCODE(COS)
 			STACK(1) = DoubleToACS(ACSToAngle(STACK(1)).Cos());
-			break;
+			NEXTPCODE;
 
-		case PCD_VECTORANGLE:
+		PCODE(VECTORANGLE)
 			STACK(2) = AngleToACS(VecToAngle(STACK(2), STACK(1)).Degrees);
 			sp--;
-			break;
+			NEXTPCODE;
 
-        case PCD_CHECKWEAPON:
+		PCODE(CHECKWEAPON)
             if (activator == NULL || activator->player == NULL || // Non-players do not have weapons
                 activator->player->ReadyWeapon == NULL)
             {
@@ -9663,38 +10299,38 @@ scriptwait:
             {
 				STACK(1) = activator->player->ReadyWeapon->GetClass()->TypeName == FName(Level->Behaviors.LookupString (STACK(1)), true);
             }
-            break;
+            NEXTPCODE;
 
-		case PCD_SETWEAPON:
+		PCODE(SETWEAPON)
 			STACK(1) = ScriptUtil::Exec(NAME_SetWeapon, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Class, GetClassForIndex(STACK(1)), ScriptUtil::End);
-			break;
+			NEXTPCODE;
 
-		case PCD_SETMARINEWEAPON:
+		PCODE(SETMARINEWEAPON)
 			ScriptUtil::Exec(NAME_SetMarineWeapon, ScriptUtil::Pointer, Level, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, STACK(2), ScriptUtil::Int, STACK(1), ScriptUtil::End);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETMARINESPRITE:
+		PCODE(SETMARINESPRITE)
 			ScriptUtil::Exec(NAME_SetMarineSprite, ScriptUtil::Pointer, Level, ScriptUtil::Pointer, activator.Get(), ScriptUtil::Int, STACK(2), ScriptUtil::Class, GetClassForIndex(STACK(1)), ScriptUtil::End);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETACTORPROPERTY:
+		PCODE(SETACTORPROPERTY)
 			SetActorProperty (STACK(3), STACK(2), STACK(1));
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORPROPERTY:
+		PCODE(GETACTORPROPERTY)
 			STACK(2) = GetActorProperty (STACK(2), STACK(1));
 			sp -= 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_GETPLAYERINPUT:
+		PCODE(GETPLAYERINPUT)
 			STACK(2) = GetPlayerInput (STACK(2), STACK(1));
 			sp -= 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERNUMBER:
+		PCODE(PLAYERNUMBER)
 			if (activator == NULL || activator->player == NULL)
 			{
 				PushToStack (-1);
@@ -9703,9 +10339,9 @@ scriptwait:
 			{
 				PushToStack (Level->PlayerNum(activator->player));
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERINGAME:
+		PCODE(PLAYERINGAME)
 			if (STACK(1) < 0 || STACK(1) >= MAXPLAYERS)
 			{
 				STACK(1) = false;
@@ -9714,9 +10350,9 @@ scriptwait:
 			{
 				STACK(1) = Level->PlayerInGame(STACK(1));
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERISBOT:
+		PCODE(PLAYERISBOT)
 			if (STACK(1) < 0 || STACK(1) >= MAXPLAYERS || !Level->PlayerInGame(STACK(1)))
 			{
 				STACK(1) = false;
@@ -9725,9 +10361,9 @@ scriptwait:
 			{
 				STACK(1) = (Level->Players[STACK(1)]->Bot != nullptr);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_ACTIVATORTID:
+		PCODE(ACTIVATORTID)
 			if (activator == NULL)
 			{
 				PushToStack (0);
@@ -9736,33 +10372,33 @@ scriptwait:
 			{
 				PushToStack (activator->tid);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETSCREENWIDTH:
+		PCODE(GETSCREENWIDTH)
 			PushToStack (SCREENWIDTH);
-			break;
+			NEXTPCODE;
 
-		case PCD_GETSCREENHEIGHT:
+		PCODE(GETSCREENHEIGHT)
 			PushToStack (SCREENHEIGHT);
-			break;
+			NEXTPCODE;
 
-		case PCD_THING_PROJECTILE2:
+		PCODE(THING_PROJECTILE2)
 			// Like Thing_Projectile(Gravity) specials, but you can give the
 			// projectile a TID.
 			// Thing_Projectile2 (tid, type, angle, speed, vspeed, gravity, newtid);
 			Level->EV_Thing_Projectile(STACK(7), activator, STACK(6), NULL, STACK(5) * (360. / 256.),
 				STACK(4) / 8., STACK(3) / 8., 0, NULL, STACK(2), STACK(1), false);
 			sp -= 7;
-			break;
+			NEXTPCODE;
 
-		case PCD_SPAWNPROJECTILE:
+		PCODE(SPAWNPROJECTILE)
 			// Same, but takes an actor name instead of a spawn ID.
 			Level->EV_Thing_Projectile(STACK(7), activator, 0, Level->Behaviors.LookupString(STACK(6)), STACK(5) * (360. / 256.),
 				STACK(4) / 8., STACK(3) / 8., 0, NULL, STACK(2), STACK(1), false);
 			sp -= 7;
-			break;
+			NEXTPCODE;
 
-		case PCD_STRLEN:
+		PCODE(STRLEN)
 			{
 				const char *str = Level->Behaviors.LookupString(STACK(1));
 				if (str != NULL)
@@ -9779,14 +10415,14 @@ scriptwait:
 				}
 				STACK(1) = 0;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETCVAR:
+		PCODE(GETCVAR)
 			// This should not use Level->PlayerNum!
 			STACK(1) = DoGetCVar(GetCVar(activator && activator->player? int(activator->player - players) : -1, Level->Behaviors.LookupString(STACK(1))), false);
-			break;
+			NEXTPCODE;
 
-		case PCD_SETHUDSIZE:
+		PCODE(SETHUDSIZE)
 			hudwidth = abs (STACK(3));
 			hudheight = abs (STACK(2));
 			if (STACK(1) != 0)
@@ -9794,9 +10430,9 @@ scriptwait:
 				hudheight = -hudheight;
 			}
 			sp -= 3;
-			break;
+			NEXTPCODE;
 
-		case PCD_GETLEVELINFO:
+		PCODE(GETLEVELINFO)
 			switch (STACK(1))
 			{
 			case LEVELINFO_PAR_TIME:		STACK(1) = Level->partime;			break;
@@ -9811,9 +10447,9 @@ scriptwait:
 			case LEVELINFO_KILLED_MONSTERS:	STACK(1) = Level->killed_monsters;	break;
 			default:						STACK(1) = 0;						break;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGESKY:
+		PCODE(CHANGESKY)
 			{
 				const char *sky1name, *sky2name;
 
@@ -9830,9 +10466,9 @@ scriptwait:
 				InitSkyMap (Level);
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETCAMERATOTEXTURE:
+		PCODE(SETCAMERATOTEXTURE)
 			{
 				const char *picname = Level->Behaviors.LookupString (STACK(2));
 				AActor *camera;
@@ -9861,19 +10497,19 @@ scriptwait:
 				}
 				sp -= 3;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SETACTORANGLE:		// [GRB]
+		PCODE(SETACTORANGLE)		// [GRB]
 			SetActorAngle(activator, STACK(2), STACK(1), false);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETACTORPITCH:
+		PCODE(SETACTORPITCH)
 			SetActorPitch(activator, STACK(2), STACK(1), false);
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_SETACTORSTATE:
+		PCODE(SETACTORSTATE)
 			{
 				const char *statename = Level->Behaviors.LookupString (STACK(2));
 				FState *state;
@@ -9913,9 +10549,9 @@ scriptwait:
 				}
 				sp -= 2;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_PLAYERCLASS:		// [GRB]
+		PCODE(PLAYERCLASS)		// [GRB]
 			if (STACK(1) < 0 || STACK(1) >= MAXPLAYERS || !Level->PlayerInGame(STACK(1)))
 			{
 				STACK(1) = -1;
@@ -9924,9 +10560,9 @@ scriptwait:
 			{
 				STACK(1) = Level->Players[STACK(1)]->CurrentPlayerClass;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_GETPLAYERINFO:		// [GRB]
+		PCODE(GETPLAYERINFO)		// [GRB]
 			if (STACK(2) < 0 || STACK(2) >= MAXPLAYERS || !Level->PlayerInGame(STACK(2)))
 			{
 				STACK(2) = -1;
@@ -9951,16 +10587,16 @@ scriptwait:
 				}
 			}
 			sp -= 1;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHANGELEVEL:
+		PCODE(CHANGELEVEL)
 			{
 				Level->ChangeLevel(Level->Behaviors.LookupString(STACK(4)), STACK(3), STACK(2), STACK(1));
 				sp -= 4;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_SECTORDAMAGE:
+		PCODE(SECTORDAMAGE)
 			{
 				int tag = STACK(5);
 				int amount = STACK(4);
@@ -9972,24 +10608,24 @@ scriptwait:
 
 				P_SectorDamage(Level, tag, amount, type, protectClass, flags);
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_THINGDAMAGE2:
+		PCODE(THINGDAMAGE2)
 			STACK(3) = Level->EV_Thing_Damage (STACK(3), activator, STACK(2), FName(Level->Behaviors.LookupString(STACK(1))));
 			sp -= 2;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHECKACTORCEILINGTEXTURE:
+		PCODE(CHECKACTORCEILINGTEXTURE)
 			STACK(2) = DoCheckActorTexture(STACK(2), activator, STACK(1), false);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHECKACTORFLOORTEXTURE:
+		PCODE(CHECKACTORFLOORTEXTURE)
 			STACK(2) = DoCheckActorTexture(STACK(2), activator, STACK(1), true);
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_GETACTORLIGHTLEVEL:
+		PCODE(GETACTORLIGHTLEVEL)
 		{
 			AActor *actor = Level->SingleActorFromTID(STACK(1), activator);
 			if (actor != NULL)
@@ -10019,15 +10655,15 @@ scriptwait:
 			break;
 		}
 
-		case PCD_SETMUGSHOTSTATE:
+		PCODE(SETMUGSHOTSTATE)
 			if (!multiplayer || (activator != nullptr && activator->CheckLocalView()))
 			{
 				StatusBar->SetMugShotState(Level->Behaviors.LookupString(STACK(1)));
 			}
 			sp--;
-			break;
+			NEXTPCODE;
 
-		case PCD_CHECKPLAYERCAMERA:
+		PCODE(CHECKPLAYERCAMERA)
 			{
 				int playernum = STACK(1);
 
@@ -10041,13 +10677,13 @@ scriptwait:
 					STACK(1) = Level->Players[playernum]->camera->tid;
 				}
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_CLASSIFYACTOR:
+		PCODE(CLASSIFYACTOR)
 			STACK(1) = DoClassifyActor(STACK(1));
-			break;
+			NEXTPCODE;
 
-		case PCD_MORPHACTOR:
+		PCODE(MORPHACTOR)
 			{
 				int tag = STACK(7);
 				FName playerclass_name = Level->Behaviors.LookupString(STACK(6));
@@ -10085,9 +10721,9 @@ scriptwait:
 				STACK(7) = changes;
 				sp -= 6;
 			}	
-			break;
+			NEXTPCODE;
 
-		case PCD_UNMORPHACTOR:
+		PCODE(UNMORPHACTOR)
 			{
 				int tag = STACK(2);
 				bool force = !!STACK(1);
@@ -10116,21 +10752,21 @@ scriptwait:
 				STACK(2) = changes;
 				sp -= 1;
 			}	
-			break;
+			NEXTPCODE;
 
-		case PCD_SAVESTRING:
+		PCODE(SAVESTRING)
 			// Saves the string
 			{
 				const int str = GlobalACSStrings.AddString(work);
 				PushToStack(str);
 				STRINGBUILDER_FINISH(work);
 			}		
-			break;
+			NEXTPCODE;
 
-		case PCD_STRCPYTOSCRIPTCHRANGE:
-		case PCD_STRCPYTOMAPCHRANGE:
-		case PCD_STRCPYTOWORLDCHRANGE:
-		case PCD_STRCPYTOGLOBALCHRANGE:
+		PCODE(STRCPYTOSCRIPTCHRANGE)
+		PCODE(STRCPYTOMAPCHRANGE)
+		PCODE(STRCPYTOWORLDCHRANGE)
+		PCODE(STRCPYTOGLOBALCHRANGE)
 			// source: stringid(2); stringoffset(1)
 			// destination: capacity (3); stringoffset(4); arrayid (5); offset(6)
 
@@ -10221,16 +10857,16 @@ scriptwait:
 				}
 				sp -= 5;
 			}
-			break;
+			NEXTPCODE;
 
-		case PCD_CONSOLECOMMAND:
-		case PCD_CONSOLECOMMANDDIRECT:
+		PCODE(CONSOLECOMMAND)
+		PCODE(CONSOLECOMMANDDIRECT)
 			Printf (TEXTCOLOR_RED GAMENAME " doesn't support execution of console commands from scripts\n");
 			if (pcd == PCD_CONSOLECOMMAND)
 				sp -= 3;
 			else
 				pc += 3;
-			break;
+			NEXTPCODE;
  		}
  	}
 
@@ -10815,6 +11451,29 @@ CCMD(acsprofile)
 	}
 }
 
+//===========================================================================
+//
+// CCMD acsbench
+//
+// Times fetching every instruction of the loaded ACS modules, once from
+// the original bytecode and once from the code decoded at load time.
+//
+//===========================================================================
+
+CCMD(acsbench)
+{
+	if (primaryLevel == nullptr) return;
+
+	int passes = argv.argc() > 1 ? MAX(1, atoi(argv[1])) : 100;
+	for (auto module : primaryLevel->Behaviors.StaticModules)
+	{
+		double rawms, decodedms;
+		bool same = module->BenchmarkFetch(passes, rawms, decodedms);
+		Printf("%s: bytecode: %.3f ms, decoded: %.3f ms per pass%s\n", module->GetModuleName(), rawms / passes, decodedms / passes,
+			same ? "" : TEXTCOLOR_RED " - results differ!");
+	}
+}
+
 ADD_STAT(ACS)
 {
 	return FStringf("ACS time: %f ms", ACSTime.TimeMS());
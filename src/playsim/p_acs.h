@@ -312,6 +312,7 @@ struct ScriptFunction
 	uint8_t ImportNum;
 	int  LocalCount;
 	uint32_t Address;
+	uint32_t CodeIndex;		// where the function starts in its module's decoded code
 	ACSLocalArrays LocalArrays;
 };
 
@@ -357,9 +358,10 @@ public:
 	uint8_t *NextChunk (uint8_t *chunk) const;
 	const ScriptPtr *FindScript (int number) const;
 	void StartTypedScripts (uint16_t type, AActor *activator, bool always, int arg1, bool runNow);
-	uint32_t PC2Ofs (int *pc) const { return (uint32_t)((uint8_t *)pc - Data); }
-	int *Ofs2PC (uint32_t ofs) const {	return (int *)(Data + ofs); }
+	uint32_t PC2Ofs (int *pc) const { return CodeOrigin[unsigned(pc - &Code[0])]; }
+	int *Ofs2PC (uint32_t ofs) const;
 	int *Jump2PC (uint32_t jumpPoint) const { return Ofs2PC(JumpPoints[jumpPoint]); }
+	int *GetFunctionAddress (const ScriptFunction *func) const { return const_cast<int *>(&Code[func->CodeIndex]); }
 	ACSFormat GetFormat() const { return Format; }
 	ScriptFunction *GetFunction (int funcnum, FBehavior *&module) const;
 	int GetArrayVal (int arraynum, int index) const;
@@ -370,7 +372,7 @@ public:
 	int FindMapVarName (const char *varname) const;
 	int FindMapArray (const char *arrayname) const;
 	int GetLibraryID () const { return LibraryID; }
-	int *GetScriptAddress (const ScriptPtr *ptr) const { return (int *)(ptr->Address + Data); }
+	int *GetScriptAddress (const ScriptPtr *ptr) const { return Ofs2PC(ptr->Address); }
 	int GetScriptIndex (const ScriptPtr *ptr) const { ptrdiff_t index = ptr - Scripts; return index >= NumScripts ? -1 : (int)index; }
 	ScriptPtr *GetScriptPtr(int index) const { return index >= 0 && index < NumScripts ? &Scripts[index] : NULL; }
 	int GetLumpNum() const { return LumpNum; }
@@ -379,6 +381,7 @@ public:
 	ACSProfileInfo *GetFunctionProfileData(int index) { return index >= 0 && index < NumFunctions ? &FunctionProfileData[index] : NULL; }
 	ACSProfileInfo *GetFunctionProfileData(ScriptFunction *func) { return GetFunctionProfileData((int)(func - (ScriptFunction *)Functions)); }
 	const char *LookupString (uint32_t index, bool forprint = false) const;
+	bool BenchmarkFetch (int passes, double &rawms, double &decodedms) const;
 
 	BoundsCheckingArray<int32_t *, NUM_MAPVARS> MapVars;
 
@@ -411,7 +414,17 @@ private:
 	char ModuleName[9];
 	TArray<int> JumpPoints;
 
+	// The bytecode is translated into Code once at load time. Every p-code and
+	// every operand takes up one native-endian word there, and jump targets
+	// are relative to the operand holding them. CodeOrigin records where in
+	// Data each word came from, so that saved PCs keep using the offsets of
+	// the original bytecode.
+	TArray<int> Code;
+	TArray<uint32_t> CodeOrigin;
+	TMap<uint32_t, uint32_t> CodeIndex;
+
 	void LoadScriptsDirectory ();
+	void DecodeCode ();
 
 	static int SortScripts (const void *a, const void *b);
 	void UnencryptStrings ();
@@ -49,12 +49,18 @@
 #include "vm.h"
 #include "actorinlines.h"
 #include "g_game.h"
+#include "parallel_for.h"
+
+#ifndef NO_SSE
+#include <emmintrin.h>
+#endif
 
 CVAR (Int, cl_rockettrails, 1, CVAR_ARCHIVE);
 CVAR (Bool, r_rail_smartspiral, 0, CVAR_ARCHIVE);
 CVAR (Int, r_rail_spiralsparsity, 1, CVAR_ARCHIVE);
 CVAR (Int, r_rail_trailsparsity, 1, CVAR_ARCHIVE);
 CVAR (Bool, r_particles, true, 0);
+CVAR (Bool, r_particles_multithread, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 EXTERN_CVAR(Int, r_maxparticles);
 
 FRandom pr_railtrail("RailTrail");
@@ -99,17 +105,102 @@ static const struct ColorList {
 	{NULL, 0, 0, 0 }
 };
 
+//==========================================================================
+//
+// Particle storage
+//
+//==========================================================================
+
+void FParticles::Resize(uint32_t capacity)
+{
+	for (auto arr : { &PosX, &PosY, &PosZ, &VelX, &VelY, &VelZ, &AccX, &AccY, &AccZ, &Size, &SizeStep, &Alpha, &FadeStep })
+	{
+		arr->Resize(capacity);
+	}
+	TTL.Resize(capacity);
+	Color.Resize(capacity);
+	Bright.Resize(capacity);
+	NoTimeFreeze.Resize(capacity);
+	Subsector.Resize(capacity);
+	SNext.Resize(capacity);
+	Capacity = capacity;
+	Clear();
+}
+
+void FParticles::Clear()
+{
+	Count = 0;
+	Binned = false;
+	HasPending = false;
+}
+
+void FParticles::Flush()
+{
+	if (!HasPending) return;
+	HasPending = false;
+
+	const particle_t &p = Pending;
+	uint32_t i = Count++;
+	PosX[i] = float(p.Pos.X);
+	PosY[i] = float(p.Pos.Y);
+	PosZ[i] = float(p.Pos.Z);
+	VelX[i] = float(p.Vel.X);
+	VelY[i] = float(p.Vel.Y);
+	VelZ[i] = float(p.Vel.Z);
+	AccX[i] = float(p.Acc.X);
+	AccY[i] = float(p.Acc.Y);
+	AccZ[i] = float(p.Acc.Z);
+	Size[i] = float(p.size);
+	SizeStep[i] = float(p.sizestep);
+	Alpha[i] = p.alpha;
+	FadeStep[i] = p.fadestep;
+	TTL[i] = p.ttl;
+	Color[i] = p.color;
+	Bright[i] = p.bright;
+	NoTimeFreeze[i] = p.notimefreeze;
+	Subsector[i] = p.subsector;
+	Binned = false;
+}
+
+void FParticles::Remove(uint32_t index)
+{
+	uint32_t last = --Count;
+	if (index != last)
+	{
+		PosX[index] = PosX[last];
+		PosY[index] = PosY[last];
+		PosZ[index] = PosZ[last];
+		VelX[index] = VelX[last];
+		VelY[index] = VelY[last];
+		VelZ[index] = VelZ[last];
+		AccX[index] = AccX[last];
+		AccY[index] = AccY[last];
+		AccZ[index] = AccZ[last];
+		Size[index] = Size[last];
+		SizeStep[index] = SizeStep[last];
+		Alpha[index] = Alpha[last];
+		FadeStep[index] = FadeStep[last];
+		TTL[index] = TTL[last];
+		Color[index] = Color[last];
+		Bright[index] = Bright[last];
+		NoTimeFreeze[index] = NoTimeFreeze[last];
+		Subsector[index] = Subsector[last];
+	}
+	Binned = false;
+}
+
+// The returned particle stays valid until the next call.
 inline particle_t *NewParticle (FLevelLocals *Level)
 {
-	particle_t *result = nullptr;
-	if (Level->InactiveParticles != NO_PARTICLE)
+	auto &particles = Level->Particles;
+	particles.Flush();
+	if (particles.Count >= particles.Capacity)
 	{
-		result = &Level->Particles[Level->InactiveParticles];
-		Level->InactiveParticles = result->tnext;
-		result->tnext = Level->ActiveParticles;
-		Level->ActiveParticles = uint32_t(result - Level->Particles.Data());
+		return nullptr;
 	}
-	return result;
+	memset (&particles.Pending, 0, sizeof(particle_t));
+	particles.HasPending = true;
+	return &particles.Pending;
 }
 
 //
@@ -129,48 +220,51 @@ void P_InitParticles (FLevelLocals *Level)
 		num = r_maxparticles;
 
 	// This should be good, but eh...
-	int NumParticles = clamp<int>(num, 100, 65535);
+	int NumParticles = clamp<int>(num, 100, MAX_PARTICLES);
 
 	Level->Particles.Resize(NumParticles);
-	P_ClearParticles (Level);
 }
 
 void P_ClearParticles (FLevelLocals *Level)
 {
-	int i = 0;
-	memset (Level->Particles.Data(), 0, Level->Particles.Size() * sizeof(particle_t));
-	Level->ActiveParticles = NO_PARTICLE;
-	Level->InactiveParticles = 0;
-	for (auto &p : Level->Particles)
-		p.tnext = ++i;
-	Level->Particles.Last().tnext = NO_PARTICLE;
+	Level->Particles.Clear();
 }
 
-// Group particles by subsectors. Because particles are always
-// in motion, there is little benefit to caching this information
-// from one frame to the next.
+// Group particles by subsectors. The particles only move when they think,
+// so this only needs to be redone after a tic or when some got added.
 
 void P_FindParticleSubsectors (FLevelLocals *Level)
 {
+	auto &particles = Level->Particles;
+	particles.Flush();
+
 	if (Level->ParticlesInSubsec.Size() < Level->subsectors.Size())
 	{
 		Level->ParticlesInSubsec.Reserve (Level->subsectors.Size() - Level->ParticlesInSubsec.Size());
+		particles.Binned = false;
 	}
 
-	fillshort (&Level->ParticlesInSubsec[0], Level->subsectors.Size(), NO_PARTICLE);
-
 	if (!r_particles)
 	{
+		memset (Level->ParticlesInSubsec.Data(), 0xff, Level->subsectors.Size() * sizeof(uint32_t));
+		particles.Binned = false;
 		return;
 	}
-	for (uint16_t i = Level->ActiveParticles; i != NO_PARTICLE; i = Level->Particles[i].tnext)
+	if (particles.Binned)
+	{
+		return;
+	}
+
+	memset (Level->ParticlesInSubsec.Data(), 0xff, Level->subsectors.Size() * sizeof(uint32_t));
+	for (uint32_t i = 0; i < particles.Count; i++)
 	{
 		 // Try to reuse the subsector from the last portal check, if still valid.
-		if (Level->Particles[i].subsector == nullptr) Level->Particles[i].subsector = Level->PointInRenderSubsector(Level->Particles[i].Pos);
-		int ssnum = Level->Particles[i].subsector->Index();
-		Level->Particles[i].snext = Level->ParticlesInSubsec[ssnum];
+		if (particles.Subsector[i] == nullptr) particles.Subsector[i] = Level->PointInRenderSubsector(DVector2(particles.PosX[i], particles.PosY[i]));
+		int ssnum = particles.Subsector[i]->Index();
+		particles.SNext[i] = Level->ParticlesInSubsec[ssnum];
 		Level->ParticlesInSubsec[ssnum] = i;
 	}
+	particles.Binned = true;
 }
 
 static TMap<int, int> ColorSaver;
@@ -210,65 +304,251 @@ void P_InitEffects ()
 	blood2 = ParticleColor(RPART(kind)/3, GPART(kind)/3, BPART(kind)/3);
 }
 
-void P_ThinkParticles (FLevelLocals *Level)
+cycle_t ParticleCycles;
+
+// The particles get updated in chunks of this size, which are processed
+// in parallel if there are enough of them.
+enum { PARTICLE_CHUNK = 4096 };
+
+struct FParticleMove
 {
-	int i;
-	particle_t *particle, *prev;
+	uint32_t Index;
+	float X, Y;
+	float VelX, VelY;
+};
+
+struct FParticleChunk
+{
+	TArray<uint32_t> Expired;
+	TArray<FParticleMove> PortalMoves;
+};
+
+static TArray<FParticleChunk> ParticleChunks;
+
+//==========================================================================
+//
+// The line portal traverser cannot be used by several threads at once so
+// particles that might cross a line portal get moved after the update.
+// This is the early-out test of GetPortalOffsetPosition.
+//
+//==========================================================================
+
+static bool MayCrossLinePortal(FLevelLocals *Level, double x, double y, double dx, double dy)
+{
+	if (dx < 128 && dy < 128)
+	{
+		auto &pbm = Level->PortalBlockmap;
+		int blockx = Level->blockmap.GetBlockX(x);
+		int blocky = Level->blockmap.GetBlockY(y);
+		if (blockx < 0 || blocky < 0 || blockx >= pbm.dx || blocky >= pbm.dy || !pbm(blockx, blocky).neighborContainsLines) return false;
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// Finds the subsector of a particle that has moved.
+//
+//==========================================================================
 
-	i = Level->ActiveParticles;
-	prev = NULL;
-	while (i != NO_PARTICLE)
+static void LinkParticle(FLevelLocals *Level, FParticles &particles, uint32_t i)
+{
+	DVector3 pos = particles.Pos(i);
+	subsector_t *subsector = Level->PointInRenderSubsector(pos);
+	sector_t *s = subsector->sector;
+	// Handle crossing a sector portal.
+	if (!s->PortalBlocksMovement(sector_t::ceiling))
 	{
-		particle = &Level->Particles[i];
-		i = particle->tnext;
-		if (!particle->notimefreeze && Level->isFrozen())
+		if (pos.Z > s->GetPortalPlaneZ(sector_t::ceiling))
 		{
-			prev = particle;
-			continue;
+			pos += s->GetPortalDisplacement(sector_t::ceiling);
+			subsector = nullptr;
 		}
-		
-		auto oldtrans = particle->alpha;
-		particle->alpha -= particle->fadestep;
-		particle->size += particle->sizestep;
-		if (particle->alpha <= 0 || oldtrans < particle->alpha || --particle->ttl <= 0 || (particle->size <= 0))
-		{ // The particle has expired, so free it
-			memset (particle, 0, sizeof(particle_t));
-			if (prev)
-				prev->tnext = i;
-			else
-				Level->ActiveParticles = i;
-			particle->tnext = Level->InactiveParticles;
-			Level->InactiveParticles = (int)(particle - Level->Particles.Data());
-			continue;
+	}
+	else if (!s->PortalBlocksMovement(sector_t::floor))
+	{
+		if (pos.Z < s->GetPortalPlaneZ(sector_t::floor))
+		{
+			pos += s->GetPortalDisplacement(sector_t::floor);
+			subsector = nullptr;
 		}
+	}
+	if (subsector == nullptr)
+	{
+		particles.PosX[i] = float(pos.X);
+		particles.PosY[i] = float(pos.Y);
+	}
+	particles.Subsector[i] = subsector;
+}
+
+//==========================================================================
+//
+// Updates the particles first to last-1. This only touches these
+// particles and the chunk, so several ranges can be done at once.
+//
+//==========================================================================
 
-		// Handle crossing a line portal
-		DVector2 newxy = Level->GetPortalOffsetPosition(particle->Pos.X, particle->Pos.Y, particle->Vel.X, particle->Vel.Y);
-		particle->Pos.X = newxy.X;
-		particle->Pos.Y = newxy.Y;
-		particle->Pos.Z += particle->Vel.Z;
-		particle->Vel += particle->Acc;
-		particle->subsector = Level->PointInRenderSubsector(particle->Pos);
-		sector_t *s = particle->subsector->sector;
-		// Handle crossing a sector portal.
-		if (!s->PortalBlocksMovement(sector_t::ceiling))
+static void ThinkParticles(FLevelLocals *Level, uint32_t first, uint32_t last, FParticleChunk &chunk)
+{
+	auto &p = Level->Particles;
+	const bool frozen = Level->isFrozen();
+
+	chunk.Expired.Clear();
+	chunk.PortalMoves.Clear();
+
+	if (Level->PortalBlockmap.containsLines)
+	{
+		for (uint32_t i = first; i < last; i++)
 		{
-			if (particle->Pos.Z > s->GetPortalPlaneZ(sector_t::ceiling))
+			if ((!frozen || p.NoTimeFreeze[i]) && MayCrossLinePortal(Level, p.PosX[i], p.PosY[i], p.VelX[i], p.VelY[i]))
 			{
-				particle->Pos += s->GetPortalDisplacement(sector_t::ceiling);
-				particle->subsector = NULL;
+				chunk.PortalMoves.Push({ i, p.PosX[i], p.PosY[i], p.VelX[i], p.VelY[i] });
 			}
 		}
-		else if (!s->PortalBlocksMovement(sector_t::floor))
+	}
+
+	uint32_t i = first;
+#ifndef NO_SSE
+	if (!frozen)
+	{
+		float *pos[3] = { p.PosX.Data(), p.PosY.Data(), p.PosZ.Data() };
+		float *vel[3] = { p.VelX.Data(), p.VelY.Data(), p.VelZ.Data() };
+		const float *acc[3] = { p.AccX.Data(), p.AccY.Data(), p.AccZ.Data() };
+		const __m128 zero = _mm_setzero_ps();
+		const __m128i one = _mm_set1_epi32(1);
+
+		for (; i + 4 <= last; i += 4)
 		{
-			if (particle->Pos.Z < s->GetPortalPlaneZ(sector_t::floor))
+			__m128 alpha = _mm_loadu_ps(&p.Alpha[i]);
+			__m128 newalpha = _mm_sub_ps(alpha, _mm_loadu_ps(&p.FadeStep[i]));
+			__m128 size = _mm_add_ps(_mm_loadu_ps(&p.Size[i]), _mm_loadu_ps(&p.SizeStep[i]));
+			__m128i ttl = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)&p.TTL[i]), one);
+			__m128 expired = _mm_or_ps(
+				_mm_or_ps(_mm_cmple_ps(newalpha, zero), _mm_cmplt_ps(alpha, newalpha)),
+				_mm_or_ps(_mm_castsi128_ps(_mm_cmplt_epi32(ttl, one)), _mm_cmple_ps(size, zero)));
+			ttl = _mm_andnot_si128(_mm_castps_si128(expired), ttl);
+			_mm_storeu_ps(&p.Alpha[i], newalpha);
+			_mm_storeu_ps(&p.Size[i], size);
+			_mm_storeu_si128((__m128i *)&p.TTL[i], ttl);
+
+			for (int j = 0; j < 3; j++)
 			{
-				particle->Pos += s->GetPortalDisplacement(sector_t::floor);
-				particle->subsector = NULL;
+				__m128 v = _mm_loadu_ps(vel[j] + i);
+				_mm_storeu_ps(pos[j] + i, _mm_add_ps(_mm_loadu_ps(pos[j] + i), v));
+				_mm_storeu_ps(vel[j] + i, _mm_add_ps(v, _mm_loadu_ps(acc[j] + i)));
 			}
+
+			int mask = _mm_movemask_ps(expired);
+			if (mask != 0)
+			{
+				for (int j = 0; j < 4; j++)
+				{
+					if (mask & (1 << j)) chunk.Expired.Push(i + j);
+				}
+			}
+		}
+	}
+#endif
+	for (; i < last; i++)
+	{
+		if (frozen && !p.NoTimeFreeze[i])
+		{
+			continue;
+		}
+
+		float oldtrans = p.Alpha[i];
+		p.Alpha[i] -= p.FadeStep[i];
+		p.Size[i] += p.SizeStep[i];
+		if (p.Alpha[i] <= 0 || oldtrans < p.Alpha[i] || --p.TTL[i] <= 0 || p.Size[i] <= 0)
+		{ // The particle has expired
+			p.TTL[i] = 0;
+			chunk.Expired.Push(i);
+			continue;
+		}
+		p.PosX[i] += p.VelX[i];
+		p.PosY[i] += p.VelY[i];
+		p.PosZ[i] += p.VelZ[i];
+		p.VelX[i] += p.AccX[i];
+		p.VelY[i] += p.AccY[i];
+		p.VelZ[i] += p.AccZ[i];
+	}
+
+	// Find the new subsectors. The particles that may have crossed a line
+	// portal are done later.
+	unsigned move = 0;
+	for (i = first; i < last; i++)
+	{
+		if (move < chunk.PortalMoves.Size() && chunk.PortalMoves[move].Index == i)
+		{
+			move++;
+			continue;
+		}
+		if (p.TTL[i] > 0 && (!frozen || p.NoTimeFreeze[i]))
+		{
+			LinkParticle(Level, p, i);
+		}
+	}
+}
+
+void P_ThinkParticles (FLevelLocals *Level)
+{
+	auto &particles = Level->Particles;
+
+	ParticleCycles.Clock();
+	particles.Flush();
+
+	const uint32_t count = particles.Count;
+	const uint32_t numchunks = (count + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK;
+	if (ParticleChunks.Size() < numchunks)
+	{
+		ParticleChunks.Resize(numchunks);
+	}
+
+	if (r_particles_multithread && numchunks > 1)
+	{
+		parallel_for(int(count), int(PARTICLE_CHUNK), [=](int first)
+		{
+			if (uint32_t(first) < count)
+			{
+				ThinkParticles(Level, first, MIN<uint32_t>(first + PARTICLE_CHUNK, count), ParticleChunks[first / PARTICLE_CHUNK]);
+			}
+		});
+	}
+	else
+	{
+		for (uint32_t first = 0; first < count; first += PARTICLE_CHUNK)
+		{
+			ThinkParticles(Level, first, MIN<uint32_t>(first + PARTICLE_CHUNK, count), ParticleChunks[first / PARTICLE_CHUNK]);
+		}
+	}
+
+	// Handle crossing a line portal
+	for (uint32_t c = 0; c < numchunks; c++)
+	{
+		for (auto &move : ParticleChunks[c].PortalMoves)
+		{
+			uint32_t i = move.Index;
+			if (particles.TTL[i] <= 0) continue;
+
+			DVector2 newxy = Level->GetPortalOffsetPosition(move.X, move.Y, move.VelX, move.VelY);
+			particles.PosX[i] = float(newxy.X);
+			particles.PosY[i] = float(newxy.Y);
+			LinkParticle(Level, particles, i);
+		}
+	}
+
+	// Free the expired particles, back to front so that the ones that get
+	// moved into their place are still alive.
+	for (uint32_t c = numchunks; c-- > 0; )
+	{
+		auto &expired = ParticleChunks[c].Expired;
+		for (uint32_t j = expired.Size(); j-- > 0; )
+		{
+			particles.Remove(expired[j]);
 		}
-		prev = particle;
 	}
+	particles.Binned = false;
+	ParticleCycles.Unclock();
 }
 
 enum PSFlag
@@ -46,6 +46,7 @@ struct FLevelLocals;
 
 // [RH] Particle details
 
+// The record the effect code fills in when it creates a particle.
 struct particle_t
 {
 	DVector3 Pos;
@@ -60,11 +61,53 @@ struct particle_t
 	float	fadestep;
 	float	alpha;
 	int		color;
-	uint16_t	tnext;
-	uint16_t	snext;
 };
 
-const uint16_t NO_PARTICLE = 0xffff;
+const uint32_t NO_PARTICLE = 0xffffffff;
+const int MAX_PARTICLES = 1 << 20;
+
+// The particles of a level, stored as a structure of arrays so that
+// P_ThinkParticles can update several of them at once. The live particles
+// always occupy the first Count entries; an expired one gets replaced by
+// the last one.
+struct FParticles
+{
+	TArray<float> PosX, PosY, PosZ;
+	TArray<float> VelX, VelY, VelZ;
+	TArray<float> AccX, AccY, AccZ;
+	TArray<float> Size, SizeStep;
+	TArray<float> Alpha, FadeStep;
+	TArray<int32_t> TTL;
+	TArray<int> Color;
+	TArray<uint8_t> Bright;
+	TArray<uint8_t> NoTimeFreeze;
+	TArray<subsector_t *> Subsector;
+	TArray<uint32_t> SNext;			// next particle in the same subsector
+
+	uint32_t Count = 0;
+	uint32_t Capacity = 0;
+	bool Binned = false;			// ParticlesInSubsec is up to date
+
+	// The particle that was last handed out to the effect code. It only gets
+	// added when the next one is requested or the particles are used.
+	particle_t Pending;
+	bool HasPending = false;
+
+	void Resize(uint32_t capacity);
+	void Clear();
+	void Flush();
+	void Remove(uint32_t index);
+
+	DVector3 Pos(uint32_t index) const
+	{
+		return DVector3(PosX[index], PosY[index], PosZ[index]);
+	}
+
+	DVector3 Vel(uint32_t index) const
+	{
+		return DVector3(VelX[index], VelY[index], VelZ[index]);
+	}
+};
 
 void P_InitParticles(FLevelLocals *);
 void P_ClearParticles (FLevelLocals *Level);
@@ -3954,7 +3954,9 @@ int P_ExecuteSpecial(FLevelLocals *Level, int			num,
 {
 	if (num >= 0 && num < (int)countof(LineSpecials))
 	{
-		return LineSpecials[num](Level, line, activator, backSide, arg1, arg2, arg3, arg4, arg5);
+		int res = LineSpecials[num](Level, line, activator, backSide, arg1, arg2, arg3, arg4, arg5);
+		P_GeometryChanged();	// specials may change anything that blocks sight
+		return res;
 	}
 	return 0;
 }
@@ -277,7 +277,19 @@ enum ESightFlags
 	SF_IGNOREWATERBOUNDARY=8
 };
 
+struct FSightQuery
+{
+	AActor *t1;
+	AActor *t2;
+	int flags;
+	int result;			// filled in by P_CheckSightBatch
+};
+
+void	P_CheckSightBatch (FSightQuery *queries, unsigned count);
+void	P_PrefetchLookSight (FLevelLocals *Level);
 void	P_ResetSightCounters (bool full);
+void	P_GeometryChanged ();	// call after changing anything that can block sight
+void	P_SuspendSightCache ();
 bool	P_TalkFacing (AActor *player);
 void	P_UseLines (player_t* player);
 int	P_UsePuzzleItem (AActor *actor, int itemType);
@@ -2179,7 +2179,7 @@ static void CheckForPushSpecial(line_t *line, int side, AActor *mobj, DVector2 *
 //
 //==========================================================================
 
-bool P_TryMove(AActor *thing, const DVector2 &pos,
+static bool P_DoTryMove(AActor *thing, const DVector2 &pos,
 	int dropoff, // killough 3/15/98: allow dropoff as option
 	const secplane_t *onfloor, // [RH] Let P_TryMove keep the thing on the floor
 	FCheckPosition &tm,
@@ -2686,6 +2686,28 @@ pushline:
 	return false;
 }
 
+//==========================================================================
+//
+// P_TryMove is reentrant through line specials so only the outermost call
+// gets clocked.
+//
+//==========================================================================
+
+cycle_t TryMoveCycles;
+static int TryMoveDepth;
+
+bool P_TryMove(AActor *thing, const DVector2 &pos,
+	int dropoff, // killough 3/15/98: allow dropoff as option
+	const secplane_t *onfloor, // [RH] Let P_TryMove keep the thing on the floor
+	FCheckPosition &tm,
+	bool missileCheck)	// [GZ] Fired missiles ignore the drop-off test
+{
+	if (TryMoveDepth++ == 0) TryMoveCycles.Clock();
+	bool res = P_DoTryMove(thing, pos, dropoff, onfloor, tm, missileCheck);
+	if (--TryMoveDepth == 0) TryMoveCycles.Unclock();
+	return res;
+}
+
 bool P_TryMove(AActor *thing, const DVector2 &pos,
 	int dropoff, // killough 3/15/98: allow dropoff as option
 	const secplane_t *onfloor, bool missilecheck) // [RH] Let P_TryMove keep the thing on the floor
@@ -79,6 +79,8 @@
 // State.
 #include "po_man.h"
 #include "vm.h"
+#include "c_dispatch.h"
+#include "stats.h"
 
 int P_VanillaPointOnDivlineSide(double x, double y, const divline_t* line);
 
@@ -340,6 +342,7 @@ void AActor::UnlinkFromWorld (FLinkContext *ctx)
 				block->NextActor->PrevActor = block->PrevActor;
 			}
 			*(block->PrevActor) = block->NextActor;
+			Level->blockmap.UnlinkThing(block);
 			FBlockNode *next = block->NextBlock;
 			block->Release ();
 			block = next;
@@ -551,10 +554,16 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 						node->NextBlock = NULL;
 						(*alink) = node;
 						alink = &node->NextBlock;
+
+						Level->blockmap.LinkThing(node);
 					}
 				}
 			}
 		}
+		if (BlockNode != nullptr && BlockNode->NextBlock == nullptr)
+		{
+			Level->blockmap.SetSingleBlock(BlockNode);
+		}
 	}
 	// Portal links cannot be done unless the level is fully initialized.
 	if (!spawningmapthing) UpdateRenderSectorList();
@@ -709,6 +718,137 @@ line_t *FBlockLinesIterator::Next()
 	}
 }
 
+//===========================================================================
+//
+// CCMD blockmapbench
+//
+// Runs a P_CheckPosition style block query around every actor in the
+// level, once through FBlockThingsIterator and once by walking the
+// FBlockNode chains, and verifies that both return the same actors in
+// the same order. The chain walk filters duplicates with the same hash
+// FBlockThingsIterator uses, so only the traversal differs.
+//
+//===========================================================================
+
+struct FBenchThingsHash
+{
+	struct HashEntry
+	{
+		AActor *Actor;
+		int Next;
+	};
+	int Buckets[32];
+	HashEntry FixedHash[10];
+	int NumFixedHash;
+	TArray<HashEntry> DynHash;
+
+	void Clear()
+	{
+		memset(Buckets, -1, sizeof(Buckets));
+		NumFixedHash = 0;
+		DynHash.Clear();
+	}
+
+	HashEntry *GetHashEntry(int i) { return i < (int)countof(FixedHash) ? &FixedHash[i] : &DynHash[i - countof(FixedHash)]; }
+
+	// Returns false if the actor was already added.
+	bool Add(AActor *me)
+	{
+		HashEntry *entry;
+		size_t hash = ((size_t)me >> 3) % countof(Buckets);
+		for (int i = Buckets[hash]; i >= 0; i = entry->Next)
+		{
+			entry = GetHashEntry(i);
+			if (entry->Actor == me) return false;
+		}
+		if (NumFixedHash < (int)countof(FixedHash))
+		{
+			entry = &FixedHash[NumFixedHash];
+			entry->Next = Buckets[hash];
+			Buckets[hash] = NumFixedHash++;
+		}
+		else
+		{
+			if (DynHash.Size() == 0)
+			{
+				DynHash.Grow(50);
+			}
+			int i = DynHash.Reserve(1);
+			entry = &DynHash[i];
+			entry->Next = Buckets[hash];
+			Buckets[hash] = i + countof(FixedHash);
+		}
+		entry->Actor = me;
+		return true;
+	}
+};
+
+CCMD(blockmapbench)
+{
+	if (primaryLevel == nullptr || primaryLevel->blockmap.blockthings == nullptr) return;
+
+	auto Level = primaryLevel;
+	int passes = argv.argc() > 1 ? MAX(1, atoi(argv[1])) : 10;
+	TArray<AActor *> actors, iterated, chained;
+	FBenchThingsHash hash;
+	cycle_t itertime, chaintime;
+
+	auto it = Level->GetThinkerIterator<AActor>();
+	AActor *ac;
+	while ((ac = it.Next()))
+	{
+		if (!(ac->flags & MF_NOBLOCKMAP)) actors.Push(ac);
+	}
+
+	itertime.Reset();
+	chaintime.Reset();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		iterated.Clear();
+		chained.Clear();
+
+		itertime.Clock();
+		for (auto actor : actors)
+		{
+			FBoundingBox box(actor->X(), actor->Y(), actor->radius + 64);
+			FBlockThingsIterator bit(Level, box);
+			AActor *thing;
+			while ((thing = bit.Next())) iterated.Push(thing);
+		}
+		itertime.Unclock();
+
+		chaintime.Clock();
+		for (auto actor : actors)
+		{
+			FBoundingBox box(actor->X(), actor->Y(), actor->radius + 64);
+			int miny = Level->blockmap.GetBlockY(box.Bottom()), maxy = Level->blockmap.GetBlockY(box.Top());
+			int minx = Level->blockmap.GetBlockX(box.Left()), maxx = Level->blockmap.GetBlockX(box.Right());
+			hash.Clear();
+			for (int y = miny; y <= maxy; y++)
+			{
+				for (int x = minx; x <= maxx; x++)
+				{
+					if (!Level->blockmap.isValidBlock(x, y)) continue;
+					for (auto block = Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x]; block != nullptr; block = block->NextActor)
+					{
+						AActor *me = block->Me;
+						if ((block->NextBlock == nullptr && block->PrevBlock == &me->BlockNode) || hash.Add(me))
+						{
+							chained.Push(me);
+						}
+					}
+				}
+			}
+		}
+		chaintime.Unclock();
+	}
+
+	bool same = iterated.Size() == chained.Size() && !memcmp(iterated.Data(), chained.Data(), iterated.Size() * sizeof(AActor*));
+	Printf("%u actors, %u results per pass\n", actors.Size(), iterated.Size());
+	Printf("Block arrays: %.3f ms, block node chains: %.3f ms per pass%s\n", itertime.TimeMS() / passes, chaintime.TimeMS() / passes,
+		same ? "" : TEXTCOLOR_RED " - results differ!");
+}
+
 //===========================================================================
 //
 // FMultiBlockLinesIterator :: FMultiBlockLinesIterator
@@ -888,18 +1028,38 @@ void FMultiBlockLinesIterator::Reset()
 //
 //===========================================================================
 
+FBlockThingsIterator::FThingLock::FThingLock(FLevelLocals *l)
+	: Level(l)
+{
+	Level->blockmap.thinglocks++;
+}
+
+FBlockThingsIterator::FThingLock &FBlockThingsIterator::FThingLock::operator=(const FThingLock &other)
+{
+	other.Level->blockmap.thinglocks++;
+	Level->blockmap.thinglocks--;
+	Level = other.Level;
+	return *this;
+}
+
+FBlockThingsIterator::FThingLock::~FThingLock()
+{
+	Level->blockmap.thinglocks--;
+}
+
 FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *l)
-: DynHash(0)
+: Lock(l), DynHash(0)
 {
 	Level = l;
 	minx = maxx = 0;
 	miny = maxy = 0;
 	ClearHash();
 	block = NULL;
+	blockindex = 0;
 }
 
 FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *l, int _minx, int _miny, int _maxx, int _maxy)
-: DynHash(0)
+: Lock(l), DynHash(0)
 {
 	Level = l;
 	minx = _minx;
@@ -945,12 +1105,14 @@ void FBlockThingsIterator::StartBlock(int x, int y)
 	cury = y;
 	if (Level->blockmap.isValidBlock(x, y))
 	{
-		block = Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
+		block = &Level->blockmap.blockthings[y*Level->blockmap.bmapwidth + x];
+		blockindex = block->Actors.Size();
 	}
 	else
 	{
 		// invalid block
 		block = NULL;
+		blockindex = 0;
 	}
 }
 
@@ -977,16 +1139,22 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 {
 	for (;;)
 	{
-		while (block != NULL)
+		// The arrays are walked backwards to get the same order as the block's FBlockNode chain.
+		// Actors that get linked while iterating are appended and therefore skipped, just like
+		// they'd be inserted before the current position in the chain.
+		while (blockindex > 0)
 		{
-			AActor *me = block->Me;
-			FBlockNode *mynode = block;
+			int index = --blockindex;
+			AActor *me = block->Actors[index];
 			HashEntry *entry;
 			int i;
 
-			block = block->NextActor;
+			if (me == nullptr)
+			{ // unlinked
+				continue;
+			}
 			// Don't recheck things that were already checked
-			if (mynode->NextBlock == NULL && mynode->PrevBlock == &me->BlockNode)
+			if (block->SingleBlock[index])
 			{ // This actor doesn't span blocks, so we know it can only ever be checked once.
 				return me;
 			}
@@ -10,6 +10,7 @@
 
 extern int validcount;
 struct FBlockNode;
+struct FBlockThings;
 
 struct divline_t
 {
@@ -280,13 +281,25 @@ public:
 
 class FBlockThingsIterator
 {
+	// Keeps UnlinkThing from compacting the block arrays while the iterator exists.
+	struct FThingLock
+	{
+		FLevelLocals *Level;
+		FThingLock(FLevelLocals *l);
+		FThingLock(const FThingLock &other) : FThingLock(other.Level) {}
+		FThingLock &operator=(const FThingLock &other);
+		~FThingLock();
+	};
+
 	FLevelLocals *Level;
+	FThingLock Lock;
 	int minx, maxx;
 	int miny, maxy;
 
 	int curx, cury;
 
-	FBlockNode *block;
+	FBlockThings *block;
+	int blockindex;
 
 	int Buckets[32];
 
@@ -315,6 +328,7 @@ class FBlockThingsIterator
 public:
 	FBlockThingsIterator(FLevelLocals *Level, int minx, int miny, int maxx, int maxy);
 	FBlockThingsIterator(FLevelLocals *l, const FBoundingBox &box)
+		: Lock(l)
 	{
 		Level = l;
 		init(box);
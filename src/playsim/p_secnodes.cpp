@@ -480,3 +480,113 @@ void FBlockNode::Release()
 	NextBlock = FreeBlocks;
 	FreeBlocks = this;
 }
+
+//===========================================================================
+//
+// FBlockmap :: LinkThing
+//
+// Mirrors a newly linked block node in the block's thing arrays.
+//
+//===========================================================================
+
+void FBlockmap::LinkThing(FBlockNode *node)
+{
+	auto &block = blockthings[node->BlockIndex];
+	node->ThingIndex = block.Actors.Push(node->Me);
+	block.SingleBlock.Push(false);
+	block.Nodes.Push(node);
+}
+
+//===========================================================================
+//
+// FBlockmap :: UnlinkThing
+//
+// Only clears the entry so that running iterators are not affected.
+// Blocks that collect many holes while the game is paused or frozen
+// would otherwise have to wait for the next tic to get compacted.
+//
+//===========================================================================
+
+void FBlockmap::UnlinkThing(FBlockNode *node)
+{
+	auto &block = blockthings[node->BlockIndex];
+	block.Actors[node->ThingIndex] = nullptr;
+	block.NumHoles++;
+	if (thinglocks == 0 && block.NumHoles >= 16 && block.NumHoles * 2 >= (int)block.Actors.Size())
+	{
+		CompactBlock(block);
+	}
+	else if (!block.Dirty)
+	{
+		block.Dirty = true;
+		dirtythings.Push(node->BlockIndex);
+	}
+}
+
+//===========================================================================
+//
+// FBlockmap :: RestoreThing
+//
+// Undoes UnlinkThing for a node that was not released. Used by player
+// prediction which needs to restore the original blockmap order.
+//
+//===========================================================================
+
+void FBlockmap::RestoreThing(FBlockNode *node)
+{
+	auto &block = blockthings[node->BlockIndex];
+	assert(block.Nodes[node->ThingIndex] == node && block.Actors[node->ThingIndex] == nullptr);
+	block.Actors[node->ThingIndex] = node->Me;
+	block.NumHoles--;
+}
+
+//===========================================================================
+//
+// FBlockmap :: SetSingleBlock
+//
+//===========================================================================
+
+void FBlockmap::SetSingleBlock(FBlockNode *node)
+{
+	blockthings[node->BlockIndex].SingleBlock[node->ThingIndex] = true;
+}
+
+//===========================================================================
+//
+// FBlockmap :: CompactThings
+//
+// Removes the holes left by UnlinkThing. This may only be called when
+// no FBlockThingsIterator is active, i.e. between tics.
+//
+//===========================================================================
+
+void FBlockmap::CompactThings()
+{
+	for (int index : dirtythings)
+	{
+		auto &block = blockthings[index];
+		if (block.Dirty) CompactBlock(block);
+	}
+	dirtythings.Clear();
+}
+
+void FBlockmap::CompactBlock(FBlockThings &block)
+{
+	unsigned out = 0;
+	for (unsigned i = 0; i < block.Actors.Size(); i++)
+	{
+		if (block.Actors[i] != nullptr)
+		{
+			block.Actors[out] = block.Actors[i];
+			block.SingleBlock[out] = block.SingleBlock[i];
+			block.Nodes[out] = block.Nodes[i];
+			block.Nodes[out]->ThingIndex = out;
+			out++;
+		}
+	}
+	block.Actors.Resize(out);
+	block.SingleBlock.Resize(out);
+	block.Nodes.Resize(out);
+	block.NumHoles = 0;
+	block.Dirty = false;
+}
@@ -36,6 +36,10 @@
 
 #include "g_levellocals.h"
 #include "actorinlines.h"
+#include "c_cvars.h"
+#include "workerpool.h"
+
+CVAR(Bool, sim_sightcache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 
 static FRandom pr_botchecksight ("BotCheckSight");
 static FRandom pr_checksight ("CheckSight");
@@ -51,9 +55,9 @@ This uses specialized forms of the maputils routines for optimized performance
 */
 
 // Performance meters
-static int sightcounts[6];
-static cycle_t SightCycles;
+cycle_t SightCycles;
 static cycle_t MaxSightCycles;
+static int sightcachehits, sightcachemisses, sightprefetched;
 
 enum
 {
@@ -87,12 +91,58 @@ struct SightTask
 };
 
 
-static TArray<intercept_t> intercepts (128);
-static TArray<SightTask> portals(32);
+//==========================================================================
+//
+// Everything a sight check writes to while it runs. The main thread has
+// its own and every worker of a batch gets another one, so independent
+// checks can run at the same time. Lines and polyobjects are marked in
+// private arrays instead of through validcount for the same reason.
+//
+//==========================================================================
+
+struct SightContext
+{
+	TArray<intercept_t> intercepts;
+	TArray<SightTask> portals;
+	TArray<int> linestamps;
+	TArray<int> polystamps;
+	int stamp = 0;
+	int counts[6] = {};
+
+	void Prepare(FLevelLocals *Level)
+	{
+		if (linestamps.Size() != Level->lines.Size() || polystamps.Size() != Level->Polyobjects.Size())
+		{
+			linestamps.Resize(Level->lines.Size());
+			polystamps.Resize(Level->Polyobjects.Size());
+			ClearStamps();
+		}
+	}
+
+	void NewStamp()
+	{
+		if (++stamp == INT_MAX)
+		{
+			ClearStamps();
+			stamp = 1;
+		}
+	}
+
+private:
+	void ClearStamps()
+	{
+		if (linestamps.Size() > 0) memset(&linestamps[0], 0, linestamps.Size() * sizeof(int));
+		if (polystamps.Size() > 0) memset(&polystamps[0], 0, polystamps.Size() * sizeof(int));
+	}
+};
+
+static SightContext MainSight;
+static TArray<SightContext> WorkerSight;
 
 class SightCheck
 {
 	FLevelLocals *Level;
+	SightContext *ctx;
 	DVector3 sightstart;
 	DVector2 sightend;
 	double Startfrac;
@@ -117,9 +167,10 @@ class SightCheck
 	bool LineBlocksSight(line_t *ld);
 
 public:
-	SightCheck(FLevelLocals *l)
+	SightCheck(FLevelLocals *l, SightContext *c)
 	{
 		Level = l;
+		ctx = c;
 	}
 
 	bool P_SightPathTraverse ();
@@ -279,16 +330,16 @@ bool SightCheck::PTR_SightTraverse (intercept_t *in)
 
 		if (portaldir != sector_t::floor && (open.portalflags & SO_TOPBACK) && !(open.portalflags & SO_TOPFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
+			ctx->portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
 		}
 		if (portaldir != sector_t::ceiling && (open.portalflags & SO_BOTTOMBACK) && !(open.portalflags & SO_BOTTOMFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
+			ctx->portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
 		}
 	}
 	if (lport != nullptr && lport->mDestination != nullptr)
 	{
-		portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
+		ctx->portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
 		return false;
 	}
 
@@ -434,11 +485,12 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 {
 	divline_t dl;
 
-	if (ld->validcount == validcount)
+	int &mark = ctx->linestamps[ld->Index()];
+	if (mark == ctx->stamp)
 	{
 		return true;
 	}
-	ld->validcount = validcount;
+	mark = ctx->stamp;
 	if (P_PointOnDivlineSide (ld->v1->fPos(), &Trace) ==
 		P_PointOnDivlineSide (ld->v2->fPos(), &Trace))
 	{
@@ -456,12 +508,12 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 		if (LineBlocksSight(ld)) return false;
 	}
 
-	sightcounts[3]++;
+	ctx->counts[3]++;
 	// store the line for later intersection testing
 	intercept_t newintercept;
 	newintercept.isaline = true;
 	newintercept.d.line = ld;
-	intercepts.Push (newintercept);
+	ctx->intercepts.Push (newintercept);
 
 	return true;
 }
@@ -495,9 +547,10 @@ int SightCheck::P_SightBlockLinesIterator (int x, int y)
 	{
 		if (polyLink->polyobj)
 		{ // only check non-empty links
-			if (polyLink->polyobj->validcount != validcount)
+			int &mark = ctx->polystamps[unsigned(polyLink->polyobj - Level->Polyobjects.Data())];
+			if (mark != ctx->stamp)
 			{
-				polyLink->polyobj->validcount = validcount;
+				mark = ctx->stamp;
 				for (i = 0; i < polyLink->polyobj->Linedefs.Size(); i++)
 				{
 					if (!P_SightCheckLine(polyLink->polyobj->Linedefs[i]))
@@ -534,6 +587,7 @@ int SightCheck::P_SightBlockLinesIterator (int x, int y)
 
 bool SightCheck::P_SightTraverseIntercepts ()
 {
+	auto &intercepts = ctx->intercepts;
 	unsigned count;
 	double dist;
 	intercept_t *scan, *in;
@@ -627,8 +681,8 @@ bool SightCheck::P_SightPathTraverse ()
 	int mapx, mapy, mapxstep, mapystep;
 	int count;
 
-	validcount++;
-	intercepts.Clear ();
+	ctx->NewStamp();
+	ctx->intercepts.Clear ();
 	x1 = sightstart.X + Startfrac * Trace.dx;
 	y1 = sightstart.Y + Startfrac * Trace.dy;
 	x2 = sightend.X;
@@ -660,11 +714,11 @@ bool SightCheck::P_SightPathTraverse ()
 	// We also must check if the starting sector contains  portals, and start sight checks in those as well.
 	if (portaldir != sector_t::floor && checkceiling && !lastsector->PortalBlocksSight(sector_t::ceiling))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
+		ctx->portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
 	}
 	if (portaldir != sector_t::ceiling && checkfloor && !lastsector->PortalBlocksSight(sector_t::floor))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
+		ctx->portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
 	}
 
 	x1 -= Level->blockmap.bmaporgx;
@@ -760,7 +814,7 @@ bool SightCheck::P_SightPathTraverse ()
 		itres = P_SightBlockLinesIterator(mapx, mapy);
 		if (itres == 0)
 		{
-			sightcounts[1]++;
+			ctx->counts[1]++;
 			return false;	// early out
 		}
 
@@ -771,7 +825,7 @@ bool SightCheck::P_SightPathTraverse ()
 		switch (((xs_FloorToInt(yintercept) == mapy) << 1) | (xs_FloorToInt(xintercept) == mapx))
 		{
 		case 0:		// neither xintercept nor yintercept match!
-sightcounts[5]++;
+ctx->counts[5]++;
 			// Continuing won't make things any better, so we might as well stop right here
 			return false;
 
@@ -790,7 +844,7 @@ sightcounts[5]++;
 			break;
 
 		case 3:		// xintercept and yintercept both match
-			sightcounts[4]++;
+			ctx->counts[4]++;
 			// The trace is exiting a block through its corner. Not only does the block
 			// being entered need to be checked (which will happen when this loop
 			// continues), but the other two blocks adjacent to the corner also need to
@@ -798,7 +852,7 @@ sightcounts[5]++;
 			if (!P_SightBlockLinesIterator (mapx + mapxstep, mapy) ||
 				!P_SightBlockLinesIterator (mapx, mapy + mapystep))
 			{
-sightcounts[1]++;
+ctx->counts[1]++;
 				return false;
 			}
 			xintercept += xstep;
@@ -817,7 +871,7 @@ sightcounts[1]++;
 //
 // couldn't early out, so go through the sorted list
 //
-sightcounts[2]++;
+ctx->counts[2]++;
 
 	bool traverseres = P_SightTraverseIntercepts ( );
 	if (itres == -1) return false;	// if the iterator had an early out there was no line of sight. The traverser was only called to collect more portals.
@@ -825,55 +879,49 @@ sightcounts[2]++;
 	return traverseres;
 }
 
-/*
-=====================
-=
-= P_CheckSight
-=
-= Returns true if a straight line between t1 and t2 is unobstructed
-= look from eyes of t1 to any part of t2
-=
-= killough 4/20/98: cleaned up, made to use new LOS struct
-=
-=====================
-*/
+//==========================================================================
+//
+// The parts of P_CheckSight that can be decided without a trace.
+// This includes the random chance to see invisible actors, so it must
+// always run in the order the checks were requested.
+//
+//==========================================================================
 
-int P_CheckSight (AActor *t1, AActor *t2, int flags)
+static bool P_SightRejected(AActor *t1, AActor *t2, int flags)
 {
-	SightCycles.Clock();
-
-	bool res;
-
-	if (t1 == nullptr || t2 == nullptr)
-	{
-		return false;
-	}
-
-	auto s1 = t1->Sector;
-	auto s2 = t2->Sector;
 	//
 	// check for trivial rejection
 	//
-	if (!t1->Level->CheckReject(s1, s2))
+	if (!t1->Level->CheckReject(t1->Sector, t2->Sector))
 	{
-sightcounts[0]++;
-		res = false;			// can't possibly be connected
-		goto done;
+		MainSight.counts[0]++;
+		return true;			// can't possibly be connected
 	}
 
-//
-// check precisely
-//
 	// [RH] Andy Baker's stealth monsters:
 	// Cannot see an invisible object
 	if ((flags & SF_IGNOREVISIBILITY) == 0 && ((t2->renderflags & RF_INVISIBLE) || !t2->RenderStyle.IsVisible(t2->Alpha)))
 	{ // small chance of an attack being made anyway
 		if ((t1->Level->BotInfo.m_Thinking ? pr_botchecksight() : pr_checksight()) > 50)
 		{
-			res = false;
-			goto done;
+			return true;
 		}
 	}
+	return false;
+}
+
+//==========================================================================
+//
+// The rest of P_CheckSight. This only depends on where both actors are
+// and on the level geometry, so it may run on a worker thread as long
+// as it gets its own context.
+//
+//==========================================================================
+
+static bool P_SightTrace(SightContext *ctx, AActor *t1, AActor *t2, int flags)
+{
+	auto s1 = t1->Sector;
+	auto s2 = t2->Sector;
 
 	// killough 4/19/98: make fake floors and ceilings block monster view
 
@@ -891,56 +939,370 @@ sightcounts[0]++;
 			  (t2->Z() >= s2->heightsec->ceilingplane.ZatPoint(t2) &&
 			   t1->Top() <= s2->heightsec->ceilingplane.ZatPoint(t1)))))
 		{
-			res = false;
-			goto done;
+			return false;
 		}
 	}
 
 	// An unobstructed LOS is possible.
 	// Now look from eyes of t1 to any part of t2.
 
-	validcount++;
-	portals.Clear();
+	ctx->Prepare(t1->Level);
+	ctx->portals.Clear();
+
+	sector_t *sec;
+	double lookheight = t1->Z() + t1->Height*0.75;
+	t1->GetPortalTransition(lookheight, &sec);
+
+	double bottomslope = t2->Z() - lookheight;
+	double topslope = bottomslope + t2->Height;
+	SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
+
+	SightCheck s(t1->Level, ctx);
+	s.init(t1, t2, sec, &task, flags);
+	bool res = s.P_SightPathTraverse ();
+	if (!res)
+	{
+		double dist = t1->Distance2D(t2);
+		for (unsigned i = 0; i < ctx->portals.Size(); i++)
+		{
+			ctx->portals[i].Frac += 1 / dist;
+			s.init(t1, t2, NULL, &ctx->portals[i], flags);
+			if (s.P_SightPathTraverse())
+			{
+				res = true;
+				break;
+			}
+		}
+	}
+	return res;
+}
+
+//==========================================================================
+//
+// Sight cache
+//
+// Remembers the result of P_SightTrace for the exact positions of both
+// actors. Entries only live for the current tic and are dropped as soon
+// as geometrychangecount moves, so a cached result is always what the
+// trace itself would have returned.
+//
+// The native code that moves planes, polyobjects or changes lines bumps
+// the counter once it is done. Scripts can write line and portal fields
+// directly though, so the compiler inserts a call to
+// BuiltinSightDataChanged before each such write, which turns the cache
+// off for the rest of the tic.
+//
+//==========================================================================
+
+static int geometrychangecount;
+static bool sightcachesuspended;
+
+void P_GeometryChanged()
+{
+	geometrychangecount++;
+}
+
+void P_SuspendSightCache()
+{
+	sightcachesuspended = true;
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DObject, BuiltinSightDataChanged, P_SuspendSightCache)
+{
+	PARAM_PROLOGUE;
+	P_SuspendSightCache();
+	return 0;
+}
+
+struct SightCacheEntry
+{
+	AActor *t1, *t2;
+	sector_t *s1, *s2;
+	DVector3 pos1, pos2;
+	double height1, height2;
+	int flags;
+	int tic;
+	int geometry;
+	bool result;
+};
+
+enum
+{
+	SIGHTCACHE_SIZE = 4096,		// must be a power of 2
+	SIGHT_BATCH = 16,			// number of traces per worker job
+	SIGHT_MINPARALLEL = 64,		// below this the overhead of waking the workers isn't worth it
+};
+
+static SightCacheEntry SightCache[SIGHTCACHE_SIZE];
+static int sightcachetic = 1;	// 0 is never valid so the empty entries can't match
+
+static SightCacheEntry *SightCacheSlot(AActor *t1, AActor *t2, int flags)
+{
+	uint64_t hash = (uint64_t(uintptr_t(t1)) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(uintptr_t(t2)) * 0xC2B2AE3D27D4EB4Full) ^ flags;
+	return &SightCache[(hash >> 32) & (SIGHTCACHE_SIZE - 1)];
+}
+
+static bool SightCacheLookup(AActor *t1, AActor *t2, int flags, bool &result)
+{
+	if (sightcachesuspended) return false;
+	auto entry = SightCacheSlot(t1, t2, flags);
+	if (entry->tic == sightcachetic && entry->geometry == geometrychangecount &&
+		entry->t1 == t1 && entry->t2 == t2 && entry->flags == flags &&
+		entry->s1 == t1->Sector && entry->s2 == t2->Sector &&
+		entry->pos1 == t1->Pos() && entry->pos2 == t2->Pos() &&
+		entry->height1 == t1->Height && entry->height2 == t2->Height)
 	{
-		sector_t *sec;
-		double lookheight = t1->Z() + t1->Height*0.75;
-		t1->GetPortalTransition(lookheight, &sec);
+		result = entry->result;
+		return true;
+	}
+	return false;
+}
 
-		double bottomslope = t2->Z() - lookheight;
-		double topslope = bottomslope + t2->Height;
-		SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
+static void SightCacheStore(AActor *t1, AActor *t2, int flags, bool result)
+{
+	if (sightcachesuspended) return;
+	auto entry = SightCacheSlot(t1, t2, flags);
+	entry->t1 = t1;
+	entry->t2 = t2;
+	entry->s1 = t1->Sector;
+	entry->s2 = t2->Sector;
+	entry->pos1 = t1->Pos();
+	entry->pos2 = t2->Pos();
+	entry->height1 = t1->Height;
+	entry->height2 = t2->Height;
+	entry->flags = flags;
+	entry->tic = sightcachetic;
+	entry->geometry = geometrychangecount;
+	entry->result = result;
+}
 
+//==========================================================================
+//
+// Traces that still need to be done for a batch. With enough of them
+// they get spread over a worker pool, each worker with its own context.
+// Nothing in the level changes while they run, so the results are the
+// same as doing them one after the other.
+//
+//==========================================================================
 
-		SightCheck s(t1->Level);
-		s.init(t1, t2, sec, &task, flags);
-		res = s.P_SightPathTraverse ();
-		if (!res)
+struct SightJob
+{
+	AActor *t1, *t2;
+	int flags;
+	bool result;
+};
+
+static TArray<SightJob> SightJobs;
+
+static void RunSightJobs(SightContext *ctx, unsigned start, unsigned end)
+{
+	for (unsigned i = start; i < end; i++)
+	{
+		auto &job = SightJobs[i];
+		job.result = P_SightTrace(ctx, job.t1, job.t2, job.flags);
+	}
+}
+
+static void P_ResolveSightJobs()
+{
+	unsigned count = SightJobs.Size();
+	if (count < SIGHT_MINPARALLEL)
+	{
+		RunSightJobs(&MainSight, 0, count);
+	}
+	else
+	{
+		// One context per pool thread, plus the first one for this thread, which helps out while it waits.
+		if (WorkerSight.Size() == 0)
 		{
-			double dist = t1->Distance2D(t2);
-			for (unsigned i = 0; i < portals.Size(); i++)
+			WorkerSight.Resize(FWorkerPool::NumThreads() + 1);
+		}
+		std::vector<FWorkerJobPtr> jobs;
+		for (unsigned start = 0; start < count; start += SIGHT_BATCH)
+		{
+			unsigned end = std::min<unsigned>(start + SIGHT_BATCH, count);
+			jobs.push_back(FWorkerPool::Push([=]() { RunSightJobs(&WorkerSight[FWorkerPool::WorkerIndex()], start, end); }));
+		}
+		FWorkerPool::WaitAll(jobs);
+		for (auto &worker : WorkerSight)
+		{
+			for (int i = 0; i < 6; i++)
 			{
-				portals[i].Frac += 1 / dist;
-				s.init(t1, t2, NULL, &portals[i], flags);
-				if (s.P_SightPathTraverse())
-				{
-					res = true;
-					break;
-				}
+				MainSight.counts[i] += worker.counts[i];
+				worker.counts[i] = 0;
 			}
 		}
 	}
+	if (sim_sightcache)
+	{
+		for (auto &job : SightJobs)
+		{
+			SightCacheStore(job.t1, job.t2, job.flags, job.result);
+		}
+	}
+}
+
+/*
+=====================
+=
+= P_CheckSight
+=
+= Returns true if a straight line between t1 and t2 is unobstructed
+= look from eyes of t1 to any part of t2
+=
+= killough 4/20/98: cleaned up, made to use new LOS struct
+=
+=====================
+*/
+
+int P_CheckSight (AActor *t1, AActor *t2, int flags)
+{
+	SightCycles.Clock();
+
+	bool res;
+
+	if (t1 == nullptr || t2 == nullptr)
+	{
+		return false;
+	}
+
+	if (P_SightRejected(t1, t2, flags))
+	{
+		res = false;
+	}
+	else if (!sim_sightcache)
+	{
+		res = P_SightTrace(&MainSight, t1, t2, flags);
+	}
+	else if (SightCacheLookup(t1, t2, flags, res))
+	{
+		sightcachehits++;
+	}
+	else
+	{
+		sightcachemisses++;
+		res = P_SightTrace(&MainSight, t1, t2, flags);
+		SightCacheStore(t1, t2, flags, res);
+	}
 
-done:
 	SightCycles.Unclock();
 	return res;
 }
 
+//==========================================================================
+//
+// P_CheckSightBatch
+//
+// Does the same as calling P_CheckSight for every query in order, but
+// the traces that aren't cached yet may run in parallel.
+//
+//==========================================================================
+
+void P_CheckSightBatch (FSightQuery *queries, unsigned count)
+{
+	SightCycles.Clock();
+
+	SightJobs.Clear();
+	for (unsigned i = 0; i < count; i++)
+	{
+		auto &q = queries[i];
+		bool res;
+
+		if (q.t1 == nullptr || q.t2 == nullptr || P_SightRejected(q.t1, q.t2, q.flags))
+		{
+			q.result = false;
+		}
+		else if (sim_sightcache && SightCacheLookup(q.t1, q.t2, q.flags, res))
+		{
+			sightcachehits++;
+			q.result = res;
+		}
+		else
+		{
+			if (sim_sightcache) sightcachemisses++;
+			q.result = -1;
+			SightJobs.Push({ q.t1, q.t2, q.flags, false });
+		}
+	}
+
+	P_ResolveSightJobs();
+
+	unsigned job = 0;
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (queries[i].result == -1)
+		{
+			queries[i].result = SightJobs[job++].result;
+		}
+	}
+
+	SightCycles.Unclock();
+}
+
+//==========================================================================
+//
+// P_PrefetchLookSight
+//
+// Called right before the monsters think. Every idle monster that is
+// about to enter its next state will most likely call A_Look, so the
+// sight checks against the players are done up front as one batch and
+// A_Look will then find them in the cache. Since nothing random happens
+// here this is merely a guess and never changes the outcome.
+//
+//==========================================================================
+
+void P_PrefetchLookSight (FLevelLocals *Level)
+{
+	if (!sim_sightcache || sightcachesuspended)
+	{
+		return;
+	}
+
+	SightCycles.Clock();
+
+	SightJobs.Clear();
+	auto it = Level->GetThinkerIterator<AActor>(NAME_None, STAT_DEFAULT);
+	AActor *ac;
+	while ((ac = it.Next()))
+	{
+		if (!(ac->flags3 & MF3_ISMONSTER) || ac->target != nullptr || ac->tics != 1 || ac->health <= 0 || (ac->flags2 & MF2_DORMANT))
+		{
+			continue;
+		}
+		for (int i = 0; i < MAXPLAYERS; i++)
+		{
+			if (!Level->PlayerInGame(i))
+			{
+				continue;
+			}
+			AActor *mo = Level->Players[i]->mo;
+			bool res;
+			if (mo == nullptr || mo->health <= 0 || !Level->CheckReject(ac->Sector, mo->Sector) ||
+				SightCacheLookup(ac, mo, SF_SEEPASTSHOOTABLELINES, res))
+			{
+				continue;
+			}
+			SightJobs.Push({ ac, mo, SF_SEEPASTSHOOTABLELINES, false });
+		}
+	}
+	sightprefetched += SightJobs.Size();
+	P_ResolveSightJobs();
+
+	SightCycles.Unclock();
+}
+
 ADD_STAT (sight)
 {
 	FString out;
 	out.Format ("%04.1f ms (%04.1f max), %5d %2d%4d%4d%4d%4d\n",
 		SightCycles.TimeMS(), MaxSightCycles.TimeMS(),
-		sightcounts[3], sightcounts[0], sightcounts[1], sightcounts[2], sightcounts[4], sightcounts[5]);
+		MainSight.counts[3], MainSight.counts[0], MainSight.counts[1], MainSight.counts[2], MainSight.counts[4], MainSight.counts[5]);
+	if (sim_sightcache)
+	{
+		int lookups = sightcachehits + sightcachemisses;
+		out.AppendFormat ("cache: %d hits, %d misses (%.1f%% hit rate), %d prefetched\n",
+			sightcachehits, sightcachemisses, lookups > 0 ? sightcachehits * 100. / lookups : 0., sightprefetched);
+	}
 	return out;
 }
 
@@ -955,5 +1317,10 @@ void P_ResetSightCounters (bool full)
 		MaxSightCycles = SightCycles;
 	}
 	SightCycles.Reset();
-	memset (sightcounts, 0, sizeof(sightcounts));
+	memset (MainSight.counts, 0, sizeof(MainSight.counts));
+	sightcachehits = sightcachemisses = sightprefetched = 0;
+
+	// This is called once per tic, before anything can move.
+	sightcachetic++;
+	sightcachesuspended = false;
 }
@@ -1455,9 +1455,12 @@ void P_PredictPlayer (player_t *player)
 			block->NextActor->PrevActor = block->PrevActor;
 		}
 		*(block->PrevActor) = block->NextActor;
+		act->Level->blockmap.UnlinkThing(block);
 		block = block->NextBlock;
 	}
 	act->BlockNode = NULL;
+	// The cleared entries must stay where they are until they get restored.
+	act->Level->blockmap.thinglocks++;
 
 	// Values too small to be usable for lerping can be considered "off".
 	bool CanLerp = (!(cl_predict_lerpscale < 0.01f) && (ticdup == 1)), DoLerp = false, NoInterpolateOld = R_GetViewInterpolationStatus();
@@ -1598,8 +1601,10 @@ void P_UnPredictPlayer ()
 			{
 				block->NextActor->PrevActor = &block->NextActor;
 			}
+			act->Level->blockmap.RestoreThing(block);
 			block = block->NextBlock;
 		}
+		act->Level->blockmap.thinglocks--;
 
 		actInvSel = InvSel;
 		player->inventorytics = inventorytics;
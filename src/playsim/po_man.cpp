@@ -996,6 +996,8 @@ void FPolyObj::UnLinkPolyobj ()
 	int i, j;
 	int index;
 
+	P_GeometryChanged();
+
 	// remove the polyobj from each blockmap section
 	for(j = bbox[BOXBOTTOM]; j <= bbox[BOXTOP]; j++)
 	{
@@ -1165,6 +1167,8 @@ void FPolyObj::LinkPolyobj ()
 	int bmapwidth = Level->blockmap.bmapwidth;
 	int bmapheight = Level->blockmap.bmapheight;
 
+	P_GeometryChanged();
+
 	// calculate the polyobj bbox
 	Bounds.ClearBox();
 	for(unsigned i = 0; i < Sidedefs.Size(); i++)
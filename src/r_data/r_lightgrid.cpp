@@ -0,0 +1,233 @@
+/*
+** r_lightgrid.cpp
+** Spatial lookup of the dynamic lights
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The sections a light is linked to can be large, so walking a section's
+** light list to light a sprite tests many lights that are nowhere near it.
+** The grid narrows this down to the lights that can reach the sprite's
+** position. It gets rebuilt before rendering whenever a light has been
+** linked or unlinked since the last build, i.e. at most once per tic.
+**
+*/
+
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "g_levellocals.h"
+#include "a_dynlight.h"
+#include "r_lightgrid.h"
+
+CVAR(Bool, r_lightgrid, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+// The cells get larger on big maps to keep the grid's size in check.
+static const double MinCellSize = 128;
+static const int MaxCells = 1 << 18;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void FLightGrid::Clear()
+{
+	CellStart.Reset();
+	CellLights.Reset();
+	Lights.Reset();
+	LightSections.Reset();
+	Boxes.Reset();
+	Width = Height = 0;
+	Valid = false;
+}
+
+void FLightGrid::SetupCells(FLevelLocals *Level)
+{
+	double left = DBL_MAX, top = DBL_MAX, right = -DBL_MAX, bottom = -DBL_MAX;
+	for (auto &v : Level->vertexes)
+	{
+		left = MIN(left, v.fX());
+		right = MAX(right, v.fX());
+		top = MIN(top, v.fY());
+		bottom = MAX(bottom, v.fY());
+	}
+
+	CellSize = MinCellSize;
+	do
+	{
+		Width = int((right - left) / CellSize) + 1;
+		Height = int((bottom - top) / CellSize) + 1;
+		if (Width * Height <= MaxCells) break;
+		CellSize *= 2;
+	} while (true);
+
+	OriginX = left;
+	OriginY = top;
+	InvCellSize = 1. / CellSize;
+}
+
+//==========================================================================
+//
+// Rebuilds the grid if the lights' links have changed.
+//
+//==========================================================================
+
+void FLightGrid::Update(FLevelLocals *Level)
+{
+	if (!r_lightgrid || Level->lights == nullptr || Level->vertexes.Size() == 0)
+	{
+		Valid = false;
+		return;
+	}
+	if (Valid)
+	{
+		return;
+	}
+
+	BuildTime.Reset();
+	BuildTime.Clock();
+	if (Width == 0) SetupCells(Level);
+
+	const unsigned numcells = Width * Height;
+	CellStart.Resize(numcells + 1);
+	memset(CellStart.Data(), 0, CellStart.Size() * sizeof(unsigned));
+
+	// Find the cells each light can reach. A light that shines through a
+	// linked portal also covers the cells of its position on the other side.
+	// Each position gets its own box because the portal displacements can be
+	// large enough for one box around all of them to cover most of the map.
+	// Overlapping boxes of a light get merged so that no cell lists it twice.
+	Boxes.Clear();
+	Lights.Clear();
+	LightSections.Clear();
+	for (auto light = Level->lights; light != nullptr; light = light->next)
+	{
+		if (light->touching_sector == nullptr) continue;
+
+		double radius = MAX<double>(light->radius, light->GetRadius()) + 1;
+		unsigned index = Lights.Size();
+		unsigned firstsection = LightSections.Size();
+		unsigned firstbox = Boxes.Size();
+		for (auto node = light->touching_sector; node != nullptr; node = node->nextTarget)
+		{
+			auto section = (FSection *)node->targ;
+			LightSections.Push(Level->sections.SectionIndex(section));
+			DVector3 pos = light->PosRelative(section->sector->PortalGroup);
+			LightBox box = { index, CellX(pos.X - radius), CellY(pos.Y - radius), CellX(pos.X + radius), CellY(pos.Y + radius) };
+
+			for (unsigned i = firstbox; i < Boxes.Size(); )
+			{
+				auto &other = Boxes[i];
+				if (box.X1 > other.X2 || box.X2 < other.X1 || box.Y1 > other.Y2 || box.Y2 < other.Y1)
+				{
+					i++;
+					continue;
+				}
+				box.X1 = MIN(box.X1, other.X1);
+				box.Y1 = MIN(box.Y1, other.Y1);
+				box.X2 = MAX(box.X2, other.X2);
+				box.Y2 = MAX(box.Y2, other.Y2);
+				// The merged box may now overlap boxes that were checked before.
+				other = Boxes.Last();
+				Boxes.Pop();
+				i = firstbox;
+			}
+			Boxes.Push(box);
+		}
+		for (unsigned i = firstbox; i < Boxes.Size(); i++)
+		{
+			auto &box = Boxes[i];
+			for (int y = box.Y1; y <= box.Y2; y++)
+			{
+				for (int x = box.X1; x <= box.X2; x++)
+				{
+					CellStart[y * Width + x]++;
+				}
+			}
+		}
+		std::sort(&LightSections[firstsection], LightSections.Data() + LightSections.Size());
+		Lights.Push({ light, firstsection, LightSections.Size() - firstsection });
+	}
+
+	// Turn the counts into the end of each cell's range and fill the ranges
+	// from the back so that CellStart ends up at the start.
+	for (unsigned i = 1; i < numcells; i++)
+	{
+		CellStart[i] += CellStart[i - 1];
+	}
+	CellStart[numcells] = CellStart[numcells - 1];
+	CellLights.Resize(CellStart[numcells]);
+	for (auto &box : Boxes)
+	{
+		for (int y = box.Y1; y <= box.Y2; y++)
+		{
+			for (int x = box.X1; x <= box.X2; x++)
+			{
+				CellLights[--CellStart[y * Width + x]] = box.Light;
+			}
+		}
+	}
+	Valid = true;
+	BuildTime.Unclock();
+
+	UsedCells = 0;
+	MaxPerCell = 0;
+	for (unsigned i = 0; i < numcells; i++)
+	{
+		unsigned count = CellStart[i + 1] - CellStart[i];
+		if (count > 0) UsedCells++;
+		MaxPerCell = MAX(MaxPerCell, count);
+	}
+	Rebuilds++;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FString FLightGrid::GetStats()
+{
+	FString out;
+	if (!Valid)
+	{
+		out = "Light grid not in use";
+		return out;
+	}
+	out.Format("Light grid: %dx%d cells of %g units, %u lights in %u boxes, %u entries\n", Width, Height, CellSize, Lights.Size(), Boxes.Size(), CellLights.Size());
+	out.AppendFormat("Used cells: %u, lights per used cell: %2.2f, max: %u\n", UsedCells, UsedCells > 0 ? double(CellLights.Size()) / UsedCells : 0., MaxPerCell);
+	out.AppendFormat("Rebuilds: %u, last rebuild: %2.3f ms", Rebuilds, BuildTime.TimeMS());
+	return out;
+}
+
+ADD_STAT(lightgrid)
+{
+	return primaryLevel->LightGrid.GetStats();
+}
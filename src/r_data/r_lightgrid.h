@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include "templates.h"
+#include "tarray.h"
+#include "stats.h"
+
+struct FDynamicLight;
+struct FLevelLocals;
+
+//==========================================================================
+//
+// A uniform grid over the level that lists for each cell the dynamic lights
+// whose area may reach into it. It is built from the lights' links, so a
+// light only shows up if it is linked to some section, and the callers
+// still have to check that it is linked to the section they are in.
+// For that each light keeps a sorted list of its sections' indices.
+// Z is not considered because the links do not consider it either.
+//
+//==========================================================================
+
+class FLightGrid
+{
+public:
+	void Clear();
+	void Update(FLevelLocals *Level);
+	void MarkDirty() { Valid = false; }
+	bool IsValid() const { return Valid; }
+	unsigned NumLights() const { return Lights.Size(); }
+
+	// Calls callback(light, index) for each light whose area may contain the point.
+	// The index identifies the light for IsLinkedTo and FLightGridMarks.
+	template<class Callback>
+	void ForLightsAt(double x, double y, const Callback &callback) const
+	{
+		int cell = CellY(y) * Width + CellX(x);
+		for (unsigned i = CellStart[cell]; i < CellStart[cell + 1]; i++)
+		{
+			callback(Lights[CellLights[i]].Light, CellLights[i]);
+		}
+	}
+
+	// Same for a box. A light that covers several cells gets reported once for each of them.
+	template<class Callback>
+	void ForLightsInBox(double left, double top, double right, double bottom, const Callback &callback) const
+	{
+		int x1 = CellX(left), x2 = CellX(right);
+		int y1 = CellY(top), y2 = CellY(bottom);
+		for (int y = y1; y <= y2; y++)
+		{
+			for (int x = x1; x <= x2; x++)
+			{
+				int cell = y * Width + x;
+				for (unsigned i = CellStart[cell]; i < CellStart[cell + 1]; i++)
+				{
+					callback(Lights[CellLights[i]].Light, CellLights[i]);
+				}
+			}
+		}
+	}
+
+	bool IsLinkedTo(unsigned light, int sectionindex) const
+	{
+		auto &entry = Lights[light];
+		auto first = &LightSections[entry.FirstSection], last = first + entry.NumSections;
+		return std::binary_search(first, last, sectionindex);
+	}
+
+	FString GetStats();
+
+private:
+	void SetupCells(FLevelLocals *Level);
+
+	int CellX(double x) const
+	{
+		int cx = int((x - OriginX) * InvCellSize);
+		return cx < 0 ? 0 : cx >= Width ? Width - 1 : cx;
+	}
+
+	int CellY(double y) const
+	{
+		int cy = int((y - OriginY) * InvCellSize);
+		return cy < 0 ? 0 : cy >= Height ? Height - 1 : cy;
+	}
+
+	struct LightEntry
+	{
+		FDynamicLight *Light;
+		unsigned FirstSection, NumSections;		// in LightSections
+	};
+
+	struct LightBox
+	{
+		unsigned Light;
+		int X1, Y1, X2, Y2;
+	};
+
+	TArray<unsigned> CellStart;			// Width * Height + 1 entries
+	TArray<unsigned> CellLights;		// indices into Lights
+	TArray<LightEntry> Lights;
+	TArray<int> LightSections;
+	TArray<LightBox> Boxes;
+	double OriginX = 0, OriginY = 0;
+	double CellSize = 0, InvCellSize = 0;
+	int Width = 0, Height = 0;
+	bool Valid = false;
+
+	// statistics
+	cycle_t BuildTime;
+	unsigned UsedCells = 0;
+	unsigned MaxPerCell = 0;
+	unsigned Rebuilds = 0;
+};
+
+//==========================================================================
+//
+// Scratch marks for skipping lights and sections that were already seen
+// while lighting one actor. Every thread needs its own because the render
+// threads light actors concurrently.
+//
+//==========================================================================
+
+struct FLightGridMarks
+{
+	TArray<unsigned> Lights;
+	TArray<unsigned> Sections;
+	unsigned Mark = 0;
+
+	void Begin(unsigned numlights, unsigned numsections)
+	{
+		if (++Mark == 0 || Lights.Size() < numlights || Sections.Size() < numsections)
+		{
+			Lights.Resize(MAX(Lights.Size(), numlights));
+			Sections.Resize(MAX(Sections.Size(), numsections));
+			memset(Lights.Data(), 0, Lights.Size() * sizeof(unsigned));
+			memset(Sections.Data(), 0, Sections.Size() * sizeof(unsigned));
+			Mark = 1;
+		}
+	}
+
+	// These return false if the light or section was already marked.
+	bool MarkLight(unsigned index)
+	{
+		if (Lights[index] == Mark) return false;
+		Lights[index] = Mark;
+		return true;
+	}
+
+	bool MarkSection(int index)
+	{
+		if (Sections[index] == Mark) return false;
+		Sections[index] = Mark;
+		return true;
+	}
+};
@@ -40,9 +40,12 @@
 #include "modelrenderer.h"
 #include "hw_models.h"
 #include "d_main.h"
+#include "stats.h"
 
 EXTERN_CVAR(Bool, gl_precache)
 
+static double precacheTextureMS, precacheUploadMS;
+
 //==========================================================================
 //
 // DFrameBuffer :: PrecacheTexture
@@ -97,6 +100,8 @@ static void PrecacheSprite(FGameTexture *tex, SpriteHits &hits)
 
 void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitlist)
 {
+	if (screen->RenderState() == nullptr) return;	// no hardware device to create textures and model buffers on
+
 	TMap<FTexture*, bool> allTextures;
 	TArray<FTexture*> layers;
 
@@ -299,6 +304,12 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 			}
 		}
 
+		FImageSource::StartPrecacheDecoding();
+
+		cycle_t textures;
+		textures.Reset();
+		textures.Clock();
+
 		// cache all used textures
 		for (int i = cnt - 1; i >= 0; i--)
 		{
@@ -313,9 +324,16 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 			}
 		}
 
+		textures.Unclock();
 
 		FImageSource::EndPrecaching();
 
+		// Whatever the main thread did not spend on the decoding jobs went into creating the hardware textures,
+		// including the images that cannot be decoded on a worker thread.
+		auto stats = FImageSource::GetPrecacheStats();
+		precacheTextureMS = textures.TimeMS();
+		precacheUploadMS = precacheTextureMS - stats.WaitMS;
+
 		// cache all used models
 		FModelRenderer* renderer = new FHWModelRenderer(nullptr, *screen->RenderState(), -1);
 		for (unsigned i = 0; i < Models.Size(); i++)
@@ -327,6 +345,8 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 
 		precache.Unclock();
 		DPrintf(DMSG_NOTIFY, "Textures precached in %.3f ms\n", precache.TimeMS());
+		DPrintf(DMSG_NOTIFY, "%d images decoded on %d threads in %.3f ms, main thread waited %.3f ms, upload %.3f ms\n",
+			stats.Decoded, stats.Threads, stats.DecodeMS, stats.WaitMS, precacheUploadMS);
 	}
 
 	delete[] spritehitlist;
@@ -334,3 +354,17 @@ void hw_PrecacheTexture(uint8_t *texhitlist, TMap<PClassActor*, bool> &actorhitl
 	delete[] modellist;
 }
 
+//==========================================================================
+//
+// Timings of the last texture precache
+//
+//==========================================================================
+
+ADD_STAT(precache)
+{
+	auto stats = FImageSource::GetPrecacheStats();
+	FString out;
+	out.Format("Precache threads: %d, images decoded: %d\nTextures = %2.3f, decode = %2.3f, wait = %2.3f, upload = %2.3f",
+		stats.Threads, stats.Decoded, precacheTextureMS, stats.DecodeMS, stats.WaitMS, precacheUploadMS);
+	return out;
+}
@@ -32,7 +32,8 @@
 #include "p_effect.h"
 #include "po_man.h"
 #include "m_fixed.h"
-#include "ctpl.h"
+#include "workerpool.h"
+#include "stats.h"
 #include "texturemanager.h"
 #include "hwrenderer/scene/hw_fakeflat.h"
 #include "hwrenderer/scene/hw_clipper.h"
@@ -42,17 +43,21 @@
 #include "hw_clock.h"
 #include "flatvertices.h"
 #include "hw_vertexbuilder.h"
+#include <condition_variable>
 
 #ifdef ARCH_IA32
 #include <immintrin.h>
 #endif // ARCH_IA32
 
 CVAR(Bool, gl_multithread, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CVAR(Int, gl_multithread_workers, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// 0 means one per spare core, up to 4
 
 EXTERN_CVAR(Float, r_actorspriteshadowdist)
 
 thread_local bool isWorkerThread;
-ctpl::thread_pool renderPool(1);
+thread_local HWDrawList *WorkerDrawLists;
+thread_local TArray<HWDecal *> *WorkerDecals;
+std::mutex WorkerSharedLock;
 bool inited = false;
 
 struct RenderJob
@@ -64,7 +69,6 @@ struct RenderJob
 		SpriteJob,
 		ParticleJob,
 		PortalJob,
-		TerminateJob	// inserted when all work is done so that the worker can return.
 	};
 	
 	int type;
@@ -72,12 +76,56 @@ struct RenderJob
 	seg_t *seg;
 };
 
+// Everything a single worker produces. It gets merged into the HWDrawInfo once the BSP has been traversed.
+struct RenderJobOutput
+{
+	HWDrawList drawlists[GLDL_TYPES];
+	TArray<HWDecal *> Decals[2];
+	FRenderCounts counts;
+	int jobs;
+
+	void Reset()
+	{
+		for (auto &list : drawlists) list.Reset();
+		Decals[0].Clear();
+		Decals[1].Clear();
+		jobs = 0;
+	}
+};
+
+// Which worker processed a batch of jobs and which part of its output belongs to that batch.
+// Merging the batches in order makes the draw lists independent of how the jobs got distributed.
+struct RenderJobBatch
+{
+	enum { Size = 32 };
+
+	int worker;
+	unsigned first[GLDL_TYPES + 2];
+	unsigned last[GLDL_TYPES + 2];
+};
 
 class RenderJobQueue
 {
 	RenderJob pool[300000];	// Way more than ever needed. The largest ever seen on a single viewpoint is around 40000.
-	std::atomic<int> readindex{};
+	RenderJobBatch batches[300000 / RenderJobBatch::Size + 1];
 	std::atomic<int> writeindex{};
+	std::atomic<int> batchindex{};
+	std::atomic<bool> finished{};
+	std::atomic<int> sleepers{};
+	std::mutex wakeLock;
+	std::condition_variable wakeup;
+
+	void WakeSleepers()
+	{
+		// Only lock if some worker is actually asleep. Since a worker registers itself before checking the
+		// queue for the last time and this is checked after the queue has been updated, none can be missed.
+		if (sleepers > 0)
+		{
+			std::lock_guard<std::mutex> lock(wakeLock);
+			wakeup.notify_all();
+		}
+	}
+
 public:
 	void AddJob(int type, subsector_t *sub, seg_t *seg = nullptr)
 	{
@@ -85,132 +133,255 @@ public:
 
 		pool[writeindex] = { type, sub, seg };
 		writeindex++;	// update index only after the value has been written.
+		WakeSleepers();
 	}
 
-	RenderJob *GetJob()
+	// Called when the BSP has been fully traversed and no more jobs will be added.
+	void Finish()
 	{
-		if (readindex < writeindex) return &pool[readindex++];
-		return nullptr;
+		finished = true;
+		WakeSleepers();
 	}
-	
+
+	// Waits until the given job has been added. Returns null if it never will be.
+	RenderJob *WaitForJob(int index)
+	{
+		if (index >= writeindex && !finished)
+		{
+#ifdef ARCH_IA32
+			// The next job is usually only a moment away so retry a few times before going to sleep,
+			// which would be too costly to do for every single job.
+			for (int i = 0; i < 64 && index >= writeindex && !finished; i++)
+			{
+				_mm_pause();
+			}
+#endif // ARCH_IA32
+			if (index >= writeindex && !finished)
+			{
+				std::unique_lock<std::mutex> lock(wakeLock);
+				sleepers++;
+				wakeup.wait(lock, [=]() { return index < writeindex || finished; });
+				sleepers--;
+			}
+		}
+		// writeindex must be checked again because it may have changed before 'finished' got set.
+		return index < writeindex ? &pool[index] : nullptr;
+	}
+
+	int ClaimBatch()
+	{
+		return batchindex++;
+	}
+
+	RenderJobBatch &GetBatch(int index)
+	{
+		return batches[index];
+	}
+
+	int NumBatches() const
+	{
+		return (writeindex + RenderJobBatch::Size - 1) / RenderJobBatch::Size;
+	}
+
 	void ReleaseAll()
 	{
-		readindex = 0;
 		writeindex = 0;
+		batchindex = 0;
+		finished = false;
 	}
 };
 
 static RenderJobQueue jobQueue;	// One static queue is sufficient here. This code will never be called recursively.
+static TDeletingArray<RenderJobOutput *> jobOutputs;
+static int numWorkers;
 
-void HWDrawInfo::WorkerThread()
+static void GetOutputSizes(RenderJobOutput &output, unsigned *sizes)
+{
+	for (int i = 0; i < GLDL_TYPES; i++) sizes[i] = output.drawlists[i].drawitems.Size();
+	sizes[GLDL_TYPES] = output.Decals[0].Size();
+	sizes[GLDL_TYPES + 1] = output.Decals[1].Size();
+}
+
+void HWDrawInfo::WorkerThread(int worker)
 {
 	sector_t *front, *back;
+	auto &output = *jobOutputs[worker];
+	// Only the first worker updates the timers. They are not meant to be used by multiple threads at once.
+	bool timed = worker == 0;
 
-	WTTotal.Clock();
+	if (timed) WTTotal.Clock();
 	isWorkerThread = true;	// for adding asserts in GL API code. The worker thread may never call any GL API.
+	WorkerDrawLists = output.drawlists;
+	WorkerDecals = output.Decals;
+	RenderDataArena = GetWorkerDataAllocator(worker);
 	while (true)
 	{
-		auto job = jobQueue.GetJob();
-		if (job == nullptr)
-		{
-#ifdef ARCH_IA32
-			// The queue is empty. But yielding would be too costly here and possibly cause further delays down the line if the thread is halted.
-			// So instead add a few pause instructions and retry immediately.
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-			_mm_pause();
-#endif // ARCH_IA32
-		}
-		// Note that the main thread MUST have prepared the fake sectors that get used below!
-		// This worker thread cannot prepare them itself without costly synchronization.
-		else switch (job->type)
-		{
-		case RenderJob::TerminateJob:
-			WTTotal.Unclock();
-			return;
+		int batchindex = jobQueue.ClaimBatch();
+		int firstjob = batchindex * RenderJobBatch::Size;
+		// Batches get claimed in order so once one is empty all following ones are, too.
+		if (jobQueue.WaitForJob(firstjob) == nullptr) break;
 
-		case RenderJob::WallJob:
+		auto &batch = jobQueue.GetBatch(batchindex);
+		batch.worker = worker;
+		GetOutputSizes(output, batch.first);
+
+		for (int j = firstjob; j < firstjob + RenderJobBatch::Size; j++)
 		{
-			HWWall wall;
-			SetupWall.Clock();
-			wall.sub = job->sub;
-
-			front = hw_FakeFlat(job->sub->sector, in_area, false);
-			auto seg = job->seg;
-			auto backsector = seg->backsector;
-			if (!backsector && seg->linedef->isVisualPortal() && seg->sidedef == seg->linedef->sidedef[0]) // For one-sided portals use the portal's destination sector as backsector.
+			auto job = jobQueue.WaitForJob(j);
+			if (job == nullptr) break;
+			output.jobs++;
+
+			// Note that the main thread MUST have prepared the fake sectors that get used below!
+			// This worker thread cannot prepare them itself without costly synchronization.
+			switch (job->type)
 			{
-				auto portal = seg->linedef->getPortal();
-				backsector = portal->mDestination->frontsector;
-				back = hw_FakeFlat(backsector, in_area, true);
-				if (front->floorplane.isSlope() || front->ceilingplane.isSlope() || back->floorplane.isSlope() || back->ceilingplane.isSlope())
-				{
-					// Having a one-sided portal like this with slopes is too messy so let's ignore that case.
-					back = nullptr;
-				}
-			}
-			else if (backsector)
+			case RenderJob::WallJob:
 			{
-				if (front->sectornum == backsector->sectornum || (seg->sidedef->Flags & WALLF_POLYOBJ))
+				HWWall wall;
+				if (timed) SetupWall.Clock();
+				wall.sub = job->sub;
+
+				front = hw_FakeFlat(job->sub->sector, in_area, false);
+				auto seg = job->seg;
+				auto backsector = seg->backsector;
+				if (!backsector && seg->linedef->isVisualPortal() && seg->sidedef == seg->linedef->sidedef[0]) // For one-sided portals use the portal's destination sector as backsector.
 				{
-					back = front;
+					auto portal = seg->linedef->getPortal();
+					backsector = portal->mDestination->frontsector;
+					back = hw_FakeFlat(backsector, in_area, true);
+					if (front->floorplane.isSlope() || front->ceilingplane.isSlope() || back->floorplane.isSlope() || back->ceilingplane.isSlope())
+					{
+						// Having a one-sided portal like this with slopes is too messy so let's ignore that case.
+						back = nullptr;
+					}
 				}
-				else
+				else if (backsector)
 				{
-					back = hw_FakeFlat(backsector, in_area, true);
+					if (front->sectornum == backsector->sectornum || (seg->sidedef->Flags & WALLF_POLYOBJ))
+					{
+						back = front;
+					}
+					else
+					{
+						back = hw_FakeFlat(backsector, in_area, true);
+					}
 				}
-			}
-			else back = nullptr;
+				else back = nullptr;
 
-			wall.Process(this, job->seg, front, back);
-			rendered_lines++;
-			SetupWall.Unclock();
-			break;
-		}
+				wall.Process(this, job->seg, front, back);
+				rendered_lines++;
+				if (timed) SetupWall.Unclock();
+				break;
+			}
 
-		case RenderJob::FlatJob:
-		{
-			HWFlat flat;
-			SetupFlat.Clock();
-			flat.section = job->sub->section;
-			front = hw_FakeFlat(job->sub->render_sector, in_area, false);
-			flat.ProcessSector(this, front);
-			SetupFlat.Unclock();
-			break;
-		}
+			case RenderJob::FlatJob:
+			{
+				HWFlat flat;
+				if (timed) SetupFlat.Clock();
+				flat.section = job->sub->section;
+				front = hw_FakeFlat(job->sub->render_sector, in_area, false);
+				flat.ProcessSector(this, front);
+				if (timed) SetupFlat.Unclock();
+				break;
+			}
 
-		case RenderJob::SpriteJob:
-			SetupSprite.Clock();
-			front = hw_FakeFlat(job->sub->sector, in_area, false);
-			RenderThings(job->sub, front);
-			SetupSprite.Unclock();
-			break;
+			case RenderJob::SpriteJob:
+			{
+				// Actors can touch several sectors and get checked for being processed already,
+				// and line portals temporarily move them, so only one thread may handle them at a time.
+				std::lock_guard<std::mutex> lock(WorkerSharedLock);
+				if (timed) SetupSprite.Clock();
+				front = hw_FakeFlat(job->sub->sector, in_area, false);
+				RenderThings(job->sub, front);
+				if (timed) SetupSprite.Unclock();
+				break;
+			}
 
-		case RenderJob::ParticleJob:
-			SetupSprite.Clock();
-			front = hw_FakeFlat(job->sub->sector, in_area, false);
-			RenderParticles(job->sub, front);
-			SetupSprite.Unclock();
-			break;
+			case RenderJob::ParticleJob:
+				if (timed) SetupSprite.Clock();
+				front = hw_FakeFlat(job->sub->sector, in_area, false);
+				RenderParticles(job->sub, front);
+				if (timed) SetupSprite.Unclock();
+				break;
 
-		case RenderJob::PortalJob:
-			AddSubsectorToPortal((FSectorPortalGroup *)job->seg, job->sub);
-			break;
+			case RenderJob::PortalJob:
+				AddSubsectorToPortal((FSectorPortalGroup *)job->seg, job->sub);
+				break;
+			}
 		}
+		GetOutputSizes(output, batch.last);
+	}
+	output.counts.TakeFromThread();
+	WorkerDrawLists = nullptr;
+	WorkerDecals = nullptr;
+	RenderDataArena = &RenderDataAllocator;
+	isWorkerThread = false;
+	if (timed) WTTotal.Unclock();
+}
+
+//==========================================================================
+//
+// Returns the number of worker threads to use for BSP processing
+//
+//==========================================================================
 
+static int GetWorkerCount()
+{
+	int count = gl_multithread_workers;
+	if (count <= 0)
+	{
+		// A single thread traversing the BSP cannot produce enough jobs to keep more workers busy.
+		count = std::min(FWorkerPool::NumThreads(), 4);
 	}
+	return clamp(count, 1, 16);
 }
 
+//==========================================================================
+//
+// Merges the output of all worker threads into the draw lists.
+// This happens in job order so that the result is the same
+// as if a single thread had processed all jobs.
+//
+//==========================================================================
 
+void HWDrawInfo::MergeWorkerOutput()
+{
+	for (int i = 0; i < numWorkers; i++)
+	{
+		jobOutputs[i]->counts.AddToThread();
+	}
 
+	int numbatches = jobQueue.NumBatches();
+	for (int b = 0; b < numbatches; b++)
+	{
+		auto &batch = jobQueue.GetBatch(b);
+		auto &output = *jobOutputs[batch.worker];
+		for (int i = 0; i < GLDL_TYPES; i++)
+		{
+			drawlists[i].AddItems(output.drawlists[i], batch.first[i], batch.last[i]);
+		}
+		for (int i = 0; i < 2; i++)
+		{
+			auto &decals = output.Decals[i];
+			for (unsigned d = batch.first[GLDL_TYPES + i]; d < batch.last[GLDL_TYPES + i]; d++)
+			{
+				Decals[i].Push(decals[d]);
+			}
+		}
+	}
+}
 
+ADD_STAT(bspworkers)
+{
+	FString out;
+	out.Format("BSP workers: %d, batches: %d, jobs per worker:", numWorkers, jobQueue.NumBatches());
+	for (int i = 0; i < numWorkers; i++)
+	{
+		out.AppendFormat(" %d", jobOutputs[i]->jobs);
+	}
+	out.AppendFormat("\nBSP = %2.3f, wait = %2.3f, worker = %2.3f", Bsp.TimeMS(), MTWait.TimeMS(), WTTotal.TimeMS());
+	return out;
+}
 
 EXTERN_CVAR(Bool, gl_render_segs)
 
@@ -598,19 +769,18 @@ void HWDrawInfo::RenderThings(subsector_t * sub, sector_t * sector)
 
 void HWDrawInfo::RenderParticles(subsector_t *sub, sector_t *front)
 {
-	SetupSprite.Clock();
-	for (int i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = Level->Particles[i].snext)
+	auto &particles = Level->Particles;
+	for (uint32_t i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = particles.SNext[i])
 	{
 		if (mClipPortal)
 		{
-			int clipres = mClipPortal->ClipPoint(Level->Particles[i].Pos);
+			int clipres = mClipPortal->ClipPoint(DVector2(particles.PosX[i], particles.PosY[i]));
 			if (clipres == PClip_InFront) continue;
 		}
 
 		HWSprite sprite;
-		sprite.ProcessParticle(this, &Level->Particles[i], front);
+		sprite.ProcessParticle(this, particles, i, front);
 	}
-	SetupSprite.Unclock();
 }
 
 
@@ -849,16 +1019,29 @@ void HWDrawInfo::RenderBSP(void *node, bool drawpsprites)
 	multithread = gl_multithread;
 	if (multithread)
 	{
+		numWorkers = GetWorkerCount();
+		while (jobOutputs.Size() < (unsigned)numWorkers) jobOutputs.Push(new RenderJobOutput);
+		for (int i = 0; i < numWorkers; i++)
+		{
+			jobOutputs[i]->Reset();
+			GetWorkerDataAllocator(i);	// must be allocated here, not by the worker.
+		}
+
 		jobQueue.ReleaseAll();
-		auto future = renderPool.push([&](int id) {
-			WorkerThread();
-		});
+		std::vector<FWorkerJobPtr> workers;
+		for (int i = 0; i < numWorkers; i++)
+		{
+			workers.push_back(FWorkerPool::Push([this, i]() {
+				WorkerThread(i);
+			}));
+		}
 		RenderBSPNode(node);
 
-		jobQueue.AddJob(RenderJob::TerminateJob, nullptr, nullptr);
+		jobQueue.Finish();
 		Bsp.Unclock();
 		MTWait.Clock();
-		future.wait();
+		FWorkerPool::WaitAll(workers);
+		MergeWorkerOutput();
 		MTWait.Unclock();
 	}
 	else
@@ -412,8 +412,9 @@ HWPortal * HWDrawInfo::FindPortal(const void * src)
 
 HWDecal *HWDrawInfo::AddDecal(bool onmirror)
 {
-	auto decal = (HWDecal*)RenderDataAllocator.Alloc(sizeof(HWDecal));
-	Decals[onmirror ? 1 : 0].Push(decal);
+	auto decal = (HWDecal*)RenderDataArena->Alloc(sizeof(HWDecal));
+	auto decals = WorkerDecals != nullptr ? WorkerDecals : Decals;
+	decals[onmirror ? 1 : 0].Push(decal);
 	return decal;
 }
 
@@ -732,6 +733,7 @@ void HWDrawInfo::ProcessScene(bool toscreen)
 
 void HWDrawInfo::AddSubsectorToPortal(FSectorPortalGroup *ptg, subsector_t *sub)
 {
+	std::lock_guard<std::mutex> lock(WorkerSharedLock);
 	auto portal = FindPortal(ptg);
 	if (!portal)
 	{
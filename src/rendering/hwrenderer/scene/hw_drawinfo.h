@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <functional>
+#include <mutex>
 #include "vectors.h"
 #include "r_defs.h"
 #include "r_utility.h"
@@ -26,8 +27,14 @@ class HWFlat;
 class HWSprite;
 struct HWDecal;
 class IShadowMap;
-struct particle_t;
+struct FParticles;
 struct FDynLightData;
+
+// The BSP worker threads each collect their output separately. These point to the current thread's lists.
+extern thread_local HWDrawList *WorkerDrawLists;
+extern thread_local TArray<HWDecal *> *WorkerDecals;
+// Guards the portal and missing texture state which all BSP workers share.
+extern std::mutex WorkerSharedLock;
 struct HUDSprite;
 class Clipper;
 class HWPortal;
@@ -188,7 +195,8 @@ private:
 	subsector_t *currentsubsector;	// used by the line processing code.
 	sector_t *currentsector;
 
-	void WorkerThread();
+	void WorkerThread(int worker);
+	void MergeWorkerOutput();
 
 	void UnclipSubsector(subsector_t *sub);
 	
@@ -287,8 +295,8 @@ public:
 	void AddOtherFloorPlane(int sector, gl_subsectorrendernode * node);
 	void AddOtherCeilingPlane(int sector, gl_subsectorrendernode * node);
 
-	void GetDynSpriteLight(AActor *self, float x, float y, float z, FLightNode *node, int portalgroup, float *out);
-	void GetDynSpriteLight(AActor *thing, particle_t *particle, float *out);
+	void GetDynSpriteLight(AActor *self, float x, float y, float z, FSection *section, int portalgroup, float *out);
+	void GetDynSpriteLight(AActor *thing, const FParticles *particles, uint32_t index, float *out);
 
 	void PreparePlayerSprites(sector_t * viewsector, area_t in_area);
 	void PrepareTargeterSprites(double ticfrac);
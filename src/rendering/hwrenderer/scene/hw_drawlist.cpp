@@ -39,10 +39,19 @@
 #include "hw_fakeflat.h"
 
 FMemArena RenderDataAllocator(1024*1024);	// Use large blocks to reduce allocation time.
+static TDeletingArray<FMemArena *> WorkerDataAllocators;	// BSP worker threads each get their own so that they never need to synchronize.
+thread_local FMemArena *RenderDataArena = &RenderDataAllocator;
+
+FMemArena *GetWorkerDataAllocator(unsigned worker)
+{
+	while (WorkerDataAllocators.Size() <= worker) WorkerDataAllocators.Push(new FMemArena(1024*1024));
+	return WorkerDataAllocators[worker];
+}
 
 void ResetRenderDataAllocator()
 {
 	RenderDataAllocator.FreeAll();
+	for (auto arena : WorkerDataAllocators) arena->FreeAll();
 }
 
 //==========================================================================
@@ -512,7 +521,7 @@ void HWDrawList::SortSpriteIntoWall(HWDrawInfo *di, SortNode * head,SortNode * s
 	}
 	else
 	{
-		const bool drawWithXYBillboard = ((ss->particle && gl_billboard_particles) || (!(ss->actor && ss->actor->renderflags & RF_FORCEYBILLBOARD)
+		const bool drawWithXYBillboard = ((ss->particles && gl_billboard_particles) || (!(ss->actor && ss->actor->renderflags & RF_FORCEYBILLBOARD)
 			&& (gl_billboard_mode == 1 || (ss->actor && ss->actor->renderflags & RF_FORCEXYBILLBOARD))));
 
 		const bool drawBillboardFacingCamera = gl_billboard_faces_camera;
@@ -751,7 +760,7 @@ void HWDrawList::SortFlats()
 
 HWWall *HWDrawList::NewWall()
 {
-	auto wall = (HWWall*)RenderDataAllocator.Alloc(sizeof(HWWall));
+	auto wall = (HWWall*)RenderDataArena->Alloc(sizeof(HWWall));
 	drawitems.Push(HWDrawItem(DrawType_WALL, walls.Push(wall)));
 	return wall;
 }
@@ -763,7 +772,7 @@ HWWall *HWDrawList::NewWall()
 //==========================================================================
 HWFlat *HWDrawList::NewFlat()
 {
-	auto flat = (HWFlat*)RenderDataAllocator.Alloc(sizeof(HWFlat));
+	auto flat = (HWFlat*)RenderDataArena->Alloc(sizeof(HWFlat));
 	drawitems.Push(HWDrawItem(DrawType_FLAT,flats.Push(flat)));
 	return flat;
 }
@@ -775,11 +784,39 @@ HWFlat *HWDrawList::NewFlat()
 //==========================================================================
 HWSprite *HWDrawList::NewSprite()
 {	
-	auto sprite = (HWSprite*)RenderDataAllocator.Alloc(sizeof(HWSprite));
+	auto sprite = (HWSprite*)RenderDataArena->Alloc(sizeof(HWSprite));
 	drawitems.Push(HWDrawItem(DrawType_SPRITE, sprites.Push(sprite)));
 	return sprite;
 }
 
+//==========================================================================
+//
+// Appends a range of another list's items to this one.
+// The items themselves are not copied, only the references to them.
+//
+//==========================================================================
+void HWDrawList::AddItems(HWDrawList &src, unsigned first, unsigned last)
+{
+	for (unsigned i = first; i < last; i++)
+	{
+		auto &item = src.drawitems[i];
+		switch (item.rendertype)
+		{
+		case DrawType_WALL:
+			drawitems.Push(HWDrawItem(DrawType_WALL, walls.Push(src.walls[item.index])));
+			break;
+
+		case DrawType_FLAT:
+			drawitems.Push(HWDrawItem(DrawType_FLAT, flats.Push(src.flats[item.index])));
+			break;
+
+		case DrawType_SPRITE:
+			drawitems.Push(HWDrawItem(DrawType_SPRITE, sprites.Push(src.sprites[item.index])));
+			break;
+		}
+	}
+}
+
 //==========================================================================
 //
 //
@@ -3,6 +3,8 @@
 #include "memarena.h"
 
 extern FMemArena RenderDataAllocator;
+extern thread_local FMemArena *RenderDataArena;
+FMemArena *GetWorkerDataAllocator(unsigned worker);
 void ResetRenderDataAllocator();
 struct HWDrawInfo;
 class HWWall;
@@ -90,6 +92,7 @@ public:
 	HWWall *NewWall();
 	HWFlat *NewFlat();
 	HWSprite *NewSprite();
+	void AddItems(HWDrawList &src, unsigned first, unsigned last);
 	void Reset();
 	void SortWalls();
 	void SortFlats();
@@ -39,6 +39,8 @@ EXTERN_CVAR(Bool, gl_seamless)
 
 void HWDrawInfo::AddWall(HWWall *wall)
 {
+	auto drawlists = WorkerDrawLists != nullptr ? WorkerDrawLists : this->drawlists;
+
 	if (wall->flags & HWWall::HWF_TRANSLUCENT)
 	{
 		auto newwall = drawlists[GLDL_TRANSLUCENT].NewWall();
@@ -70,6 +72,8 @@ void HWDrawInfo::AddWall(HWWall *wall)
 
 void HWDrawInfo::AddMirrorSurface(HWWall *w)
 {
+	auto drawlists = WorkerDrawLists != nullptr ? WorkerDrawLists : this->drawlists;
+
 	w->type = RENDERWALL_MIRRORSURFACE;
 	auto newwall = drawlists[GLDL_TRANSLUCENTBORDER].NewWall();
 	*newwall = *w;
@@ -103,6 +107,7 @@ void HWDrawInfo::AddMirrorSurface(HWWall *w)
 
 void HWDrawInfo::AddFlat(HWFlat *flat, bool fog)
 {
+	auto drawlists = WorkerDrawLists != nullptr ? WorkerDrawLists : this->drawlists;
 	int list;
 
 	if (flat->renderstyle != STYLE_Translucent || flat->alpha < 1.f - FLT_EPSILON || fog || flat->texture == nullptr)
@@ -142,6 +147,7 @@ void HWDrawInfo::AddFlat(HWFlat *flat, bool fog)
 //==========================================================================
 void HWDrawInfo::AddSprite(HWSprite *sprite, bool translucent)
 {
+	auto drawlists = WorkerDrawLists != nullptr ? WorkerDrawLists : this->drawlists;
 	int list;
 	// [BB] Allow models to be drawn in the GLDL_TRANSLUCENT pass.
 	if (translucent || sprite->actor == nullptr || (!sprite->modelframe && (sprite->actor->renderflags & RF_SPRITETYPEMASK) != RF_WALLSPRITE))
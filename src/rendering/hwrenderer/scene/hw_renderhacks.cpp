@@ -92,12 +92,12 @@ void HWDrawInfo::DispatchRenderHacks()
 
 static gl_subsectorrendernode *NewSubsectorRenderNode()
 {
-    return (gl_subsectorrendernode*)RenderDataAllocator.Alloc(sizeof(gl_subsectorrendernode));
+    return (gl_subsectorrendernode*)RenderDataArena->Alloc(sizeof(gl_subsectorrendernode));
 }
 
 static gl_floodrendernode *NewFloodRenderNode()
 {
-    return (gl_floodrendernode*)RenderDataAllocator.Alloc(sizeof(gl_floodrendernode));
+    return (gl_floodrendernode*)RenderDataArena->Alloc(sizeof(gl_floodrendernode));
 }
 
 //==========================================================================
@@ -195,6 +195,7 @@ void HWDrawInfo::AddOtherCeilingPlane(int sector, gl_subsectorrendernode * node)
 void HWDrawInfo::AddUpperMissingTexture(side_t * side, subsector_t *sub, float Backheight)
 {
 	if (!side->segs[0]->backsector) return;
+	std::lock_guard<std::mutex> lock(WorkerSharedLock);
 
 	for (int i = 0; i < side->numsegs; i++)
 	{
@@ -255,6 +256,7 @@ void HWDrawInfo::AddLowerMissingTexture(side_t * side, subsector_t *sub, float B
 		if (backsec->transdoorheight == backsec->GetPlaneTexZ(sector_t::floor)) return;
 	}
 
+	std::lock_guard<std::mutex> lock(WorkerSharedLock);
 	// we need to check all segs of this sidedef
 	for (int i = 0; i < side->numsegs; i++)
 	{
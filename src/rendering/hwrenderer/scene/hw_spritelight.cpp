@@ -51,17 +51,19 @@ T smoothstep(const T edge0, const T edge1, const T x)
 //
 //==========================================================================
 
-void HWDrawInfo::GetDynSpriteLight(AActor *self, float x, float y, float z, FLightNode *node, int portalgroup, float *out)
+void HWDrawInfo::GetDynSpriteLight(AActor *self, float x, float y, float z, FSection *section, int portalgroup, float *out)
 {
-	FDynamicLight *light;
 	float frac, lr, lg, lb;
 	float radius;
 	
 	out[0] = out[1] = out[2] = 0.f;
-	// Go through both light lists
-	while (node)
+
+	auto &grid = Level->LightGrid;
+	int sectionindex = Level->sections.SectionIndex(section);
+
+	// gridindex is the light's index in the grid if it still has to be checked for being linked to the section.
+	auto addLight = [&](FDynamicLight *light, int gridindex)
 	{
-		light=node->lightsource;
 		if (light->ShouldLightActor(self))
 		{
 			float dist;
@@ -87,7 +89,7 @@ void HWDrawInfo::GetDynSpriteLight(AActor *self, float x, float y, float z, FLig
 			dist = (float)L.LengthSquared();
 			radius = light->GetRadius();
 
-			if (dist < radius * radius)
+			if (dist < radius * radius && (gridindex < 0 || grid.IsLinkedTo(gridindex, sectionindex)))
 			{
 				dist = sqrtf(dist);	// only calculate the square root if we really need it.
 
@@ -126,25 +128,40 @@ void HWDrawInfo::GetDynSpriteLight(AActor *self, float x, float y, float z, FLig
 				}
 			}
 		}
-		node = node->nextLight;
+	};
+
+	if (grid.IsValid())
+	{
+		// The grid knows which lights can reach this place but not whether they are linked to the section.
+		grid.ForLightsAt(x, y, [&](FDynamicLight *light, unsigned index) { addLight(light, index); });
+	}
+	else
+	{
+		for (FLightNode *node = section->lighthead; node; node = node->nextLight)
+		{
+			addLight(node->lightsource, -1);
+		}
 	}
 }
 
-void HWDrawInfo::GetDynSpriteLight(AActor *thing, particle_t *particle, float *out)
+void HWDrawInfo::GetDynSpriteLight(AActor *thing, const FParticles *particles, uint32_t index, float *out)
 {
 	if (thing != NULL)
 	{
-		GetDynSpriteLight(thing, (float)thing->X(), (float)thing->Y(), (float)thing->Center(), thing->section->lighthead, thing->Sector->PortalGroup, out);
+		GetDynSpriteLight(thing, (float)thing->X(), (float)thing->Y(), (float)thing->Center(), thing->section, thing->Sector->PortalGroup, out);
 	}
-	else if (particle != NULL)
+	else if (particles != NULL)
 	{
-		GetDynSpriteLight(NULL, (float)particle->Pos.X, (float)particle->Pos.Y, (float)particle->Pos.Z, particle->subsector->section->lighthead, particle->subsector->sector->PortalGroup, out);
+		auto subsector = particles->Subsector[index];
+		GetDynSpriteLight(NULL, particles->PosX[index], particles->PosY[index], particles->PosZ[index], subsector->section, subsector->sector->PortalGroup, out);
 	}
 }
 
 // static so that we build up a reserve (memory allocations stop)
 // For multithread processing each worker thread needs its own copy, though.
 static thread_local TArray<FDynamicLight*> addedLightsArray; 
+static thread_local TArray<FSection*> touchedSectionsArray;
+static thread_local FLightGridMarks lightGridMarks;
 
 void hw_GetDynModelLight(AActor *self, FDynLightData &modellightdata)
 {
@@ -163,34 +180,66 @@ void hw_GetDynModelLight(AActor *self, FDynLightData &modellightdata)
 		float radiusSquared = actorradius * actorradius;
 		dl_validcount++;
 
-		BSPWalkCircle(self->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+		auto addLight = [&](FDynamicLight *light, int group)
 		{
-			auto section = subsector->section;
-			if (section->validcount == dl_validcount) return;	// already done from a previous subsector.
-			FLightNode * node = section->lighthead;
-			while (node) // check all lights touching a subsector
+			if (light->ShouldLightActor(self))
 			{
-				FDynamicLight *light = node->lightsource;
-				if (light->ShouldLightActor(self))
+				DVector3 pos = light->PosRelative(group);
+				float radius = (float)(light->GetRadius() + actorradius);
+				double dx = pos.X - x;
+				double dy = pos.Y - y;
+				double dz = pos.Z - z;
+				double distSquared = dx * dx + dy * dy + dz * dz;
+				if (distSquared < radius * radius) // Light and actor touches
 				{
-					int group = subsector->sector->PortalGroup;
-					DVector3 pos = light->PosRelative(group);
-					float radius = (float)(light->GetRadius() + actorradius);
-					double dx = pos.X - x;
-					double dy = pos.Y - y;
-					double dz = pos.Z - z;
-					double distSquared = dx * dx + dy * dy + dz * dz;
-					if (distSquared < radius * radius) // Light and actor touches
+					AddLightToList(modellightdata, group, light, true);
+					addedLights.Push(light);
+					return true;
+				}
+			}
+			return false;
+		};
+
+		auto &grid = self->Level->LightGrid;
+		if (grid.IsValid())
+		{
+			auto &sections = self->Level->sections;
+			auto &touchedSections = touchedSectionsArray;
+			auto &marks = lightGridMarks;
+			marks.Begin(grid.NumLights(), sections.allSections.Size());
+			touchedSections.Clear();
+			BSPWalkCircle(self->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+			{
+				if (marks.MarkSection(sections.SectionIndex(subsector->section))) touchedSections.Push(subsector->section);
+			});
+
+			// Only the lights that can reach the actor need to be checked against the touched sections,
+			// and each of them only once, even if it covers several of the grid cells.
+			grid.ForLightsInBox(x - actorradius, y - actorradius, x + actorradius, y + actorradius, [&](FDynamicLight *light, unsigned index)
+			{
+				if (!marks.MarkLight(index)) return;
+				for (auto section : touchedSections)
+				{
+					if (grid.IsLinkedTo(index, sections.SectionIndex(section)) && addLight(light, section->sector->PortalGroup)) break;
+				}
+			});
+		}
+		else
+		{
+			BSPWalkCircle(self->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+			{
+				auto section = subsector->section;
+				if (section->validcount == dl_validcount) return;	// already done from a previous subsector.
+				FLightNode * node = section->lighthead;
+				while (node) // check all lights touching a subsector
+				{
+					if (std::find(addedLights.begin(), addedLights.end(), node->lightsource) == addedLights.end()) // Check if we already added this light from a different subsector
 					{
-						if (std::find(addedLights.begin(), addedLights.end(), light) == addedLights.end()) // Check if we already added this light from a different subsector
-						{
-							AddLightToList(modellightdata, group, light, true);
-							addedLights.Push(light);
-						}
+						addLight(node->lightsource, subsector->sector->PortalGroup);
 					}
+					node = node->nextLight;
 				}
-				node = node->nextLight;
-			}
-		});
+			});
+		}
 	}
 }
@@ -169,11 +169,11 @@ void HWSprite::DrawSprite(HWDrawInfo *di, FRenderState &state, bool translucent)
 			if (dynlightindex == -1)	// only set if we got no light buffer index. This covers all cases where sprite lighting is used.
 			{
 				float out[3] = {};
-				di->GetDynSpriteLight(gl_light_sprites ? actor : nullptr, gl_light_particles ? particle : nullptr, out);
+				di->GetDynSpriteLight(gl_light_sprites ? actor : nullptr, gl_light_particles ? particles : nullptr, particleindex, out);
 				state.SetDynLight(out[0], out[1], out[2]);
 			}
 		}
-		sector_t *cursec = actor ? actor->Sector : particle ? particle->subsector->sector : nullptr;
+		sector_t *cursec = actor ? actor->Sector : particles ? particles->Subsector[particleindex]->sector : nullptr;
 		if (cursec != nullptr)
 		{
 			const PalEntry finalcol = fullbright
@@ -373,7 +373,7 @@ bool HWSprite::CalculateVertices(HWDrawInfo *di, FVector3 *v, DVector3 *vp)
 	}
 	
 	// [BB] Billboard stuff
-	const bool drawWithXYBillboard = ((particle && gl_billboard_particles) || (!(actor && actor->renderflags & RF_FORCEYBILLBOARD)
+	const bool drawWithXYBillboard = ((particles && gl_billboard_particles) || (!(actor && actor->renderflags & RF_FORCEYBILLBOARD)
 		//&& di->mViewActor != nullptr
 		&& (gl_billboard_mode == 1 || (actor && actor->renderflags & RF_FORCEXYBILLBOARD))));
 
@@ -1153,7 +1153,7 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 		index = -1;
 	}
 
-	particle = nullptr;
+	particles = nullptr;
 
 	const bool drawWithXYBillboard = (!(actor->renderflags & RF_FORCEYBILLBOARD)
 		&& (actor->renderflags & RF_SPRITETYPEMASK) == RF_FACESPRITE
@@ -1198,9 +1198,11 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 //
 //==========================================================================
 
-void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *sector)//, int shade, int fakeside)
+void HWSprite::ProcessParticle (HWDrawInfo *di, const FParticles &particles, uint32_t index, sector_t *sector)//, int shade, int fakeside)
 {
-	if (particle->alpha==0) return;
+	if (particles.Alpha[index]==0) return;
+
+	DVector3 pos = particles.Pos(index);
 
 	lightlevel = hw_ClampLight(sector->GetTexture(sector_t::ceiling) == skyflatnum ? 
 		sector->GetCeilingLight() : sector->GetFloorLight());
@@ -1210,7 +1212,7 @@ void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *
 	{
 		Colormap.Clear();
 	}
-	else if (!particle->bright)
+	else if (!particles.Bright[index])
 	{
 		TArray<lightlist_t> & lightlist=sector->e->XFloor.lightlist;
 		double lightbottom;
@@ -1218,10 +1220,10 @@ void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *
 		Colormap = sector->Colormap;
 		for(unsigned int i=0;i<lightlist.Size();i++)
 		{
-			if (i<lightlist.Size()-1) lightbottom = lightlist[i+1].plane.ZatPoint(particle->Pos);
-			else lightbottom = sector->floorplane.ZatPoint(particle->Pos);
+			if (i<lightlist.Size()-1) lightbottom = lightlist[i+1].plane.ZatPoint(pos);
+			else lightbottom = sector->floorplane.ZatPoint(pos);
 
-			if (lightbottom < particle->Pos.Z)
+			if (lightbottom < pos.Z)
 			{
 				lightlevel = hw_ClampLight(*lightlist[i].p_lightlevel);
 				Colormap.CopyLight(lightlist[i].extra_colormap);
@@ -1240,11 +1242,11 @@ void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *
 		Colormap.ClearColor();
 	}
 
-	trans=particle->alpha;
+	trans=particles.Alpha[index];
 	RenderStyle = STYLE_Translucent;
 	OverrideShader = 0;
 
-	ThingColor = particle->color;
+	ThingColor = particles.Color[index];
 	ThingColor.a = 255;
 
 	modelframe=nullptr;
@@ -1284,19 +1286,19 @@ void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *
 	double timefrac = vp.TicFrac;
 	if (paused || di->Level->isFrozen())
 		timefrac = 0.;
-	float xvf = (particle->Vel.X) * timefrac;
-	float yvf = (particle->Vel.Y) * timefrac;
-	float zvf = (particle->Vel.Z) * timefrac;
+	float xvf = (particles.VelX[index]) * timefrac;
+	float yvf = (particles.VelY[index]) * timefrac;
+	float zvf = (particles.VelZ[index]) * timefrac;
 
-	x = float(particle->Pos.X) + xvf;
-	y = float(particle->Pos.Y) + yvf;
-	z = float(particle->Pos.Z) + zvf;
+	x = particles.PosX[index] + xvf;
+	y = particles.PosY[index] + yvf;
+	z = particles.PosZ[index] + zvf;
 	
 	float factor;
 	if (gl_particles_style == 1) factor = 1.3f / 7.f;
 	else if (gl_particles_style == 2) factor = 2.5f / 7.f;
 	else factor = 1 / 7.f;
-	float scalefac=particle->size * factor;
+	float scalefac=particles.Size[index] * factor;
 
 	float viewvecX = vp.ViewVector.X;
 	float viewvecY = vp.ViewVector.Y;
@@ -1311,8 +1313,9 @@ void HWSprite::ProcessParticle (HWDrawInfo *di, particle_t *particle, sector_t *
 	depth = (float)((x - vp.Pos.X) * vp.TanCos + (y - vp.Pos.Y) * vp.TanSin);
 
 	actor=nullptr;
-	this->particle=particle;
-	fullbright = !!particle->bright;
+	this->particles=&particles;
+	particleindex=index;
+	fullbright = !!particles.Bright[index];
 	
 	// [BB] Translucent particles have to be rendered without the alpha test.
 	if (gl_particles_style != 2 && trans>=1.0f-FLT_EPSILON) hw_styleflags = STYLEHW_Solid;
@@ -567,6 +567,7 @@ void HWWall::PutPortal(HWDrawInfo *di, int ptype, int plane)
 	HWPortal * portal = nullptr;
 
 	MakeVertices(di, false);
+	std::lock_guard<std::mutex> lock(WorkerSharedLock);
 	switch (ptype)
 	{
 		// portals don't go into the draw list.
@@ -635,7 +635,7 @@ void HWDrawInfo::PreparePlayerSprites(sector_t * viewsector, area_t in_area)
 		{
 			if (!hudModelStep)
 			{
-				GetDynSpriteLight(playermo, nullptr, hudsprite.dynrgb);
+				GetDynSpriteLight(playermo, nullptr, 0, hudsprite.dynrgb);
 			}
 			else
 			{
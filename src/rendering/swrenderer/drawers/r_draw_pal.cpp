@@ -167,6 +167,12 @@ namespace swrenderer
 
 		if (num_dynlights == 0)
 		{
+			// The vector lookups read whole dwords, so the column must have at least four texels.
+			if (args.TextureHeight() >= 4)
+			{
+				kernels->Column(dest, count, pitch, source, colormap, frac, fracstep, bits);
+				return;
+			}
 			do
 			{
 				*dest = colormap[source[frac >> bits]];
@@ -821,6 +827,12 @@ namespace swrenderer
 		uint32_t dynlight = args.DynamicLight();
 		if (dynlight == 0)
 		{
+			// The vector lookups need four bytes of texture, which is certain if the last texel read is the fourth or later.
+			if (frac >= 0 && fracstep >= 0 && ((uint32_t)frac + (uint32_t)fracstep * (count - 1)) >> FRACBITS >= 3)
+			{
+				kernels->Column(dest, count, pitch, source, colormap, frac, fracstep, FRACBITS);
+				return;
+			}
 			do
 			{
 				*dest = colormap[source[frac >> FRACBITS]];
@@ -1866,19 +1878,11 @@ namespace swrenderer
 		if (_srcwidth == 64 && _srcheight == 64 && num_dynlights == 0)
 		{
 			// 64x64 is the most common case by far, so special case it.
-			do
-			{
-				// Current texture index in u,v.
-				spot = ((xfrac >> (32 - 6 - 6))&(63 * 64)) + (yfrac >> (32 - 6));
-
-				// Lookup pixel from flat texture tile,
-				//  re-index using light/colormap.
-				*dest++ = colormap[source[spot]];
-
-				// Next step in u,v.
-				xfrac += xstep;
-				yfrac += ystep;
-			} while (--count);
+			kernels->Span64(dest, count, source, colormap, xfrac, yfrac, xstep, ystep);
+		}
+		else if (num_dynlights == 0 && _srcwidth * _srcheight >= 4)
+		{
+			kernels->Span(dest, count, source, colormap, xfrac, yfrac, xstep, ystep, _srcwidth, _srcheight);
 		}
 		else if (_srcwidth == 64 && _srcheight == 64)
 		{
@@ -9,6 +9,7 @@
 #include "swrenderer/viewport/r_walldrawer.h"
 #include "swrenderer/viewport/r_spritedrawer.h"
 #include "swrenderer/r_swcolormaps.h"
+#include "r_draw_pal_simd.h"
 
 struct FSWColormap;
 
@@ -183,5 +184,7 @@ namespace swrenderer
 		const uint8_t* tiltlighting[MAXWIDTH];
 
 		WallColumnDrawerArgs wallcolargs;
+
+		const PalDrawerKernels* kernels = GetPalDrawerKernels();
 	};
 }
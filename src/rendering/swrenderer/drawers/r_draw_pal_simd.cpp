@@ -0,0 +1,378 @@
+/*
+** r_draw_pal_simd.cpp
+** Vectorized inner loops for the paletted drawers
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 The GZDoom developers
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Every pixel of a paletted drawer is two dependent table lookups, first
+** the texel and then its colormap entry. SSE2 can only calculate the
+** texture coordinates of several pixels at once. AVX2 can also do the
+** lookups with gathers, so that version gets picked at runtime if the
+** CPU supports it, even though the rest of the engine is not compiled
+** for AVX2.
+**
+** The wall and sprite columns write one byte per screen row, so only the
+** AVX2 version does anything but the plain loop for them. It does the
+** lookups for eight rows at once and then stores the bytes one by one.
+**
+*/
+
+#include <chrono>
+#include <string.h>
+
+#ifndef NO_SSE
+#include <immintrin.h>
+#endif
+
+#include "r_draw_pal_simd.h"
+#include "x86.h"
+#include "c_dispatch.h"
+#include "printf.h"
+#include "m_random.h"
+#include "tarray.h"
+#include "templates.h"
+
+namespace swrenderer
+{
+	//==========================================================================
+	//
+	// Plain C
+	//
+	//==========================================================================
+
+	static void DrawSpan64_C(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+	{
+		do
+		{
+			int spot = ((xfrac >> (32 - 6 - 6)) & (63 * 64)) + (yfrac >> (32 - 6));
+			*dest++ = colormap[source[spot]];
+			xfrac += xstep;
+			yfrac += ystep;
+		} while (--count);
+	}
+
+	static void DrawSpan_C(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep, uint32_t srcwidth, uint32_t srcheight)
+	{
+		do
+		{
+			int spot = (((xfrac >> 16) * srcwidth) >> 16) * srcheight + (((yfrac >> 16) * srcheight) >> 16);
+			*dest++ = colormap[source[spot]];
+			xfrac += xstep;
+			yfrac += ystep;
+		} while (--count);
+	}
+
+	static void DrawColumn_C(uint8_t *dest, int count, int pitch, const uint8_t *source, const uint8_t *colormap, uint32_t frac, uint32_t fracstep, int bits)
+	{
+		do
+		{
+			*dest = colormap[source[frac >> bits]];
+			frac += fracstep;
+			dest += pitch;
+		} while (--count);
+	}
+
+	static const PalDrawerKernels KernelsC = { "C", DrawSpan64_C, DrawSpan_C, DrawColumn_C };
+
+#ifndef NO_SSE
+
+	//==========================================================================
+	//
+	// SSE2
+	//
+	//==========================================================================
+
+	static void DrawSpan64_SSE2(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+	{
+		int blocks = count >> 2;
+		if (blocks > 0)
+		{
+			__m128i xf = _mm_add_epi32(_mm_set1_epi32(xfrac), _mm_setr_epi32(0, xstep, xstep * 2, xstep * 3));
+			__m128i yf = _mm_add_epi32(_mm_set1_epi32(yfrac), _mm_setr_epi32(0, ystep, ystep * 2, ystep * 3));
+			__m128i xstep4 = _mm_set1_epi32(xstep * 4);
+			__m128i ystep4 = _mm_set1_epi32(ystep * 4);
+			__m128i xmask = _mm_set1_epi32(63 * 64);
+
+			for (int i = 0; i < blocks; i++)
+			{
+				alignas(16) uint32_t spot[4];
+				_mm_store_si128((__m128i *)spot, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(xf, 32 - 6 - 6), xmask), _mm_srli_epi32(yf, 32 - 6)));
+				uint32_t out = colormap[source[spot[0]]] | (colormap[source[spot[1]]] << 8) | (colormap[source[spot[2]]] << 16) | (colormap[source[spot[3]]] << 24);
+				memcpy(dest, &out, 4);
+				dest += 4;
+				xf = _mm_add_epi32(xf, xstep4);
+				yf = _mm_add_epi32(yf, ystep4);
+			}
+			xfrac += xstep * (blocks * 4);
+			yfrac += ystep * (blocks * 4);
+			count &= 3;
+		}
+		if (count > 0) DrawSpan64_C(dest, count, source, colormap, xfrac, yfrac, xstep, ystep);
+	}
+
+	// SSE2 has no 32 bit multiply, but the even lanes can be multiplied to 64 bit results.
+	static inline __m128i MulLo32_SSE2(__m128i a, __m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	static void DrawSpan_SSE2(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep, uint32_t srcwidth, uint32_t srcheight)
+	{
+		int blocks = count >> 2;
+		if (blocks > 0)
+		{
+			__m128i xf = _mm_add_epi32(_mm_set1_epi32(xfrac), _mm_setr_epi32(0, xstep, xstep * 2, xstep * 3));
+			__m128i yf = _mm_add_epi32(_mm_set1_epi32(yfrac), _mm_setr_epi32(0, ystep, ystep * 2, ystep * 3));
+			__m128i xstep4 = _mm_set1_epi32(xstep * 4);
+			__m128i ystep4 = _mm_set1_epi32(ystep * 4);
+			__m128i width = _mm_set1_epi32(srcwidth);
+			__m128i height = _mm_set1_epi32(srcheight);
+
+			for (int i = 0; i < blocks; i++)
+			{
+				__m128i u = _mm_srli_epi32(MulLo32_SSE2(_mm_srli_epi32(xf, 16), width), 16);
+				__m128i v = _mm_srli_epi32(MulLo32_SSE2(_mm_srli_epi32(yf, 16), height), 16);
+				alignas(16) uint32_t spot[4];
+				_mm_store_si128((__m128i *)spot, _mm_add_epi32(MulLo32_SSE2(u, height), v));
+				uint32_t out = colormap[source[spot[0]]] | (colormap[source[spot[1]]] << 8) | (colormap[source[spot[2]]] << 16) | (colormap[source[spot[3]]] << 24);
+				memcpy(dest, &out, 4);
+				dest += 4;
+				xf = _mm_add_epi32(xf, xstep4);
+				yf = _mm_add_epi32(yf, ystep4);
+			}
+			xfrac += xstep * (blocks * 4);
+			yfrac += ystep * (blocks * 4);
+			count &= 3;
+		}
+		if (count > 0) DrawSpan_C(dest, count, source, colormap, xfrac, yfrac, xstep, ystep, srcwidth, srcheight);
+	}
+
+	static const PalDrawerKernels KernelsSSE2 = { "SSE2", DrawSpan64_SSE2, DrawSpan_SSE2, DrawColumn_C };
+
+	//==========================================================================
+	//
+	// AVX2
+	//
+	//==========================================================================
+
+	// Looks up eight bytes. The gather reads the dword that ends with the wanted
+	// byte, or the first one of the table for the first three bytes, so it never
+	// reads past the highest index or before the table. The table must have at
+	// least four bytes.
+	AVX2_TARGET static inline __m256i GatherBytes_AVX2(const uint8_t *base, __m256i index)
+	{
+		__m256i offset = _mm256_max_epi32(_mm256_sub_epi32(index, _mm256_set1_epi32(3)), _mm256_setzero_si256());
+		__m256i dwords = _mm256_i32gather_epi32((const int *)base, offset, 1);
+		__m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(index, offset), 3);
+		return _mm256_and_si256(_mm256_srlv_epi32(dwords, shift), _mm256_set1_epi32(0xff));
+	}
+
+	AVX2_TARGET static inline void StoreBytes_AVX2(uint8_t *dest, __m256i values)
+	{
+		__m128i words = _mm_packus_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+		_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(words, words));
+	}
+
+	AVX2_TARGET static inline __m256i Steps_AVX2(uint32_t start, uint32_t step)
+	{
+		return _mm256_add_epi32(_mm256_set1_epi32(start), _mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+	}
+
+	AVX2_TARGET static void DrawSpan64_AVX2(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep)
+	{
+		int blocks = count >> 3;
+		if (blocks > 0)
+		{
+			__m256i xf = Steps_AVX2(xfrac, xstep);
+			__m256i yf = Steps_AVX2(yfrac, ystep);
+			__m256i xstep8 = _mm256_set1_epi32(xstep * 8);
+			__m256i ystep8 = _mm256_set1_epi32(ystep * 8);
+			__m256i xmask = _mm256_set1_epi32(63 * 64);
+
+			for (int i = 0; i < blocks; i++)
+			{
+				__m256i spot = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(xf, 32 - 6 - 6), xmask), _mm256_srli_epi32(yf, 32 - 6));
+				StoreBytes_AVX2(dest, GatherBytes_AVX2(colormap, GatherBytes_AVX2(source, spot)));
+				dest += 8;
+				xf = _mm256_add_epi32(xf, xstep8);
+				yf = _mm256_add_epi32(yf, ystep8);
+			}
+			xfrac += xstep * (blocks * 8);
+			yfrac += ystep * (blocks * 8);
+			count &= 7;
+		}
+		if (count > 0) DrawSpan64_C(dest, count, source, colormap, xfrac, yfrac, xstep, ystep);
+	}
+
+	AVX2_TARGET static void DrawSpan_AVX2(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep, uint32_t srcwidth, uint32_t srcheight)
+	{
+		int blocks = count >> 3;
+		if (blocks > 0)
+		{
+			__m256i xf = Steps_AVX2(xfrac, xstep);
+			__m256i yf = Steps_AVX2(yfrac, ystep);
+			__m256i xstep8 = _mm256_set1_epi32(xstep * 8);
+			__m256i ystep8 = _mm256_set1_epi32(ystep * 8);
+			__m256i width = _mm256_set1_epi32(srcwidth);
+			__m256i height = _mm256_set1_epi32(srcheight);
+
+			for (int i = 0; i < blocks; i++)
+			{
+				__m256i u = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(xf, 16), width), 16);
+				__m256i v = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(yf, 16), height), 16);
+				__m256i spot = _mm256_add_epi32(_mm256_mullo_epi32(u, height), v);
+				StoreBytes_AVX2(dest, GatherBytes_AVX2(colormap, GatherBytes_AVX2(source, spot)));
+				dest += 8;
+				xf = _mm256_add_epi32(xf, xstep8);
+				yf = _mm256_add_epi32(yf, ystep8);
+			}
+			xfrac += xstep * (blocks * 8);
+			yfrac += ystep * (blocks * 8);
+			count &= 7;
+		}
+		if (count > 0) DrawSpan_C(dest, count, source, colormap, xfrac, yfrac, xstep, ystep, srcwidth, srcheight);
+	}
+
+	AVX2_TARGET static void DrawColumn_AVX2(uint8_t *dest, int count, int pitch, const uint8_t *source, const uint8_t *colormap, uint32_t frac, uint32_t fracstep, int bits)
+	{
+		int blocks = count >> 3;
+		if (blocks > 0)
+		{
+			__m256i f = Steps_AVX2(frac, fracstep);
+			__m256i step8 = _mm256_set1_epi32(fracstep * 8);
+			__m128i shift = _mm_cvtsi32_si128(bits);
+
+			for (int i = 0; i < blocks; i++)
+			{
+				alignas(32) uint32_t out[8];
+				_mm256_store_si256((__m256i *)out, GatherBytes_AVX2(colormap, GatherBytes_AVX2(source, _mm256_srl_epi32(f, shift))));
+				for (int j = 0; j < 8; j++)
+				{
+					*dest = (uint8_t)out[j];
+					dest += pitch;
+				}
+				f = _mm256_add_epi32(f, step8);
+			}
+			frac += fracstep * (blocks * 8);
+			count &= 7;
+		}
+		if (count > 0) DrawColumn_C(dest, count, pitch, source, colormap, frac, fracstep, bits);
+	}
+
+	static const PalDrawerKernels KernelsAVX2 = { "AVX2", DrawSpan64_AVX2, DrawSpan_AVX2, DrawColumn_AVX2 };
+
+#endif
+
+	const PalDrawerKernels *GetPalDrawerKernels()
+	{
+#ifndef NO_SSE
+		if (CPU.bAVX2) return &KernelsAVX2;
+		return &KernelsSSE2;
+#else
+		return &KernelsC;
+#endif
+	}
+
+	//==========================================================================
+	//
+	// CCMD bench_paldrawers
+	//
+	// Runs each kernel set over full screens of spans and columns and reports
+	// the time per pixel, after making sure they all match the C version.
+	//
+	//==========================================================================
+
+	CCMD(bench_paldrawers)
+	{
+		int iterations = argv.argc() > 1 ? clamp(atoi(argv[1]), 1, 100000) : 1000;
+
+		const PalDrawerKernels *sets[] = {
+			&KernelsC,
+#ifndef NO_SSE
+			&KernelsSSE2,
+			CPU.bAVX2 ? &KernelsAVX2 : nullptr,
+#endif
+		};
+
+		const int width = 640, height = 400, texsize = 128 * 128;
+		TArray<uint8_t> texture(texsize, true), colormap(256, true), reference(width * height, true), dest(width * height, true);
+		FRandom rng;	// unnamed, so that it stays out of the savegames
+		for (auto &p : texture) p = rng();
+		for (int i = 0; i < 256; i++) colormap[i] = uint8_t(255 - i);
+
+		// Flats: a full screen of horizontal spans in a 64x64 texture, and in a 128x128 one.
+		auto spans64 = [&](const PalDrawerKernels *k, uint8_t *out)
+		{
+			for (uint32_t y = 0; y < height; y++)
+				k->Span64(out + y * width, width, texture.Data(), colormap.Data(), y << 22, y << 24, 0x01234567, 0x00765432);
+		};
+		auto spans = [&](const PalDrawerKernels *k, uint8_t *out)
+		{
+			for (uint32_t y = 0; y < height; y++)
+				k->Span(out + y * width, width, texture.Data(), colormap.Data(), y << 22, y << 24, 0x01234567, 0x00765432, 128, 128);
+		};
+
+		// Walls: full screen columns of a 128 pixel high texture that wraps around.
+		// Sprites: the same, but scaled to fit the screen height exactly.
+		auto walls = [&](const PalDrawerKernels *k, uint8_t *out)
+		{
+			for (uint32_t x = 0; x < width; x++)
+				k->Column(out + x, height, width, texture.Data() + (x & 127) * 128, colormap.Data(), x << 20, 0x00e38e38, 32 - 7);
+		};
+		auto sprites = [&](const PalDrawerKernels *k, uint8_t *out)
+		{
+			for (uint32_t x = 0; x < width; x++)
+				k->Column(out + x, height, width, texture.Data() + (x & 127) * 128, colormap.Data(), 0, (128 << 16) / height, 16);
+		};
+
+		auto run = [&](const char *name, auto &&drawer)
+		{
+			drawer(&KernelsC, reference.Data());
+			for (auto k : sets)
+			{
+				if (k == nullptr) continue;
+				drawer(k, dest.Data());
+				bool match = memcmp(dest.Data(), reference.Data(), dest.Size()) == 0;
+
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < iterations; i++) drawer(k, dest.Data());
+				double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				Printf("%-8s %-5s %8.3f ms, %6.3f ns/pixel%s\n", name, k->Name, ms, ms * 1e6 / (double(iterations) * width * height), match ? "" : TEXTCOLOR_RED " (mismatch)");
+			}
+		};
+
+		run("Span64", spans64);
+		run("Span", spans);
+		run("Wall", walls);
+		run("Sprite", sprites);
+	}
+}
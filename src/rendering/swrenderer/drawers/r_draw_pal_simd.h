@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace swrenderer
+{
+	// Inner loops of the paletted span, wall and sprite drawers for the case
+	// without dynamic lights. There is one set for each instruction set; all
+	// of them produce exactly the same output. The texture must have at least
+	// four bytes.
+	struct PalDrawerKernels
+	{
+		const char *Name;
+		void (*Span64)(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep);
+		void (*Span)(uint8_t *dest, int count, const uint8_t *source, const uint8_t *colormap, uint32_t xfrac, uint32_t yfrac, uint32_t xstep, uint32_t ystep, uint32_t srcwidth, uint32_t srcheight);
+		void (*Column)(uint8_t *dest, int count, int pitch, const uint8_t *source, const uint8_t *colormap, uint32_t frac, uint32_t fracstep, int bits);
+	};
+
+	// Returns the fastest set the CPU supports.
+	const PalDrawerKernels *GetPalDrawerKernels();
+}
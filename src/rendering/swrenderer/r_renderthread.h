@@ -24,10 +24,12 @@
 
 #include <memory>
 #include <thread>
+#include "r_data/r_lightgrid.h"
 
 class RenderMemory;
 class PolyTriangleThreadData;
 struct FDynamicLight;
+struct FSection;
 
 EXTERN_CVAR(Bool, r_models);
 extern bool r_modelscene;
@@ -62,6 +64,7 @@ namespace swrenderer
 		int X1 = 0;
 		int X2 = MAXWIDTH;
 		bool MainThread = false;
+		double SliceTime = 0;	// milliseconds spent on the last slice, used to balance the next frame's slices
 
 		std::unique_ptr<RenderMemory> FrameMemory;
 		std::unique_ptr<RenderOpaquePass> OpaquePass;
@@ -78,6 +81,8 @@ namespace swrenderer
 		std::unique_ptr<PolyTriangleThreadData> Poly;
 
 		TArray<FDynamicLight*> AddedLightsArray;
+		TArray<FSection*> TouchedSectionsArray;
+		FLightGridMarks LightGridMarks;
 
 		std::thread thread;
 
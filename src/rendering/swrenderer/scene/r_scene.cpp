@@ -67,6 +67,7 @@ EXTERN_CVAR(Int, r_clearbuffer)
 EXTERN_CVAR(Int, r_debug_draw)
 
 CVAR(Int, r_scene_multithreaded, 1, 0);
+CVAR(Bool, r_scene_adaptiveslices, true, 0);
 CVAR(Bool, r_models, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 
 bool r_modelscene = false;
@@ -74,6 +75,7 @@ bool r_modelscene = false;
 namespace swrenderer
 {
 	cycle_t WallCycles, PlaneCycles, MaskedCycles;
+	static RenderScene *StatScene;	// the scene that last rendered with threads, for the scenethreads stat
 	
 	RenderScene::RenderScene()
 	{
@@ -83,6 +85,7 @@ namespace swrenderer
 	RenderScene::~RenderScene()
 	{
 		StopThreads();
+		if (StatScene == this) StatScene = nullptr;
 	}
 
 	void RenderScene::SetClearColor(int color)
@@ -209,14 +212,17 @@ namespace swrenderer
 			StartThreads(numThreads);
 		}
 
+		UpdateSliceEdges(numThreads);
+		StatScene = this;
+
 		// Setup threads:
 		std::unique_lock<std::mutex> start_lock(start_mutex);
 		for (int i = 0; i < numThreads; i++)
 		{
 			*Threads[i]->Viewport = *MainThread()->Viewport;
 			*Threads[i]->Light = *MainThread()->Light;
-			Threads[i]->X1 = viewwidth * i / numThreads;
-			Threads[i]->X2 = viewwidth * (i + 1) / numThreads;
+			Threads[i]->X1 = SliceEdges[i];
+			Threads[i]->X2 = SliceEdges[i + 1];
 		}
 		run_id++;
 		FSoftwareTexture::CurrentUpdate = run_id;
@@ -254,8 +260,70 @@ namespace swrenderer
 		MainThread()->X2 = viewwidth;
 	}
 
+	//==========================================================================
+	//
+	// Places the slice edges for this frame. Assuming that each slice's
+	// cost in the last frame was spread evenly across its columns, the edges
+	// move to where every thread gets the same share of the total. They only
+	// go halfway there each frame so that they don't oscillate.
+	//
+	//==========================================================================
+
+	void RenderScene::UpdateSliceEdges(int numThreads)
+	{
+		bool adapt = r_scene_adaptiveslices && numThreads > 1 && viewwidth >= numThreads * 16 &&
+			SliceEdges.size() == (size_t)numThreads + 1 && SliceEdges.back() == viewwidth;
+
+		double total = 0;
+		if (adapt)
+		{
+			for (int i = 0; i < numThreads; i++)
+				total += Threads[i]->SliceTime;
+			adapt = total > 0;
+		}
+
+		if (!adapt)
+		{
+			SliceEdges.resize(numThreads + 1);
+			for (int i = 0; i <= numThreads; i++)
+				SliceEdges[i] = viewwidth * i / numThreads;
+			return;
+		}
+
+		std::vector<int> edges(numThreads + 1);
+		edges[0] = 0;
+		edges[numThreads] = viewwidth;
+		int slice = 0;
+		double before = 0; // time spent left of the current slice
+		for (int i = 1; i < numThreads; i++)
+		{
+			double target = total * i / numThreads;
+			while (slice < numThreads - 1 && before + Threads[slice]->SliceTime < target)
+			{
+				before += Threads[slice]->SliceTime;
+				slice++;
+			}
+			double time = Threads[slice]->SliceTime;
+			double frac = time > 0 ? clamp((target - before) / time, 0.0, 1.0) : 0.5;
+			double x = SliceEdges[slice] + frac * (SliceEdges[slice + 1] - SliceEdges[slice]);
+			edges[i] = xs_RoundToInt((SliceEdges[i] + x) * 0.5);
+		}
+
+		// Keep a minimum width so that no thread's share can collapse to nothing.
+		int minwidth = viewwidth / (numThreads * 8);
+		for (int i = 1; i < numThreads; i++)
+			edges[i] = std::max(edges[i], edges[i - 1] + minwidth);
+		for (int i = numThreads - 1; i > 0; i--)
+			edges[i] = std::min(edges[i], edges[i + 1] - minwidth);
+		SliceEdges = std::move(edges);
+	}
+
 	void RenderScene::RenderThreadSlice(RenderThread *thread)
 	{
+		cycle_t timer;
+		timer.Reset();
+		timer.Clock();
+
 		thread->FrameMemory->Clear();
 		thread->Clip3D->Cleanup();
 		thread->Clip3D->ResetClip(); // reset clips (floor/ceiling)
@@ -325,6 +393,8 @@ namespace swrenderer
 			}
 		}
 #endif
+		timer.Unclock();
+		thread->SliceTime = timer.TimeMS();
 	}
 
 	void RenderScene::StartThreads(size_t numThreads)
@@ -455,6 +525,33 @@ namespace swrenderer
 		return out;
 	}
 
+	FString RenderScene::GetSliceStats() const
+	{
+		FString out;
+		if (Threads.size() < 2 || SliceEdges.size() != Threads.size() + 1)
+		{
+			out = "single threaded";
+			return out;
+		}
+		double total = 0, busiest = 0;
+		for (size_t i = 0; i < Threads.size(); i++)
+		{
+			double time = Threads[i]->SliceTime;
+			out.AppendFormat("%s%d: %d cols %.2f ms", i > 0 ? "  " : "", (int)i, SliceEdges[i + 1] - SliceEdges[i], time);
+			total += time;
+			busiest = std::max(busiest, time);
+		}
+		// How much of the slowest thread's time the others spent waiting for it
+		out.AppendFormat("\nidle %.0f%%", busiest > 0 ? 100 * (1 - total / (busiest * Threads.size())) : 0.);
+		return out;
+	}
+
+	ADD_STAT(scenethreads)
+	{
+		if (StatScene == nullptr) return FString("not rendering");
+		return StatScene->GetSliceStats();
+	}
+
 	static double bestwallcycles = HUGE_VAL;
 
 	ADD_STAT(wallcycles)
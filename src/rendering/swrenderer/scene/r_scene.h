@@ -57,10 +57,13 @@ namespace swrenderer
 
 		RenderThread *MainThread() { return Threads.front().get(); }
 
+		FString GetSliceStats() const;
+
 	private:
 		void RenderActorView(AActor *actor,bool renderplayersprite, bool dontmaplines);
 		void RenderThreadSlices();
 		void RenderThreadSlice(RenderThread *thread);
+		void UpdateSliceEdges(int numThreads);
 		void RenderPSprites();
 
 		void StartThreads(size_t numThreads);
@@ -78,5 +81,6 @@ namespace swrenderer
 		std::mutex end_mutex;
 		std::condition_variable end_condition;
 		size_t finished_threads = 0;
+		std::vector<int> SliceEdges;
 	};
 }
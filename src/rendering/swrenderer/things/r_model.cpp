@@ -174,32 +174,64 @@ namespace swrenderer
 			float actorradius = (float)actor->RenderRadius();
 			float radiusSquared = actorradius * actorradius;
 
-			BSPWalkCircle(actor->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+			auto addLight = [&](FDynamicLight *light, int group)
 			{
-				FLightNode * node = subsector->section->lighthead;
-				while (node) // check all lights touching a subsector
+				if (light->ShouldLightActor(actor))
 				{
-					FDynamicLight *light = node->lightsource;
-					if (light->ShouldLightActor(actor))
+					DVector3 pos = light->PosRelative(group);
+					float radius = (float)(light->GetRadius() + actorradius);
+					double dx = pos.X - x;
+					double dy = pos.Y - y;
+					double dz = pos.Z - z;
+					double distSquared = dx * dx + dy * dy + dz * dz;
+					if (distSquared < radius * radius) // Light and actor touches
 					{
-						int group = subsector->sector->PortalGroup;
-						DVector3 pos = light->PosRelative(group);
-						float radius = (float)(light->GetRadius() + actorradius);
-						double dx = pos.X - x;
-						double dy = pos.Y - y;
-						double dz = pos.Z - z;
-						double distSquared = dx * dx + dy * dy + dz * dz;
-						if (distSquared < radius * radius) // Light and actor touches
+						addedLights.Push(light);
+						return true;
+					}
+				}
+				return false;
+			};
+
+			auto &grid = actor->Level->LightGrid;
+			if (grid.IsValid())
+			{
+				auto &sections = actor->Level->sections;
+				auto &touchedSections = Thread->TouchedSectionsArray;
+				auto &marks = Thread->LightGridMarks;
+				marks.Begin(grid.NumLights(), sections.allSections.Size());
+				touchedSections.Clear();
+				BSPWalkCircle(actor->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+				{
+					if (marks.MarkSection(sections.SectionIndex(subsector->section))) touchedSections.Push(subsector->section);
+				});
+
+				// Only the lights that can reach the actor need to be checked against the touched sections,
+				// and each of them only once, even if it covers several of the grid cells.
+				grid.ForLightsInBox(x - actorradius, y - actorradius, x + actorradius, y + actorradius, [&](FDynamicLight *light, unsigned index)
+				{
+					if (!marks.MarkLight(index)) return;
+					for (auto section : touchedSections)
+					{
+						if (grid.IsLinkedTo(index, sections.SectionIndex(section)) && addLight(light, section->sector->PortalGroup)) break;
+					}
+				});
+			}
+			else
+			{
+				BSPWalkCircle(actor->Level, x, y, radiusSquared, [&](subsector_t *subsector) // Iterate through all subsectors potentially touched by actor
+				{
+					FLightNode * node = subsector->section->lighthead;
+					while (node) // check all lights touching a subsector
+					{
+						if (std::find(addedLights.begin(), addedLights.end(), node->lightsource) == addedLights.end()) // Check if we already added this light from a different subsector
 						{
-							if (std::find(addedLights.begin(), addedLights.end(), light) == addedLights.end()) // Check if we already added this light from a different subsector
-							{
-								addedLights.Push(light);
-							}
+							addLight(node->lightsource, subsector->sector->PortalGroup);
 						}
+						node = node->nextLight;
 					}
-					node = node->nextLight;
-				}
-			});
+				});
+			}
 
 			NumLights = addedLights.Size();
 			Lights = Thread->FrameMemory->AllocMemory<PolyLight>(NumLights);
@@ -69,7 +69,7 @@ EXTERN_CVAR(Bool, r_fullbrightignoresectorcolor);
 
 namespace swrenderer
 {
-	void RenderParticle::Project(RenderThread *thread, particle_t *particle, const sector_t *sector, int lightlevel, WaterFakeSide fakeside, bool foggy)
+	void RenderParticle::Project(RenderThread *thread, const FParticles &particles, uint32_t index, const sector_t *sector, int lightlevel, WaterFakeSide fakeside, bool foggy)
 	{
 		double 				tr_x, tr_y;
 		double 				tx, ty;
@@ -82,14 +82,15 @@ namespace swrenderer
 		if (paused || thread->Viewport->viewpoint.ViewLevel->isFrozen())
 			timefrac = 0.;
 
-		double ippx = particle->Pos.X + particle->Vel.X * timefrac;
-		double ippy = particle->Pos.Y + particle->Vel.Y * timefrac;
-		double ippz = particle->Pos.Z + particle->Vel.Z * timefrac;
+		DVector3 pos = particles.Pos(index);
+		double ippx = pos.X + particles.VelX[index] * timefrac;
+		double ippy = pos.Y + particles.VelY[index] * timefrac;
+		double ippz = pos.Z + particles.VelZ[index] * timefrac;
 
 		RenderPortal *renderportal = thread->Portal.get();
 
 		// [ZZ] Particle not visible through the portal plane
-		if (renderportal->CurrentPortal && !!P_PointOnLineSide(particle->Pos, renderportal->CurrentPortal->dst))
+		if (renderportal->CurrentPortal && !!P_PointOnLineSide(pos, renderportal->CurrentPortal->dst))
 			return;
 
 		// transform the origin point
@@ -118,7 +119,7 @@ namespace swrenderer
 		xscale = thread->Viewport->viewwindow.centerx * tiz;
 
 		// calculate edges of the shape
-		double psize = particle->size / 8.0;
+		double psize = particles.Size[index] / 8.0;
 
 		x1 = MAX<int>(renderportal->WindowLeft, thread->Viewport->viewwindow.centerx + xs_RoundToInt((tx - psize) * xscale));
 		x2 = MIN<int>(renderportal->WindowRight, thread->Viewport->viewwindow.centerx + xs_RoundToInt((tx + psize) * xscale));
@@ -194,9 +195,9 @@ namespace swrenderer
 			map = GetSpriteColorTable(sector->Colormap, sector->SpecialColors[sector_t::sprites], nc);
 		}
 
-		if (botpic != skyflatnum && ippz < botplane->ZatPoint(particle->Pos))
+		if (botpic != skyflatnum && ippz < botplane->ZatPoint(pos))
 			return;
-		if (toppic != skyflatnum && ippz >= topplane->ZatPoint(particle->Pos))
+		if (toppic != skyflatnum && ippz >= topplane->ZatPoint(pos))
 			return;
 
 		// store information in a vissprite
@@ -215,14 +216,14 @@ namespace swrenderer
 		vis->x1 = x1;
 		vis->x2 = x2;
 		vis->Translation = 0;
-		vis->startfrac = 255 & (particle->color >> 24);
+		vis->startfrac = 255 & (particles.Color[index] >> 24);
 		vis->pic = NULL;
-		vis->renderflags = (short)(particle->alpha * 255.0f + 0.5f);
+		vis->renderflags = (short)(particles.Alpha[index] * 255.0f + 0.5f);
 		vis->FakeFlatStat = fakeside;
 		vis->floorclip = 0;
 		vis->foggy = foggy;
 
-		vis->Light.SetColormap(thread, tz, lightlevel, foggy, map, particle->bright != 0, false, false, false, true);
+		vis->Light.SetColormap(thread, tz, lightlevel, foggy, map, particles.Bright[index] != 0, false, false, false, true);
 
 		thread->SpriteList->Push(vis);
 	}
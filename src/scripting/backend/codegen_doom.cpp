@@ -270,6 +270,25 @@ FxExpression* CheckForMemberDefault(FxStructMember *func, FCompileContext &ctx)
 	return func;
 }
 
+//==========================================================================
+//
+// Sight checks get cached for the rest of the tic, so they must know when
+// a script changes any of the map data they depend on.
+//
+//==========================================================================
+
+static FName CheckForSightDataWrite(PContainerType *owner, PField *field)
+{
+	auto name = field->SymbolName;
+	if (owner->TypeName == NAME_SectorPortal ||
+		(owner->TypeName == NAME_Sector && name == NAME_Portals) ||
+		(owner->TypeName == NAME_Line && (name == NAME_Flags || name == NAME_Activation || name == NAME_Special || name == NAME_Args)))
+	{
+		return NAME_BuiltinSightDataChanged;
+	}
+	return NAME_None;
+}
+
 //==========================================================================
 //
 // FxVMFunctionCall :: UnravelVarArgAJump
@@ -965,5 +984,6 @@ void SetDoomCompileEnvironment()
 	compileEnvironment.CheckSpecialMember = CheckForMemberDefault;
 	compileEnvironment.ResolveSpecialFunction = AJumpProcessing;
 	compileEnvironment.CheckCustomGlobalFunctions = ResolveGlobalCustomFunction;
+	compileEnvironment.CheckFieldWrite = CheckForSightDataWrite;
 	compileEnvironment.CustomBuiltinNew = "BuiltinNewDoom";
 }
@@ -902,6 +902,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetXOffset, SetXOffset)
  static void ClearPortal(sector_t *self, int pos)
  {
 	 self->ClearPortal(pos);
+	 P_GeometryChanged();
  }
 
  DEFINE_ACTION_FUNCTION_NATIVE(_Sector, ClearPortal, ClearPortal)
@@ -909,6 +910,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetXOffset, SetXOffset)
 	 PARAM_SELF_STRUCT_PROLOGUE(sector_t);
 	 PARAM_INT(pos);
 	 self->ClearPortal(pos);
+	 P_GeometryChanged();
 	 return 0;
  }
 
@@ -1709,6 +1711,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Secplane, isEqual, isPlaneEqual)
 static void ChangeHeight(secplane_t *self, double hdiff)
 {
 	self->ChangeHeight(hdiff);
+	P_GeometryChanged();
 }
 
 DEFINE_ACTION_FUNCTION_NATIVE(_Secplane, ChangeHeight, ChangeHeight)
@@ -1716,6 +1719,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Secplane, ChangeHeight, ChangeHeight)
 	PARAM_SELF_STRUCT_PROLOGUE(secplane_t);
 	PARAM_FLOAT(hdiff);
 	self->ChangeHeight(hdiff);
+	P_GeometryChanged();
 	return 0;
 }
 
@@ -2467,7 +2471,7 @@ DEFINE_ACTION_FUNCTION(_CVar, GetCVar)
 	PARAM_PROLOGUE;
 	PARAM_NAME(name);
 	PARAM_POINTER(plyr, player_t);
-	ACTION_RETURN_POINTER(GetCVar(plyr ? int(plyr - players) : -1, name.GetChars()));
+	ACTION_RETURN_POINTER(GetCVar(plyr ? int(plyr - players) : -1, name));
 }
 
 
@@ -43,10 +43,27 @@
 
 #include "doomdata.h"
 #include "nodebuild.h"
+#include "c_cvars.h"
+#include "workerpool.h"
+
+CVAR (Int, gl_nodebuild_threads, 0, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// 0 means one per core
 
 const int MaxSegs = 64;
 const int SplitCost = 8;
 const int AAPreference = 16;
+const uint64_t ParallelSplitterWork = 65536;	// minimum segs * splitters for scoring them on multiple threads
+
+// The scoring is split into this many parts. The calling thread
+// works on them, too, so by default there is one per pool thread plus one.
+static int GetSplitterThreads ()
+{
+	int numthreads = gl_nodebuild_threads;
+	if (numthreads <= 0)
+	{
+		numthreads = FWorkerPool::NumThreads() + 1;
+	}
+	return numthreads;
+}
 
 #if 0
 #define D(x) x
@@ -445,6 +462,7 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	uint32_t bestseg;
 	uint32_t seg;
 	bool nosplitters = false;
+	unsigned int segsInSet = 0;
 
 	bestvalue = 0;
 	bestseg = UINT_MAX;
@@ -456,6 +474,7 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 
 	D(Printf (PRINT_LOG, "Processing set %d\n", set));
 
+	Splitters.Clear();
 	while (seg != UINT_MAX)
 	{
 		FPrivSeg *pseg = &Segs[seg];
@@ -473,28 +492,56 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 				}
 
 				stepleft = step;
-				SetNodeFromSeg (node, pseg);
-
-				int value = Heuristic (node, set, nosplit);
-
-				D(Printf (PRINT_LOG, "Seg %5d, ld %d (%5d,%5d)-(%5d,%5d) scores %d\n", seg, Segs[seg].linedef, node.x>>16, node.y>>16,
-					(node.x+node.dx)>>16, (node.y+node.dy)>>16, value));
-
-				if (value > bestvalue)
-				{
-					bestvalue = value;
-					bestseg = seg;
-				}
-				else if (value < 0)
-				{
-					nosplitters = true;
-				}
+				Splitters.Push (seg);
 			}
 		}
 
+		segsInSet++;
 		seg = pseg->next;
 	}
 
+	// Scoring a splitter only reads the segs and vertices, so for large sets
+	// the candidates can be scored concurrently. The best one is still picked
+	// in order below, so the result is the same as when doing it serially.
+	SplitterScores.Resize (Splitters.Size());
+	int numthreads = GetSplitterThreads();
+	if (numthreads > 1 && (uint64_t)Splitters.Size() * segsInSet >= ParallelSplitterWork)
+	{
+		unsigned int chunk = (Splitters.Size() + numthreads - 1) / numthreads;
+		std::vector<FWorkerJobPtr> jobs;
+		for (unsigned int first = 0; first < Splitters.Size(); first += chunk)
+		{
+			unsigned int last = MIN(first + chunk, Splitters.Size());
+			jobs.push_back(FWorkerPool::Push([=]()
+			{
+				TArray<int> touched, colinear;
+				ScoreSplitters (set, nosplit, first, last, touched, colinear);
+			}));
+		}
+		FWorkerPool::WaitAll (jobs);
+	}
+	else
+	{
+		ScoreSplitters (set, nosplit, 0, Splitters.Size(), Touched, Colinear);
+	}
+
+	for (unsigned int i = 0; i < Splitters.Size(); ++i)
+	{
+		int value = SplitterScores[i];
+
+		D(Printf (PRINT_LOG, "Seg %5d, ld %d scores %d\n", Splitters[i], Segs[Splitters[i]].linedef, value));
+
+		if (value > bestvalue)
+		{
+			bestvalue = value;
+			bestseg = Splitters[i];
+		}
+		else if (value < 0)
+		{
+			nosplitters = true;
+		}
+	}
+
 	if (bestseg == UINT_MAX)
 	{ // No lines split any others into two sets, so this is a convex region.
 	D(Printf (PRINT_LOG, "set %d, step %d, nosplit %d has no good splitter (%d)\n", set, step, nosplit, nosplitters));
@@ -508,13 +555,27 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	return 1;
 }
 
+// Scores the candidate splitters in the given range. This may run on
+// several threads at once, so each one needs its own scratch arrays.
+
+void FNodeBuilder::ScoreSplitters (uint32_t set, bool nosplit, unsigned int first, unsigned int last, TArray<int> &touched, TArray<int> &colinear)
+{
+	node_t node;
+
+	for (unsigned int i = first; i < last; ++i)
+	{
+		SetNodeFromSeg (node, &Segs[Splitters[i]]);
+		SplitterScores[i] = Heuristic (node, set, nosplit, touched, colinear);
+	}
+}
+
 // Given a splitter (node), returns a score based on how "good" the resulting
 // split in a set of segs is. Higher scores are better. -1 means this splitter
 // splits something it shouldn't and will only be returned if honorNoSplit is
 // true. A score of 0 means that the splitter does not split any of the segs
 // in the set.
 
-int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
+int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit, TArray<int> &touched, TArray<int> &colinear)
 {
 	// Set the initial score above 0 so that near vertex anti-weighting is less likely to produce a negative score.
 	int score = 1000000;
@@ -529,8 +590,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	unsigned int max, m2, p, q;
 	double frac;
 
-	Touched.Clear ();
-	Colinear.Clear ();
+	touched.Clear ();
+	colinear.Clear ();
 
 	while (i != UINT_MAX)
 	{
@@ -556,32 +617,32 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 			{
 				if ((sidev[0] | sidev[1]) != 0)
 				{
-					max = Touched.Size();
+					max = touched.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Touched[p] == test->loopnum)
+						if (touched[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Touched.Push (test->loopnum);
+						touched.Push (test->loopnum);
 					}
 				}
 				else
 				{
-					max = Colinear.Size();
+					max = colinear.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Colinear[p] == test->loopnum)
+						if (colinear[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Colinear.Push (test->loopnum);
+						colinear.Push (test->loopnum);
 					}
 				}
 			}
@@ -698,8 +759,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	// seg of that sector must be crossing the container's corner and does not
 	// actually split the container.
 
-	max = Touched.Size ();
-	m2 = Colinear.Size ();
+	max = touched.Size ();
+	m2 = colinear.Size ();
 
 	// If honorNoSplit is false, then both these lists will be empty.
 
@@ -712,10 +773,10 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 
 	for (p = 0; p < max; ++p)
 	{
-		int look = Touched[p];
+		int look = touched[p];
 		for (q = 0; q < m2; ++q)
 		{
-			if (look == Colinear[q])
+			if (look == colinear[q])
 			{
 				break;
 			}